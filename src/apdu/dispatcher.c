@@ -29,6 +29,15 @@
 #include "../handler/get_app_name.h"
 #include "../handler/get_public_key.h"
 #include "../handler/sign_tx.h"
+#include "../handler/sign_batch.h"
+#include "../handler/set_policy.h"
+#include "../handler/get_last_signature.h"
+#include "../handler/parse_tx.h"
+#include "../handler/get_public_keys.h"
+#include "../handler/get_cache_stats.h"
+#include "../handler/get_account_xpub.h"
+#include "../handler/discover_addresses.h"
+#include "../handler/get_multisig_address.h"
 
 int apdu_dispatcher(const command_t *cmd) {
     if (cmd->cla != CLA) {
@@ -51,7 +60,7 @@ int apdu_dispatcher(const command_t *cmd) {
 
             return handler_get_app_name();
         case GET_PUBLIC_KEY:
-            if (cmd->p1 > 0 || cmd->p2 > 1) {
+            if (cmd->p1 > P1_PUBKEY_ADDRESS || cmd->p2 > 1) {
                 return io_send_sw(SW_WRONG_P1P2);
             }
 
@@ -63,11 +72,13 @@ int apdu_dispatcher(const command_t *cmd) {
             buf.size = cmd->lc;
             buf.offset = 0;
 
-            return handler_get_public_key(&buf, (bool) cmd->p2);
+            return handler_get_public_key(&buf, cmd->p1, (bool) cmd->p2);
         case SIGN_TX:
-            if ((cmd->p1 == P1_START && cmd->p2 != P2_MORE) ||  // first apdu must be the BIP44 path
-                cmd->p1 > P1_MAX ||                             //
-                (cmd->p2 != P2_LAST && cmd->p2 != P2_MORE)) {
+            if ((cmd->p1 == P1_START && (cmd->p2 & P2_MORE) == 0) ||                 // first apdu must be the BIP44 path
+                (cmd->p1 > P1_MAX && cmd->p1 != P1_START_WITH_TX) ||                 //
+                (cmd->p2 & ~(P2_MORE | P2_SIGN_TX_OPTIONS)) != 0 ||                  //
+                // script, signer and response options can only be requested when the signing starts
+                ((cmd->p2 & P2_SIGN_TX_OPTIONS) && cmd->p1 != P1_START && cmd->p1 != P1_START_WITH_TX)) {
                 return io_send_sw(SW_WRONG_P1P2);
             }
 
@@ -79,7 +90,124 @@ int apdu_dispatcher(const command_t *cmd) {
             buf.size = cmd->lc;
             buf.offset = 0;
 
-            return handler_sign_tx(&buf, cmd->p1, (bool) (cmd->p2 & P2_MORE));
+            return handler_sign_tx(&buf, cmd->p1, (bool) (cmd->p2 & P2_MORE), cmd->p2 & P2_SIGN_TX_OPTIONS);
+        case SIGN_BATCH:
+            if (cmd->p1 > P1_BATCH_GET_SIGNATURE || (cmd->p2 != P2_LAST && cmd->p2 != P2_MORE)) {
+                return io_send_sw(SW_WRONG_P1P2);
+            }
+
+            // the review APDU has no data
+            buf.ptr = cmd->data;
+            buf.size = cmd->lc;
+            buf.offset = 0;
+
+            return handler_sign_batch(&buf, cmd->p1, (bool) (cmd->p2 & P2_MORE));
+        case SET_POLICY:
+            if (cmd->p1 > P1_POLICY_CLEAR || cmd->p2 != 0) {
+                return io_send_sw(SW_WRONG_P1P2);
+            }
+
+            // clearing the policy has no data
+            buf.ptr = cmd->data;
+            buf.size = cmd->lc;
+            buf.offset = 0;
+
+            return handler_set_policy(&buf, cmd->p1);
+        case GET_LAST_SIGNATURE:
+            if (cmd->p1 != 0 || cmd->p2 != 0) {
+                return io_send_sw(SW_WRONG_P1P2);
+            }
+
+            if (!cmd->data) {
+                return io_send_sw(SW_WRONG_DATA_LENGTH);
+            }
+
+            buf.ptr = cmd->data;
+            buf.size = cmd->lc;
+            buf.offset = 0;
+
+            return handler_get_last_signature(&buf);
+        case PARSE_TX:
+            if (cmd->p1 > P1_PARSE_NEXT || (cmd->p2 != P2_LAST && cmd->p2 != P2_MORE)) {
+                return io_send_sw(SW_WRONG_P1P2);
+            }
+
+            if (!cmd->data) {
+                return io_send_sw(SW_WRONG_DATA_LENGTH);
+            }
+
+            buf.ptr = cmd->data;
+            buf.size = cmd->lc;
+            buf.offset = 0;
+
+            return handler_parse_tx(&buf, cmd->p1 == P1_PARSE_START, (bool) (cmd->p2 & P2_MORE));
+        case GET_PUBLIC_KEYS:
+            if (cmd->p1 > PUBKEYS_FORMAT_SCRIPT_HASH || cmd->p2 != 0) {
+                return io_send_sw(SW_WRONG_P1P2);
+            }
+
+            if (!cmd->data) {
+                return io_send_sw(SW_WRONG_DATA_LENGTH);
+            }
+
+            buf.ptr = cmd->data;
+            buf.size = cmd->lc;
+            buf.offset = 0;
+
+            return handler_get_public_keys(&buf, cmd->p1);
+        case GET_CACHE_STATS:
+            if (cmd->p1 > P1_CACHE_STATS_RESET || cmd->p2 != 0) {
+                return io_send_sw(SW_WRONG_P1P2);
+            }
+
+            return handler_get_cache_stats(cmd->p1 == P1_CACHE_STATS_RESET);
+        case GET_ACCOUNT_XPUB:
+            if (cmd->p1 != 0 || cmd->p2 != 0) {
+                return io_send_sw(SW_WRONG_P1P2);
+            }
+
+            if (!cmd->data) {
+                return io_send_sw(SW_WRONG_DATA_LENGTH);
+            }
+
+            buf.ptr = cmd->data;
+            buf.size = cmd->lc;
+            buf.offset = 0;
+
+            return handler_get_account_xpub(&buf);
+        case DISCOVER_ADDRESSES:
+            if (cmd->p1 != 0 || cmd->p2 != 0) {
+                return io_send_sw(SW_WRONG_P1P2);
+            }
+
+            if (!cmd->data) {
+                return io_send_sw(SW_WRONG_DATA_LENGTH);
+            }
+
+            buf.ptr = cmd->data;
+            buf.size = cmd->lc;
+            buf.offset = 0;
+
+            return handler_discover_addresses(&buf);
+        case GET_MULTISIG_ADDRESS:
+            if (cmd->p1 > P1_MULTISIG_KEYS || (cmd->p2 & ~(P2_MORE | P2_MULTISIG_DISPLAY)) != 0 ||
+                // the display flag is part of the first APDU
+                ((cmd->p2 & P2_MULTISIG_DISPLAY) && cmd->p1 != P1_MULTISIG_START)) {
+                return io_send_sw(SW_WRONG_P1P2);
+            }
+
+            if (!cmd->data) {
+                return io_send_sw(SW_WRONG_DATA_LENGTH);
+            }
+
+            buf.ptr = cmd->data;
+            buf.size = cmd->lc;
+            buf.offset = 0;
+
+            return handler_get_multisig_address(&buf,
+                                                cmd->p1 == P1_MULTISIG_START,
+                                                (bool) (cmd->p2 & P2_MORE),
+                                                (bool) (cmd->p2 & P2_MULTISIG_DISPLAY));
         default:
             return io_send_sw(SW_INS_NOT_SUPPORTED);
     }
@@ -10,19 +10,95 @@
  * Parameter 2 for more APDU to receive.
  */
 #define P2_MORE 0x80
+/**
+ * Parameter 2 flag of the first SIGN_TX APDU to opt in to scripts of any size.
+ * The script is hashed as it streams in and its length and SHA-256 are reviewed instead of a transfer.
+ */
+#define P2_LARGE_SCRIPT 0x01
+/**
+ * Parameter 2 flag of the first SIGN_TX APDU to receive the signature as r || s (64) followed by the transaction
+ * hash (32) instead of the ASN.1 DER signature.
+ */
+#define P2_RAW_SIGNATURE 0x02
+/**
+ * Parameter 2 flag of the first SIGN_TX APDU with a count (1) and up to MAX_SIGNER_PATHS BIP44 paths instead of one.
+ * Every path must be the account of a different signer of the transaction, all of them sign after a single review.
+ */
+#define P2_MULTI_SIGNER 0x04
+/**
+ * All option flags of the first SIGN_TX APDU.
+ */
+#define P2_SIGN_TX_OPTIONS (P2_LARGE_SCRIPT | P2_RAW_SIGNATURE | P2_MULTI_SIGNER)
 /**
  * Parameter 1 for first APDU number.
  */
 #define P1_START 0x00
+/**
+ * Parameter 1 for the APDU with the network magic.
+ */
+#define P1_MAGIC 0x01
 
 /**
  * Parameter 1 for maximum APDU number.
  * First apdu must always be the BIP44 path (P1 chunk 0)
  * Second apdu must always be the network magic, (P1 chunk 1)
- * The maximum APDU length is 255 bytes. Subtracting the 5 bytes header leaves 250 bytes per APDU of actual data.
- * With MAX_TRANSACTION_LEN set to 1024 we should at most need 5 APDU's to transmit the transaction part (P1 chunk 2..6)
+ * The transaction part is parsed as it streams in (P1 chunk 2..P1_MAX). Transactions needing more chunks than
+ * that wrap the chunk number around from P1_MAX back to 2. Values above P1_MAX are reserved.
+ */
+#define P1_MAX 0x7F
+/**
+ * Parameter 1 for a first APDU carrying the BIP44 path, the network magic and the start of the transaction.
+ * Small transactions can be signed in a single exchange this way, P2 tells whether more chunks follow (P1 chunk 2..).
+ */
+#define P1_START_WITH_TX 0x80
+
+/**
+ * Parameter 1 of SIGN_BATCH with the BIP44 path and network magic.
+ */
+#define P1_BATCH_START 0x00
+/**
+ * Parameter 1 of SIGN_BATCH with transaction data, P2 tells whether the transaction continues in the next APDU.
+ */
+#define P1_BATCH_TX 0x01
+/**
+ * Parameter 1 of SIGN_BATCH to review the summary of all transactions received.
+ */
+#define P1_BATCH_REVIEW 0x02
+/**
+ * Parameter 1 of SIGN_BATCH to get the signature of an approved transaction by index.
+ */
+#define P1_BATCH_GET_SIGNATURE 0x03
+
+/**
+ * Parameter 1 of SET_POLICY to set a new spending policy.
+ */
+#define P1_POLICY_SET 0x00
+/**
+ * Parameter 1 of SET_POLICY to remove the current spending policy.
+ */
+#define P1_POLICY_CLEAR 0x01
+
+/**
+ * Parameter 1 of PARSE_TX for the first chunk of a transaction.
+ */
+#define P1_PARSE_START 0x00
+/**
+ * Parameter 1 of PARSE_TX for the next chunks of a transaction.
+ */
+#define P1_PARSE_NEXT 0x01
+
+/**
+ * Parameter 1 of GET_MULTISIG_ADDRESS with m, n, the optional BIP44 path of the device key and the first public keys.
+ */
+#define P1_MULTISIG_START 0x00
+/**
+ * Parameter 1 of GET_MULTISIG_ADDRESS with more public keys.
+ */
+#define P1_MULTISIG_KEYS 0x01
+/**
+ * Parameter 2 flag of the first GET_MULTISIG_ADDRESS APDU to display the address and ask for confirmation.
  */
-#define P1_MAX 0x06
+#define P2_MULTISIG_DISPLAY 0x01
 
 /**
  * Dispatch APDU command received to the right handler.
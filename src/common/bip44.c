@@ -2,8 +2,8 @@
 #include "../sw.h"         // status words
 #include "../constants.h"  // BIP44 constants
 
-bool buffer_read_and_validate_bip44(buffer_t *in, uint32_t *bip44path_out, uint16_t *status_out) {
-    if (in->size < BIP44_BYTE_LENGTH) {
+bool buffer_read_and_validate_bip44_account(buffer_t *in, uint32_t *bip44path_out, uint16_t *status_out) {
+    if (!buffer_can_read(in, BIP44_ACCOUNT_BYTE_LENGTH)) {
         *status_out = SW_WRONG_DATA_LENGTH;
         return false;
     }
@@ -40,8 +40,27 @@ bool buffer_read_and_validate_bip44(buffer_t *in, uint32_t *bip44path_out, uint1
     }
     bip44path_out[2] = bip_level;
 
+    return true;
+}
+
+bool buffer_read_and_validate_bip44(buffer_t *in, uint32_t *bip44path_out, uint16_t *status_out) {
+    if (!buffer_can_read(in, BIP44_BYTE_LENGTH)) {
+        *status_out = SW_WRONG_DATA_LENGTH;
+        return false;
+    }
+
+    if (!buffer_read_and_validate_bip44_account(in, bip44path_out, status_out)) {
+        return false;
+    }
+
+    // temp var
+    uint32_t bip_level;
+
     // make sure Change is either external or internal
-    buffer_read_u32(in, &bip_level, BE);
+    if (!buffer_read_u32(in, &bip_level, BE)) {
+        *status_out = SW_WRONG_DATA_LENGTH;
+        return false;
+    }
     if (bip_level != 0x0 && bip_level != 0x1) {
         *status_out = SW_BIP44_BAD_CHANGE;
         return false;
@@ -49,8 +68,11 @@ bool buffer_read_and_validate_bip44(buffer_t *in, uint32_t *bip44path_out, uint1
     bip44path_out[3] = bip_level;
 
     // check address is within a sane range
-    buffer_read_u32(in, &bip_level, BE);
-    if (bip_level >= 5000) {
+    if (!buffer_read_u32(in, &bip_level, BE)) {
+        *status_out = SW_WRONG_DATA_LENGTH;
+        return false;
+    }
+    if (bip_level >= BIP44_MAX_ADDRESS_INDEX) {
         *status_out = SW_BIP44_BAD_ADDRESS;
         return false;
     }
@@ -17,7 +17,7 @@
 #include <stdint.h>   // uint*_t
 #include <stddef.h>   // size_t
 #include <stdbool.h>  // bool
-#include <string.h>   // memmove
+#include <string.h>   // memmove, memcpy
 
 #include "buffer.h"
 #include "read.h"
@@ -201,3 +201,117 @@ bool buffer_move(buffer_t *buffer, uint8_t *out, size_t out_len) {
 
     return true;
 }
+
+const uint8_t *buffer_view(buffer_t *buffer, size_t len) {
+    if (!buffer_can_read(buffer, len)) {
+        return NULL;
+    }
+
+    const uint8_t *view = buffer->ptr + buffer->offset;
+    buffer->offset += len;
+
+    return view;
+}
+
+const uint8_t *buffer_view_at_most(buffer_t *buffer, size_t max_len, size_t *len) {
+    size_t available = buffer->size - buffer->offset;
+
+    *len = (available < max_len) ? available : max_len;
+
+    const uint8_t *view = buffer->ptr + buffer->offset;
+    buffer->offset += *len;
+
+    return view;
+}
+
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ != __ORDER_LITTLE_ENDIAN__
+#error "reader_t fixed-width loads assume a little endian target"
+#endif
+
+/**
+ * Take 'len' bytes for a fixed-width read, set the sticky failure flag if out of bounds.
+ * The fixed-width values are then loaded with memcpy() which the compiler turns into
+ * a single unaligned load where the core supports it and into byte loads otherwise.
+ */
+static const uint8_t *reader_take(reader_t *reader, size_t len) {
+    if (reader->failed) {
+        return NULL;
+    }
+
+    const uint8_t *view = buffer_view(&reader->buffer, len);
+    if (view == NULL) {
+        reader->failed = true;
+    }
+
+    return view;
+}
+
+void reader_init(reader_t *reader, const buffer_t *buffer) {
+    reader->buffer = *buffer;
+    reader->failed = false;
+}
+
+bool reader_ok(const reader_t *reader) {
+    return !reader->failed;
+}
+
+size_t reader_remaining(const reader_t *reader) {
+    return reader->failed ? 0 : reader->buffer.size - reader->buffer.offset;
+}
+
+uint8_t reader_u8(reader_t *reader) {
+    const uint8_t *view = reader_take(reader, 1);
+
+    return (view == NULL) ? 0 : view[0];
+}
+
+uint16_t reader_u16(reader_t *reader, endianness_t endianness) {
+    const uint8_t *view = reader_take(reader, 2);
+    uint16_t value = 0;
+
+    if (view != NULL) {
+        memcpy(&value, view, sizeof(value));
+    }
+
+    return (endianness == BE) ? __builtin_bswap16(value) : value;
+}
+
+uint32_t reader_u32(reader_t *reader, endianness_t endianness) {
+    const uint8_t *view = reader_take(reader, 4);
+    uint32_t value = 0;
+
+    if (view != NULL) {
+        memcpy(&value, view, sizeof(value));
+    }
+
+    return (endianness == BE) ? __builtin_bswap32(value) : value;
+}
+
+uint64_t reader_u64(reader_t *reader, endianness_t endianness) {
+    const uint8_t *view = reader_take(reader, 8);
+    uint64_t value = 0;
+
+    if (view != NULL) {
+        memcpy(&value, view, sizeof(value));
+    }
+
+    return (endianness == BE) ? __builtin_bswap64(value) : value;
+}
+
+uint64_t reader_varint(reader_t *reader) {
+    uint64_t value = 0;
+
+    if (!reader->failed && !buffer_read_varint(&reader->buffer, &value)) {
+        reader->failed = true;
+    }
+
+    return value;
+}
+
+const uint8_t *reader_view(reader_t *reader, size_t len) {
+    return reader_take(reader, len);
+}
+
+void reader_skip(reader_t *reader, size_t len) {
+    reader_take(reader, len);
+}
@@ -211,3 +211,159 @@ bool buffer_copy(const buffer_t *buffer, uint8_t *out, size_t out_len);
  *
  */
 bool buffer_move(buffer_t *buffer, uint8_t *out, size_t out_len);
+
+/**
+ * Take a view of the next bytes of the buffer without copying them.
+ *
+ * @param[in,out]  buffer
+ *   Pointer to input buffer struct.
+ * @param[in]      len
+ *   Number of bytes to take.
+ *
+ * @return pointer to the 'len' bytes in the buffer if success, NULL otherwise.
+ *
+ */
+const uint8_t *buffer_view(buffer_t *buffer, size_t len);
+
+/**
+ * Take a view of at most 'max_len' of the next bytes of the buffer without copying them.
+ *
+ * @param[in,out]  buffer
+ *   Pointer to input buffer struct.
+ * @param[in]      max_len
+ *   Maximum number of bytes to take.
+ * @param[out]     len
+ *   Number of bytes taken, 0 if the buffer is at its end.
+ *
+ * @return pointer to the bytes taken in the buffer.
+ *
+ */
+const uint8_t *buffer_view_at_most(buffer_t *buffer, size_t max_len, size_t *len);
+
+/**
+ * Struct for reader over a buffer with a sticky failure flag.
+ * Once a read goes out of bounds every following read fails too and returns 0 (or NULL for views),
+ * so a parser can read a whole section and check reader_ok() once.
+ */
+typedef struct {
+    buffer_t buffer;  /// Buffer being read
+    bool failed;      /// Set by the first read out of bounds
+} reader_t;
+
+/**
+ * Initialize a reader at the current offset of a buffer.
+ *
+ * @param[out] reader
+ *   Pointer to reader struct.
+ * @param[in]  buffer
+ *   Pointer to input buffer struct, it is not modified by the reader.
+ *
+ */
+void reader_init(reader_t *reader, const buffer_t *buffer);
+
+/**
+ * Tell whether all reads so far were in bounds.
+ *
+ * @param[in] reader
+ *   Pointer to reader struct.
+ *
+ * @return true if no read failed, false otherwise.
+ *
+ */
+bool reader_ok(const reader_t *reader);
+
+/**
+ * Number of bytes left to read.
+ *
+ * @param[in] reader
+ *   Pointer to reader struct.
+ *
+ * @return number of bytes left, 0 if a read failed.
+ *
+ */
+size_t reader_remaining(const reader_t *reader);
+
+/**
+ * Read 1 byte.
+ *
+ * @param[in,out] reader
+ *   Pointer to reader struct.
+ *
+ * @return byte read, 0 if the read failed.
+ *
+ */
+uint8_t reader_u8(reader_t *reader);
+
+/**
+ * Read 2 bytes into uint16_t.
+ *
+ * @param[in,out] reader
+ *   Pointer to reader struct.
+ * @param[in]     endianness
+ *   Either BE (Big Endian) or LE (Little Endian).
+ *
+ * @return value read, 0 if the read failed.
+ *
+ */
+uint16_t reader_u16(reader_t *reader, endianness_t endianness);
+
+/**
+ * Read 4 bytes into uint32_t.
+ *
+ * @param[in,out] reader
+ *   Pointer to reader struct.
+ * @param[in]     endianness
+ *   Either BE (Big Endian) or LE (Little Endian).
+ *
+ * @return value read, 0 if the read failed.
+ *
+ */
+uint32_t reader_u32(reader_t *reader, endianness_t endianness);
+
+/**
+ * Read 8 bytes into uint64_t.
+ *
+ * @param[in,out] reader
+ *   Pointer to reader struct.
+ * @param[in]     endianness
+ *   Either BE (Big Endian) or LE (Little Endian).
+ *
+ * @return value read, 0 if the read failed.
+ *
+ */
+uint64_t reader_u64(reader_t *reader, endianness_t endianness);
+
+/**
+ * Read Bitcoin-like varint into uint64_t.
+ *
+ * @param[in,out] reader
+ *   Pointer to reader struct.
+ *
+ * @return value read, 0 if the read failed.
+ *
+ */
+uint64_t reader_varint(reader_t *reader);
+
+/**
+ * Take a view of the next bytes without copying them.
+ *
+ * @param[in,out] reader
+ *   Pointer to reader struct.
+ * @param[in]     len
+ *   Number of bytes to take.
+ *
+ * @return pointer to the 'len' bytes, NULL if the read failed.
+ *
+ */
+const uint8_t *reader_view(reader_t *reader, size_t len);
+
+/**
+ * Skip the next bytes.
+ *
+ * @param[in,out] reader
+ *   Pointer to reader struct.
+ * @param[in]     len
+ *   Number of bytes to skip.
+ *
+ */
+void reader_skip(reader_t *reader, size_t len);
@@ -0,0 +1,67 @@
+/*****************************************************************************
+ *   (c) 2021 COZ Inc.
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *****************************************************************************/
+
+#include <stdint.h>   // uint*_t
+#include <stddef.h>   // size_t
+#include <stdbool.h>  // bool
+#include <string.h>   // memset, memcpy
+
+#include "der.h"
+
+/**
+ * Read the DER integer at 'offset' into a 32 byte big endian 'out' and advance 'offset'.
+ */
+static bool der_read_integer(const uint8_t *der, size_t der_len, size_t *offset, uint8_t out[static 32]) {
+    if (*offset + 2 > der_len || der[*offset] != 0x02) {
+        return false;
+    }
+
+    size_t len = der[*offset + 1];
+    *offset += 2;
+    if (len == 0 || *offset + len > der_len) {
+        return false;
+    }
+
+    const uint8_t *value = der + *offset;
+    *offset += len;
+
+    // drop the leading zero that keeps a value with the high bit set positive
+    while (len > 32 && value[0] == 0x00) {
+        value++;
+        len--;
+    }
+    if (len > 32) {
+        return false;
+    }
+
+    memset(out, 0, 32 - len);
+    memcpy(out + 32 - len, value, len);
+    return true;
+}
+
+bool der_signature_to_rs(const uint8_t *der, size_t der_len, uint8_t out[static RS_SIGNATURE_LEN]) {
+    if (der_len < 2 || der[0] != 0x30 || (size_t) der[1] + 2 != der_len) {
+        return false;
+    }
+
+    size_t offset = 2;
+    if (!der_read_integer(der, der_len, &offset, out) || !der_read_integer(der, der_len, &offset, out + 32)) {
+        return false;
+    }
+
+    // nothing is allowed after s
+    return offset == der_len;
+}
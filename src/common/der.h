@@ -0,0 +1,26 @@
+#pragma once
+
+#include <stdint.h>   // uint*_t
+#include <stddef.h>   // size_t
+#include <stdbool.h>  // bool
+
+/**
+ * Length of a secp256r1 signature as r || s.
+ */
+#define RS_SIGNATURE_LEN 64
+
+/**
+ * Convert an ASN.1 DER encoded ECDSA signature to the fixed size r || s format.
+ * Each integer is left padded with zeros to 32 bytes, the sign byte added by DER is dropped.
+ *
+ * @param[in]  der
+ *   Pointer to DER encoded signature: 0x30 len 0x02 r_len r 0x02 s_len s.
+ * @param[in]  der_len
+ *   Length of the DER encoded signature.
+ * @param[out] out
+ *   Pointer to output buffer of RS_SIGNATURE_LEN bytes.
+ *
+ * @return true if success, false if the signature is malformed.
+ *
+ */
+bool der_signature_to_rs(const uint8_t *der, size_t der_len, uint8_t out[static RS_SIGNATURE_LEN]);
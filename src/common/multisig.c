@@ -0,0 +1,84 @@
+/*****************************************************************************
+ *   (c) 2021 COZ Inc.
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *****************************************************************************/
+#include <stdint.h>   // uint*_t
+#include <stddef.h>   // size_t
+#include <stdbool.h>  // bool
+#include <string.h>   // memcmp, memcpy
+
+#include "multisig.h"
+
+/** OpCode.PUSH0, the small integers 1 to 16 are pushed with PUSH0 + value */
+#define OPCODE_PUSH0 0x10
+/** OpCode.PUSHDATA1 */
+#define OPCODE_PUSHDATA1 0x0C
+/** OpCode.SYSCALL */
+#define OPCODE_SYSCALL 0x41
+
+bool multisig_sort_keys(uint8_t keys[][33], uint8_t n) {
+    uint8_t key[33];
+
+    // insertion sort, n is small
+    for (uint8_t i = 0; i < n; i++) {
+        if (keys[i][0] != 0x02 && keys[i][0] != 0x03) {
+            return false;
+        }
+
+        memcpy(key, keys[i], sizeof(key));
+        uint8_t j = i;
+        while (j > 0) {
+            int cmp = memcmp(keys[j - 1] + 1, key + 1, 32);
+            if (cmp == 0) {
+                return false;
+            }
+            if (cmp < 0) {
+                break;
+            }
+            memcpy(keys[j], keys[j - 1], sizeof(key));
+            j--;
+        }
+        memcpy(keys[j], key, sizeof(key));
+    }
+
+    return true;
+}
+
+size_t multisig_create_script(uint8_t m, const uint8_t keys[][33], uint8_t n, uint8_t *out, size_t out_len) {
+    if (m == 0 || m > n || n > MULTISIG_MAX_KEYS) {
+        return 0;
+    }
+
+    size_t len = 1 + (size_t) n * (2 + 33) + 1 + 5;
+    if (out_len < len) {
+        return 0;
+    }
+
+    size_t offset = 0;
+    out[offset++] = OPCODE_PUSH0 + m;
+    for (uint8_t i = 0; i < n; i++) {
+        out[offset++] = OPCODE_PUSHDATA1;
+        out[offset++] = 33;  // data size, 33 bytes for compressed public key
+        memcpy(out + offset, keys[i], 33);
+        offset += 33;
+    }
+    out[offset++] = OPCODE_PUSH0 + n;
+
+    out[offset++] = OPCODE_SYSCALL;
+    uint32_t checkmultisig = 0x3ADCD09E;  // Syscall "System.Crypto.CheckMultisig"
+    memcpy(out + offset, &checkmultisig, 4);
+    offset += 4;
+
+    return offset;
+}
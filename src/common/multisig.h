@@ -0,0 +1,50 @@
+#pragma once
+
+#include <stdint.h>   // uint*_t
+#include <stddef.h>   // size_t
+#include <stdbool.h>  // bool
+
+/**
+ * Maximum number of public keys in a multi signature account.
+ */
+#define MULTISIG_MAX_KEYS 16
+
+/**
+ * Maximum length of a multi signature verification script:
+ * PUSH m (1) + n * (PUSHDATA1 (1) + size (1) + public key (33)) + PUSH n (1) + SYSCALL (1) + syscall id (4)
+ */
+#define MULTISIG_SCRIPT_MAX_LEN (1 + MULTISIG_MAX_KEYS * (2 + 33) + 1 + 5)
+
+/**
+ * Sort compressed public keys in the order of a NEO multi signature verification script,
+ * which is ascending by X coordinate.
+ *
+ * @param[in,out] keys
+ *   Compressed public keys (33 bytes each).
+ * @param[in]     n
+ *   Number of public keys.
+ *
+ * @return true if success, false if a key is not compressed or two keys share the X coordinate.
+ *
+ */
+bool multisig_sort_keys(uint8_t keys[][33], uint8_t n);
+
+/**
+ * Create the verification script of an m-of-n multi signature account, like
+ * Contract.CreateMultiSigRedeemScript of NEO. The keys must be sorted with multisig_sort_keys().
+ *
+ * @param[in]  m
+ *   Number of signatures required.
+ * @param[in]  keys
+ *   Sorted compressed public keys (33 bytes each).
+ * @param[in]  n
+ *   Number of public keys.
+ * @param[out] out
+ *   Pointer to output buffer.
+ * @param[in]  out_len
+ *   Length of output buffer.
+ *
+ * @return length of the script if success, 0 if m or n is out of range or the output buffer is too small.
+ *
+ */
+size_t multisig_create_script(uint8_t m, const uint8_t keys[][33], uint8_t n, uint8_t *out, size_t out_len);
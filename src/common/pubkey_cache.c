@@ -0,0 +1,70 @@
+/*****************************************************************************
+ *   (c) 2021 COZ Inc.
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *****************************************************************************/
+
+#include <stdint.h>  // uint*_t
+#include <stddef.h>  // NULL
+#include <string.h>  // memcmp, memcpy, memset
+
+#include "pubkey_cache.h"
+
+const pubkey_cache_entry_t *pubkey_cache_peek(const pubkey_cache_t *cache,
+                                              const uint32_t bip44_path[static BIP44_PATH_LEN]) {
+    for (uint8_t i = 0; i < PUBKEY_CACHE_SIZE; i++) {
+        const pubkey_cache_entry_t *entry = &cache->entries[i];
+
+        if (entry->last_used != 0 && memcmp(entry->bip44_path, bip44_path, sizeof(entry->bip44_path)) == 0) {
+            return entry;
+        }
+    }
+
+    return NULL;
+}
+
+const pubkey_cache_entry_t *pubkey_cache_find(pubkey_cache_t *cache, const uint32_t bip44_path[static BIP44_PATH_LEN]) {
+    pubkey_cache_entry_t *entry = (pubkey_cache_entry_t *) pubkey_cache_peek(cache, bip44_path);
+
+    if (entry == NULL) {
+        cache->misses++;
+        return NULL;
+    }
+
+    entry->last_used = ++cache->uses;
+    cache->hits++;
+    return entry;
+}
+
+void pubkey_cache_add(pubkey_cache_t *cache,
+                      const uint32_t bip44_path[static BIP44_PATH_LEN],
+                      const uint8_t public_key[static 64],
+                      const uint8_t script_hash[static 20]) {
+    // an unused entry has the lowest use counter, so it is taken before any used one
+    pubkey_cache_entry_t *entry = &cache->entries[0];
+    for (uint8_t i = 1; i < PUBKEY_CACHE_SIZE; i++) {
+        if (cache->entries[i].last_used < entry->last_used) {
+            entry = &cache->entries[i];
+        }
+    }
+
+    memcpy(entry->bip44_path, bip44_path, sizeof(entry->bip44_path));
+    memcpy(entry->public_key, public_key, sizeof(entry->public_key));
+    memcpy(entry->script_hash, script_hash, sizeof(entry->script_hash));
+    entry->last_used = ++cache->uses;
+}
+
+void pubkey_cache_clear(pubkey_cache_t *cache) {
+    memset(cache->entries, 0, sizeof(cache->entries));
+    cache->uses = 0;
+}
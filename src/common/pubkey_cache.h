@@ -0,0 +1,86 @@
+#pragma once
+
+#include <stdint.h>  // uint*_t
+
+#include "../constants.h"
+
+/**
+ * Number of public keys remembered for GET_PUBLIC_KEY.
+ */
+#define PUBKEY_CACHE_SIZE 4
+
+/**
+ * Public key derived for a BIP44 path.
+ */
+typedef struct {
+    uint32_t bip44_path[BIP44_PATH_LEN];  // path the key was derived for
+    uint8_t public_key[64];               // x-coordinate (32), y-coordinate (32)
+    uint8_t script_hash[20];              // script hash of the single signature verification script
+    uint32_t last_used;                   // value of the use counter on the last lookup, 0 for an unused entry
+} pubkey_cache_entry_t;
+
+/**
+ * Public keys of the paths queried most recently, so repeated queries need no curve operation.
+ * Only lives in RAM, the least recently used entry is replaced first.
+ */
+typedef struct {
+    pubkey_cache_entry_t entries[PUBKEY_CACHE_SIZE];
+    uint32_t uses;    // incremented on every lookup and insertion, orders the entries by recency
+    uint32_t hits;    // lookups that found the path
+    uint32_t misses;  // lookups that did not find the path
+} pubkey_cache_t;
+
+/**
+ * Look up the public key of a BIP44 path and count the hit or miss.
+ *
+ * @param[in, out] cache
+ *   Pointer to the public key cache.
+ * @param[in]      bip44_path
+ *   BIP44 path of the key.
+ *
+ * @return pointer to the cache entry, NULL if the path is not cached.
+ *
+ */
+const pubkey_cache_entry_t *pubkey_cache_find(pubkey_cache_t *cache, const uint32_t bip44_path[static BIP44_PATH_LEN]);
+
+/**
+ * Look up the public key of a BIP44 path without counting it or refreshing its recency, for range scans
+ * that would otherwise skew the counters and push out the keys that are queried repeatedly.
+ *
+ * @param[in] cache
+ *   Pointer to the public key cache.
+ * @param[in] bip44_path
+ *   BIP44 path of the key.
+ *
+ * @return pointer to the cache entry, NULL if the path is not cached.
+ *
+ */
+const pubkey_cache_entry_t *pubkey_cache_peek(const pubkey_cache_t *cache,
+                                              const uint32_t bip44_path[static BIP44_PATH_LEN]);
+
+/**
+ * Remember the public key of a BIP44 path, replacing the least recently used entry when the cache is full.
+ *
+ * @param[in, out] cache
+ *   Pointer to the public key cache.
+ * @param[in]      bip44_path
+ *   BIP44 path of the key.
+ * @param[in]      public_key
+ *   Raw public key, x-coordinate (32) and y-coordinate (32).
+ * @param[in]      script_hash
+ *   Script hash of the single signature verification script of the key.
+ *
+ */
+void pubkey_cache_add(pubkey_cache_t *cache,
+                      const uint32_t bip44_path[static BIP44_PATH_LEN],
+                      const uint8_t public_key[static 64],
+                      const uint8_t script_hash[static 20]);
+
+/**
+ * Forget all the public keys, the hit and miss counters are kept.
+ *
+ * @param[out] cache
+ *   Pointer to the public key cache.
+ *
+ */
+void pubkey_cache_clear(pubkey_cache_t *cache);
@@ -0,0 +1,114 @@
+/*****************************************************************************
+ *   (c) 2021 COZ Inc.
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *****************************************************************************/
+
+#include <stdint.h>  // uint*_t
+#include <stddef.h>  // NULL, offsetof
+#include <string.h>  // memcmp, memcpy, memset
+
+#include "os.h"
+#include "cx.h"
+
+#include "pubkey_store.h"
+
+/**
+ * Compute the checksum of all the fields of 'entry' that precede it.
+ */
+static void entry_checksum(const pubkey_store_entry_t *entry, uint8_t out[static PUBKEY_STORE_CHECKSUM_LEN]) {
+    cx_sha256_t hash;
+    uint8_t digest[32];
+
+    cx_sha256_init(&hash);
+    cx_hash((cx_hash_t *) &hash,
+            CX_LAST,
+            (const uint8_t *) entry,
+            offsetof(pubkey_store_entry_t, checksum),
+            digest,
+            sizeof(digest));
+    memcpy(out, digest, PUBKEY_STORE_CHECKSUM_LEN);
+}
+
+static bool entry_is_valid(const pubkey_store_entry_t *entry) {
+    uint8_t checksum[PUBKEY_STORE_CHECKSUM_LEN];
+
+    if (entry->sequence == 0) {
+        return false;
+    }
+
+    entry_checksum(entry, checksum);
+    return memcmp(checksum, entry->checksum, PUBKEY_STORE_CHECKSUM_LEN) == 0;
+}
+
+const pubkey_store_entry_t *pubkey_store_find(const pubkey_store_t *store,
+                                              const uint32_t bip44_path[static BIP44_PATH_LEN],
+                                              const uint8_t seed_fingerprint[static PUBKEY_STORE_FINGERPRINT_LEN]) {
+    for (uint8_t i = 0; i < PUBKEY_STORE_SIZE; i++) {
+        const pubkey_store_entry_t *entry = &store->entries[i];
+
+        if (memcmp(entry->bip44_path, bip44_path, sizeof(entry->bip44_path)) == 0 &&
+            memcmp(entry->seed_fingerprint, seed_fingerprint, PUBKEY_STORE_FINGERPRINT_LEN) == 0 &&
+            entry_is_valid(entry)) {
+            return entry;
+        }
+    }
+
+    return NULL;
+}
+
+void pubkey_store_add(const pubkey_store_t *store,
+                      const uint32_t bip44_path[static BIP44_PATH_LEN],
+                      const uint8_t public_key[static 64],
+                      const uint8_t script_hash[static 20],
+                      const uint8_t seed_fingerprint[static PUBKEY_STORE_FINGERPRINT_LEN]) {
+    // a corrupted entry counts as empty, so it is the first to be overwritten, entries of another seed
+    // take their turn like the others
+    uint8_t slot = 0;
+    uint32_t slot_sequence = UINT32_MAX;
+    uint32_t max_sequence = 0;
+    for (uint8_t i = 0; i < PUBKEY_STORE_SIZE; i++) {
+        uint32_t sequence = entry_is_valid(&store->entries[i]) ? store->entries[i].sequence : 0;
+
+        if (sequence < slot_sequence) {
+            slot = i;
+            slot_sequence = sequence;
+        }
+        if (sequence > max_sequence) {
+            max_sequence = sequence;
+        }
+    }
+
+    pubkey_store_entry_t entry;
+    memset(&entry, 0, sizeof(entry));
+    entry.sequence = max_sequence + 1;
+    memcpy(entry.bip44_path, bip44_path, sizeof(entry.bip44_path));
+    memcpy(entry.public_key, public_key, sizeof(entry.public_key));
+    memcpy(entry.script_hash, script_hash, sizeof(entry.script_hash));
+    memcpy(entry.seed_fingerprint, seed_fingerprint, sizeof(entry.seed_fingerprint));
+    entry_checksum(&entry, entry.checksum);
+
+    nvm_write((void *) &store->entries[slot], &entry, sizeof(entry));
+}
+
+void pubkey_store_clear(const pubkey_store_t *store) {
+    pubkey_store_entry_t empty;
+    memset(&empty, 0, sizeof(empty));
+
+    // only write the slots that are in use, an erase costs a flash write per entry
+    for (uint8_t i = 0; i < PUBKEY_STORE_SIZE; i++) {
+        if (store->entries[i].sequence != 0) {
+            nvm_write((void *) &store->entries[i], &empty, sizeof(empty));
+        }
+    }
+}
@@ -0,0 +1,89 @@
+#pragma once
+
+#include <stdint.h>   // uint*_t
+#include <stdbool.h>  // bool
+
+#include "../constants.h"
+
+/**
+ * Number of public keys kept in flash.
+ */
+#define PUBKEY_STORE_SIZE 16
+
+/**
+ * Length of the checksum protecting a stored entry.
+ */
+#define PUBKEY_STORE_CHECKSUM_LEN 4
+
+/**
+ * Length of the fingerprint of the seed an entry was derived from.
+ */
+#define PUBKEY_STORE_FINGERPRINT_LEN 8
+
+/**
+ * Public key of a BIP44 path kept in flash. Only public data is stored. The seed fingerprint tells the
+ * seeds apart, a passphrase PIN unlocks another seed with the same flash.
+ */
+typedef struct {
+    uint32_t sequence;                                       // 0 for an empty slot, the latest write is the highest
+    uint32_t bip44_path[BIP44_PATH_LEN];                     // path the key was derived for
+    uint8_t public_key[64];                                  // x-coordinate (32), y-coordinate (32)
+    uint8_t script_hash[20];                                 // script hash of the single signature verification script
+    uint8_t seed_fingerprint[PUBKEY_STORE_FINGERPRINT_LEN];  // fingerprint of the seed the key was derived from
+    uint8_t checksum[PUBKEY_STORE_CHECKSUM_LEN];             // first bytes of the SHA-256 of the fields above
+} pubkey_store_entry_t;
+
+/**
+ * Public keys kept across app restarts, part of N_storage. Entries that fail their checksum are ignored.
+ * Slots are written round robin (lowest sequence first) and only when a key is missing, to spread the wear.
+ */
+typedef struct {
+    pubkey_store_entry_t entries[PUBKEY_STORE_SIZE];
+} pubkey_store_t;
+
+/**
+ * Look up the public key of a BIP44 path derived from the seed with 'seed_fingerprint'.
+ *
+ * @param[in] store
+ *   Pointer to the public key store in flash.
+ * @param[in] bip44_path
+ *   BIP44 path of the key.
+ * @param[in] seed_fingerprint
+ *   Fingerprint of the current seed.
+ *
+ * @return pointer to the stored entry, NULL if the path is not stored for this seed or its entry is corrupted.
+ *
+ */
+const pubkey_store_entry_t *pubkey_store_find(const pubkey_store_t *store,
+                                              const uint32_t bip44_path[static BIP44_PATH_LEN],
+                                              const uint8_t seed_fingerprint[static PUBKEY_STORE_FINGERPRINT_LEN]);
+
+/**
+ * Write the public key of a BIP44 path to the slot written the longest time ago.
+ *
+ * @param[in] store
+ *   Pointer to the public key store in flash.
+ * @param[in] bip44_path
+ *   BIP44 path of the key.
+ * @param[in] public_key
+ *   Raw public key, x-coordinate (32) and y-coordinate (32).
+ * @param[in] script_hash
+ *   Script hash of the single signature verification script of the key.
+ * @param[in] seed_fingerprint
+ *   Fingerprint of the seed the key was derived from.
+ *
+ */
+void pubkey_store_add(const pubkey_store_t *store,
+                      const uint32_t bip44_path[static BIP44_PATH_LEN],
+                      const uint8_t public_key[static 64],
+                      const uint8_t script_hash[static 20],
+                      const uint8_t seed_fingerprint[static PUBKEY_STORE_FINGERPRINT_LEN]);
+
+/**
+ * Erase all entries of the store.
+ *
+ * @param[in] store
+ *   Pointer to the public key store in flash.
+ *
+ */
+void pubkey_store_clear(const pubkey_store_t *store);
@@ -21,15 +21,28 @@
 #define MAX_APPNAME_LEN 64
 
 /**
- * Maximum transaction length (bytes).
+ * Maximum transaction length (bytes), matches the NEO network limit.
+ * Transactions are parsed while streaming in, so this does not cost any RAM.
  */
-#define MAX_TRANSACTION_LEN 1024
+#define MAX_TRANSACTION_LEN 102400
+
+/**
+ * Maximum number of transactions in a SIGN_BATCH session.
+ * Only the hash of each transaction is kept, so every transaction costs TX_HASH_LEN bytes of SRAM.
+ */
+#define MAX_BATCH_TX 16
 
 /**
  * Maximum signature length (bytes).
  */
 #define MAX_DER_SIG_LEN 72
 
+/**
+ * Maximum number of BIP44 paths signing the same transaction in one SIGN_TX.
+ * All signatures are sent in a single response, which limits it to three DER signatures.
+ */
+#define MAX_SIGNER_PATHS 3
+
 /**
  * Exponent used to convert mBOL to BOL unit (N BOL = N * 10^3 mBOL).
  */
@@ -44,6 +57,15 @@
 /** Length of BIP44 path, in bytes */
 #define BIP44_BYTE_LENGTH (BIP44_PATH_LEN * sizeof(unsigned int))
 
+/**
+ * Length of the hardened account part of a BIP44 path
+ * m / purpose' / coin_type' / account'
+ * */
+#define BIP44_ACCOUNT_PATH_LEN 3
+
+/** Length of the account part of a BIP44 path, in bytes */
+#define BIP44_ACCOUNT_BYTE_LENGTH (BIP44_ACCOUNT_PATH_LEN * sizeof(unsigned int))
+
 /**
  * Coin type 888 as described in
  * https://github.com/satoshilabs/slips/blob/master/slip-0044.md
@@ -53,6 +75,9 @@
 /** BIP44 purpose 44' */
 #define BIP44_PURPOSE 0x8000002C
 
+/** Upper bound (exclusive) of the BIP44 address index */
+#define BIP44_MAX_ADDRESS_INDEX 5000
+
 /** NEO Main network magic */
 #define NETWORK_MAINNET 860833102
 
@@ -24,9 +24,99 @@
 #include "globals.h"
 #include "../sw.h"
 
+/**
+ * Order of the secp256r1 curve.
+ */
+static const uint8_t SECP256R1_ORDER[32] = {0xFF, 0xFF, 0xFF, 0xFF, 0x00, 0x00, 0x00, 0x00, 0xFF, 0xFF, 0xFF,
+                                            0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xBC, 0xE6, 0xFA, 0xAD, 0xA7, 0x17,
+                                            0x9E, 0x84, 0xF3, 0xB9, 0xCA, 0xC2, 0xFC, 0x63, 0x25, 0x51};
+
+/**
+ * Derive the node of the account and change of 'bip44_path' into G_account_node, unless it is already there.
+ */
+static void account_node_load(const uint32_t *bip44_path) {
+    if (G_account_node.valid && memcmp(G_account_node.path, bip44_path, sizeof(G_account_node.path)) == 0) {
+        return;
+    }
+
+    explicit_bzero(&G_account_node, sizeof(G_account_node));
+
+    cx_ecfp_private_key_t private_key = {0};
+    cx_ecfp_public_key_t public_key = {0};
+
+    BEGIN_TRY {
+        TRY {
+            os_perso_derive_node_bip32(CX_CURVE_256R1,
+                                       bip44_path,
+                                       BIP44_PATH_LEN - 1,
+                                       G_account_node.private_key,
+                                       G_account_node.chain_code);
+            cx_ecfp_init_private_key(CX_CURVE_256R1,
+                                     G_account_node.private_key,
+                                     sizeof(G_account_node.private_key),
+                                     &private_key);
+            cx_ecfp_generate_pair(CX_CURVE_256R1, &public_key, &private_key, 1);
+        }
+        CATCH_OTHER(e) {
+            explicit_bzero(&G_account_node, sizeof(G_account_node));
+            THROW(e);
+        }
+        FINALLY {
+            explicit_bzero(&private_key, sizeof(private_key));
+        }
+    }
+    END_TRY;
+
+    // W is 0x04 || X || Y
+    G_account_node.compressed_public_key[0] = (public_key.W[64] & 1) ? 0x03 : 0x02;
+    memmove(G_account_node.compressed_public_key + 1, public_key.W + 1, 32);
+    memmove(G_account_node.path, bip44_path, sizeof(G_account_node.path));
+    G_account_node.valid = true;
+}
+
+/**
+ * Derive the non hardened child 'index' of G_account_node (BIP32 CKDpriv).
+ *
+ * @return true if success, false if the child key is invalid and the full derivation must be used.
+ */
+static bool account_node_derive_child(uint32_t index, uint8_t raw_private_key[static 32]) {
+    uint8_t data[33 + 4];
+    uint8_t digest[64];
+    bool ok = false;
+
+    memmove(data, G_account_node.compressed_public_key, 33);
+    data[33] = (uint8_t) (index >> 24);
+    data[34] = (uint8_t) (index >> 16);
+    data[35] = (uint8_t) (index >> 8);
+    data[36] = (uint8_t) index;
+
+    cx_hmac_sha512(G_account_node.chain_code, sizeof(G_account_node.chain_code), data, sizeof(data), digest, 64);
+
+    // the left half is the tweak added to the parent key, it must be a valid scalar
+    if (cx_math_cmp(digest, SECP256R1_ORDER, 32) < 0) {
+        cx_math_addm(raw_private_key, digest, G_account_node.private_key, SECP256R1_ORDER, 32);
+        ok = !cx_math_is_zero(raw_private_key, 32);
+    }
+
+    explicit_bzero(digest, sizeof(digest));
+    return ok;
+}
+
 int crypto_derive_private_key(cx_ecfp_private_key_t *private_key, const uint32_t *bip32_path, uint8_t bip32_path_len) {
     uint8_t raw_private_key[32] = {0};
 
+    // the node of a locked device must not be used, derivation from the seed fails in that case anyway
+    if (os_global_pin_is_validated() != BOLOS_TRUE) {
+        crypto_clear_seed_cache();
+    } else if (bip32_path_len == BIP44_PATH_LEN && bip32_path[BIP44_PATH_LEN - 1] < 0x80000000) {
+        account_node_load(bip32_path);
+        if (account_node_derive_child(bip32_path[BIP44_PATH_LEN - 1], raw_private_key)) {
+            cx_ecfp_init_private_key(CX_CURVE_256R1, raw_private_key, sizeof(raw_private_key), private_key);
+            explicit_bzero(&raw_private_key, sizeof(raw_private_key));
+            return 0;
+        }
+    }
+
     BEGIN_TRY {
         TRY {
             // derive the seed with bip32_path
@@ -45,6 +135,62 @@ int crypto_derive_private_key(cx_ecfp_private_key_t *private_key, const uint32_t
     return 0;
 }
 
+int crypto_seed_fingerprint(uint8_t fingerprint[static PUBKEY_STORE_FINGERPRINT_LEN]) {
+    if (!G_seed_fingerprint.valid) {
+        const uint32_t path[] = {BIP44_PURPOSE, BIP44_COIN_TYPE_NEO};
+        cx_ecfp_private_key_t private_key = {0};
+        cx_ecfp_public_key_t public_key = {0};
+        uint8_t raw_public_key[64];
+        uint8_t digest[32];
+        cx_sha256_t hash;
+
+        crypto_derive_private_key(&private_key, path, sizeof(path) / sizeof(path[0]));
+        crypto_init_public_key(&private_key, &public_key, raw_public_key);
+        explicit_bzero(&private_key, sizeof(private_key));
+
+        cx_sha256_init(&hash);
+        cx_hash((cx_hash_t *) &hash, CX_LAST, raw_public_key, sizeof(raw_public_key), digest, sizeof(digest));
+        memmove(G_seed_fingerprint.value, digest, sizeof(G_seed_fingerprint.value));
+        G_seed_fingerprint.valid = true;
+    }
+
+    memmove(fingerprint, G_seed_fingerprint.value, PUBKEY_STORE_FINGERPRINT_LEN);
+
+    return 0;
+}
+
+int crypto_derive_account_xpub(const uint32_t *account_path, account_xpub_t *xpub) {
+    uint8_t raw_private_key[32] = {0};
+    cx_ecfp_private_key_t private_key = {0};
+    cx_ecfp_public_key_t public_key = {0};
+
+    BEGIN_TRY {
+        TRY {
+            os_perso_derive_node_bip32(CX_CURVE_256R1,
+                                       account_path,
+                                       BIP44_ACCOUNT_PATH_LEN,
+                                       raw_private_key,
+                                       xpub->chain_code);
+            cx_ecfp_init_private_key(CX_CURVE_256R1, raw_private_key, sizeof(raw_private_key), &private_key);
+            cx_ecfp_generate_pair(CX_CURVE_256R1, &public_key, &private_key, 1);
+        }
+        CATCH_OTHER(e) {
+            THROW(e);
+        }
+        FINALLY {
+            explicit_bzero(&raw_private_key, sizeof(raw_private_key));
+            explicit_bzero(&private_key, sizeof(private_key));
+        }
+    }
+    END_TRY;
+
+    // W is 0x04 || X || Y
+    xpub->public_key[0] = (public_key.W[64] & 1) ? 0x03 : 0x02;
+    memmove(xpub->public_key + 1, public_key.W + 1, 32);
+
+    return 0;
+}
+
 int crypto_init_public_key(cx_ecfp_private_key_t *private_key,
                            cx_ecfp_public_key_t *public_key,
                            uint8_t raw_public_key[static 64]) {
@@ -56,21 +202,18 @@ int crypto_init_public_key(cx_ecfp_private_key_t *private_key,
     return 0;
 }
 
-int crypto_sign_tx() {
-    int sig_len = 0;
-
-    // derive private key according to BIP44 path
-    cx_ecfp_private_key_t private_key = {0};
-    crypto_derive_private_key(&private_key, G_context.bip44_path, BIP44_PATH_LEN);
-
+/**
+ * Hash network magic + 'tx_hash' into 'message_hash', the data signed for a transaction.
+ */
+static void message_hash_compute(uint32_t network_magic,
+                                 const uint8_t tx_hash[static TX_HASH_LEN],
+                                 uint8_t message_hash[static 32]) {
     // The data we need to hash is the network magic (uint32_t) + sha256(signed data portion of TX)
-    // the latter is stored in tx_info.hash
-    uint8_t data[36];
-    memcpy(data, (void *) &G_context.network_magic, 4);
-    memcpy(&data[4], G_context.tx_info.hash, sizeof(G_context.tx_info.hash));
+    uint8_t data[4 + TX_HASH_LEN];
+    memcpy(data, (void *) &network_magic, 4);
+    memcpy(&data[4], tx_hash, TX_HASH_LEN);
 
     // Hash the data before signing
-    uint8_t message_hash[32] = {0};
     cx_sha256_t msg_hash;
     cx_sha256_init(&msg_hash);
     cx_hash((cx_hash_t *) &msg_hash,
@@ -78,7 +221,81 @@ int crypto_sign_tx() {
             data /* data in */,
             sizeof(data) /* data in len */,
             message_hash /* hash out*/,
-            sizeof(message_hash) /* hash out len */);
+            32 /* hash out len */);
+}
+
+int crypto_prepare_signing_key(const uint8_t tx_hash[static TX_HASH_LEN]) {
+    crypto_clear_signing_key();
+
+    cx_ecfp_private_key_t private_key = {0};
+    crypto_derive_private_key(&private_key, G_context.bip44_path, BIP44_PATH_LEN);
+    memmove(G_signing_key.private_key, private_key.d, sizeof(G_signing_key.private_key));
+    explicit_bzero(&private_key, sizeof(private_key));
+
+    message_hash_compute(G_context.network_magic, tx_hash, G_signing_key.message_hash);
+
+    memmove(G_signing_key.bip44_path, G_context.bip44_path, sizeof(G_signing_key.bip44_path));
+    G_signing_key.network_magic = G_context.network_magic;
+    memmove(G_signing_key.tx_hash, tx_hash, TX_HASH_LEN);
+    G_signing_key.valid = true;
+
+    return 0;
+}
+
+void crypto_clear_signing_key() {
+    explicit_bzero(&G_signing_key, sizeof(G_signing_key));
+}
+
+void crypto_clear_seed_cache() {
+    explicit_bzero(&G_account_node, sizeof(G_account_node));
+    explicit_bzero(&G_seed_fingerprint, sizeof(G_seed_fingerprint));
+    crypto_clear_signing_key();
+    pubkey_cache_clear(&G_pubkey_cache);
+}
+
+int crypto_sign_tx() {
+    return crypto_sign_tx_hash(G_context.tx_info.hash);
+}
+
+int crypto_sign_tx_signer_paths() {
+    signer_paths_t *signer_paths = &G_context.tx_info.signer_paths;
+
+    for (uint8_t i = 0; i < signer_paths->count; i++) {
+        memmove(G_context.bip44_path, signer_paths->paths[i], sizeof(G_context.bip44_path));
+        if (crypto_sign_tx() < 0) {
+            return -1;
+        }
+
+        memmove(signer_paths->signatures[i], G_context.tx_info.signature, G_context.tx_info.signature_len);
+        signer_paths->signature_lens[i] = G_context.tx_info.signature_len;
+    }
+    memmove(G_context.bip44_path, signer_paths->paths[0], sizeof(G_context.bip44_path));
+
+    return 0;
+}
+
+int crypto_sign_tx_hash(const uint8_t tx_hash[static TX_HASH_LEN]) {
+    int sig_len = 0;
+
+    cx_ecfp_private_key_t private_key = {0};
+    uint8_t message_hash[32] = {0};
+
+    if (G_signing_key.valid &&                                                                            //
+        memcmp(G_signing_key.bip44_path, G_context.bip44_path, sizeof(G_signing_key.bip44_path)) == 0 &&  //
+        G_signing_key.network_magic == G_context.network_magic &&                                         //
+        memcmp(G_signing_key.tx_hash, tx_hash, TX_HASH_LEN) == 0) {
+        // prepared during the review
+        cx_ecfp_init_private_key(CX_CURVE_256R1,
+                                 G_signing_key.private_key,
+                                 sizeof(G_signing_key.private_key),
+                                 &private_key);
+        memmove(message_hash, G_signing_key.message_hash, sizeof(message_hash));
+    } else {
+        // derive private key according to BIP44 path
+        crypto_derive_private_key(&private_key, G_context.bip44_path, BIP44_PATH_LEN);
+        message_hash_compute(G_context.network_magic, tx_hash, message_hash);
+    }
+    crypto_clear_signing_key();
 
     BEGIN_TRY {
         TRY {
@@ -108,5 +325,13 @@ int crypto_sign_tx() {
 
     G_context.tx_info.signature_len = sig_len;
 
+    // remember the signature in case the response gets lost on its way to the host
+    sig_cache_add(&G_sig_cache,
+                  G_context.bip44_path,
+                  G_context.network_magic,
+                  tx_hash,
+                  G_context.tx_info.signature,
+                  sig_len);
+
     return 0;
 }
@@ -5,6 +5,9 @@
 #include "os.h"
 #include "cx.h"
 
+#include "types.h"
+#include "transaction/tx_hash.h"
+
 /**
  * Derive private key given BIP32 path.
  *
@@ -41,6 +44,62 @@ int crypto_init_public_key(cx_ecfp_private_key_t *private_key,
                            cx_ecfp_public_key_t *public_key,
                            uint8_t raw_public_key[static 64]);
 
+/**
+ * Fingerprint of the seed, the first bytes of the SHA-256 of the public key of m/44'/888'. Derived once
+ * per session and kept in G_seed_fingerprint.
+ *
+ * @param[out] fingerprint
+ *   Pointer to buffer for the fingerprint.
+ *
+ * @return 0 if success, -1 otherwise.
+ *
+ * @throw INVALID_PARAMETER
+ *
+ */
+int crypto_seed_fingerprint(uint8_t fingerprint[static PUBKEY_STORE_FINGERPRINT_LEN]);
+
+/**
+ * Derive the compressed public key and chain code of a hardened account path m/44'/888'/account'.
+ *
+ * @param[in]  account_path
+ *   Pointer to buffer with BIP44_ACCOUNT_PATH_LEN path numbers.
+ * @param[out] xpub
+ *   Pointer to extended public key.
+ *
+ * @return 0 if success, -1 otherwise.
+ *
+ * @throw INVALID_PARAMETER
+ *
+ */
+int crypto_derive_account_xpub(const uint32_t *account_path, account_xpub_t *xpub);
+
+/**
+ * Derive the private key of the BIP44 path in global context and hash network magic + the given
+ * transaction hash into G_signing_key, so signing after approval only runs ECDSA.
+ *
+ * @see G_context.bip44_path, G_context.network_magic and G_signing_key
+ *
+ * @param[in] tx_hash
+ *   Hash of the signed data portion of the transaction.
+ *
+ * @return 0 if success, -1 otherwise.
+ *
+ * @throw INVALID_PARAMETER
+ *
+ */
+int crypto_prepare_signing_key(const uint8_t tx_hash[static TX_HASH_LEN]);
+
+/**
+ * Wipe the signing key prepared by crypto_prepare_signing_key().
+ */
+void crypto_clear_signing_key(void);
+
+/**
+ * Wipe everything kept in RAM that was derived from the seed: the account node, the seed fingerprint, the
+ * signing key and the public key cache. Called when the device locks, the seed may differ once it is unlocked again.
+ */
+void crypto_clear_seed_cache(void);
+
 /**
  * Sign network magic + message hash in global context.
  *
@@ -52,4 +111,33 @@ int crypto_init_public_key(cx_ecfp_private_key_t *private_key,
  * @throw INVALID_PARAMETER
  *
  */
-int crypto_sign_tx(void);
\ No newline at end of file
+int crypto_sign_tx(void);
+
+/**
+ * Sign network magic + message hash in global context with each BIP44 path of a multi signer SIGN_TX.
+ *
+ * @see G_context.tx_info.signer_paths, G_context.tx_info.hash and G_context.network_magic
+ *
+ * @return 0 if success, -1 otherwise.
+ *
+ * @throw INVALID_PARAMETER
+ *
+ */
+int crypto_sign_tx_signer_paths(void);
+
+/**
+ * Sign network magic + the given transaction hash with the key of the BIP44 path in global context.
+ * A key prepared for the same path, network magic and transaction hash is used and wiped, otherwise
+ * the key is derived here. The signature is also added to the signature cache.
+ *
+ * @see G_context.bip44_path, G_context.tx_info.signature, G_context.network_magic and G_sig_cache
+ *
+ * @param[in] tx_hash
+ *   Hash of the signed data portion of the transaction.
+ *
+ * @return 0 if success, -1 otherwise.
+ *
+ * @throw INVALID_PARAMETER
+ *
+ */
+int crypto_sign_tx_hash(const uint8_t tx_hash[static TX_HASH_LEN]);
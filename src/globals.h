@@ -7,6 +7,9 @@
 #include "io.h"
 #include "types.h"
 #include "constants.h"
+#include "transaction/policy.h"
+#include "transaction/sig_cache.h"
+#include "common/pubkey_cache.h"
 
 /**
  * Global buffer for interactions between SE and MCU.
@@ -37,3 +40,44 @@ extern io_state_e G_io_state;
  * Global context for user requests.
  */
 extern global_ctx_t G_context;
+
+/**
+ * Spending policy approved for this session.
+ */
+extern policy_t G_policy;
+
+/**
+ * Last signatures produced, for GET_LAST_SIGNATURE.
+ */
+extern sig_cache_t G_sig_cache;
+
+/**
+ * Account node of the last derived address, see crypto_derive_private_key().
+ */
+extern account_node_t G_account_node;
+
+/**
+ * Fingerprint of the seed, ties the public keys kept in flash to the seed they were derived from.
+ */
+extern seed_fingerprint_t G_seed_fingerprint;
+
+/**
+ * Signing key prepared during the review of a transaction, see crypto_prepare_signing_key().
+ */
+extern signing_key_t G_signing_key;
+
+/**
+ * Public keys of the most recently queried paths, for GET_PUBLIC_KEY.
+ */
+extern pubkey_cache_t G_pubkey_cache;
+
+/**
+ * Persistent storage in flash, always accessed through N_storage.
+ */
+extern const internal_storage_t N_storage_real;
+#define N_storage (*(volatile internal_storage_t *) PIC(&N_storage_real))
+
+/**
+ * Public keys kept in flash, see pubkey_store_find().
+ */
+#define N_pubkey_store ((const pubkey_store_t *) &N_storage.pubkey_store)
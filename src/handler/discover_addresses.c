@@ -0,0 +1,97 @@
+/*****************************************************************************
+ *   (c) 2021 COZ Inc.
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *****************************************************************************/
+#include <stdint.h>   // uint*_t
+#include <stdbool.h>  // bool
+#include <stddef.h>   // size_t
+#include <string.h>   // memcmp, explicit_bzero
+
+#include "os.h"
+#include "cx.h"
+
+#include "discover_addresses.h"
+#include "../globals.h"
+#include "../constants.h"
+#include "../io.h"
+#include "../sw.h"
+#include "../crypto.h"
+#include "../common/buffer.h"
+#include "../common/bip44.h"
+#include "../common/write.h"
+#include "../ui/utils.h"
+
+int handler_discover_addresses(buffer_t *cdata) {
+    explicit_bzero(&G_context, sizeof(G_context));
+
+    uint16_t status;
+    if (!buffer_read_and_validate_bip44(cdata, G_context.bip44_path, &status)) {
+        return io_send_sw(status);
+    }
+
+    uint16_t count;
+    uint8_t n_targets;
+    if (!buffer_read_u16(cdata, &count, BE) || !buffer_read_u8(cdata, &n_targets)) {
+        return io_send_sw(SW_WRONG_DATA_LENGTH);
+    }
+
+    if (n_targets == 0 || n_targets > MAX_DISCOVERY_TARGETS ||
+        cdata->size - cdata->offset != (size_t) n_targets * UINT160_LEN) {
+        return io_send_sw(SW_WRONG_DATA_LENGTH);
+    }
+    const uint8_t *targets = cdata->ptr + cdata->offset;
+
+    // the last address must still be within the range accepted for a single address
+    if (count == 0 || G_context.bip44_path[4] + count > BIP44_MAX_ADDRESS_INDEX) {
+        return io_send_sw(SW_BIP44_BAD_ADDRESS);
+    }
+
+    uint32_t end = G_context.bip44_path[4] + count;
+    uint16_t scan = (count < MAX_DISCOVERY_SCAN) ? count : MAX_DISCOVERY_SCAN;
+
+    uint8_t resp[4 + 1 + MAX_DISCOVERY_TARGETS * (1 + 4)] = {0};
+    size_t len = 4 + 1;
+    uint8_t n_found = 0;
+    bool found[MAX_DISCOVERY_TARGETS] = {false};
+
+    cx_ecfp_private_key_t private_key = {0};
+    cx_ecfp_public_key_t public_key = {0};
+    uint8_t script_hash[UINT160_LEN];
+
+    // all indexes share the account node, each one is a single non hardened derivation step
+    for (uint16_t i = 0; i < scan && n_found < n_targets; i++) {
+        crypto_derive_private_key(&private_key, G_context.bip44_path, BIP44_PATH_LEN);
+        crypto_init_public_key(&private_key, &public_key, G_context.raw_public_key);
+        explicit_bzero(&private_key, sizeof(private_key));
+        script_hash_from_pubkey(G_context.raw_public_key, script_hash);
+
+        for (uint8_t t = 0; t < n_targets; t++) {
+            if (!found[t] && memcmp(targets + t * UINT160_LEN, script_hash, UINT160_LEN) == 0) {
+                found[t] = true;
+                n_found++;
+                resp[len++] = t;
+                write_u32_be(resp, len, G_context.bip44_path[4]);
+                len += 4;
+            }
+        }
+
+        G_context.bip44_path[4]++;
+    }
+
+    // nothing is left to find in the rest of the window once all targets are found
+    write_u32_be(resp, 0, (n_found == n_targets) ? end : G_context.bip44_path[4]);
+    resp[4] = n_found;
+
+    return io_send_response(&(const buffer_t){.ptr = resp, .size = len, .offset = 0}, SW_OK);
+}
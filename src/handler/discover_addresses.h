@@ -0,0 +1,28 @@
+#pragma once
+
+#include <stdint.h>  // uint*_t
+
+#include "../common/buffer.h"
+
+/**
+ * Maximum number of script hashes searched for in one DISCOVER_ADDRESSES command.
+ */
+#define MAX_DISCOVERY_TARGETS 8
+/**
+ * Maximum number of address indexes scanned per APDU, a longer window is resumed by the host.
+ * Keeps the time the device does not answer well below the transport timeouts.
+ */
+#define MAX_DISCOVERY_SCAN 32
+
+/**
+ * Handler for DISCOVER_ADDRESSES command. Derive the script hashes of consecutive address indexes
+ * and report the indexes of the ones that are searched for. At most MAX_DISCOVERY_SCAN indexes are
+ * scanned, the response holds the next index so the host can resume the scan from there.
+ *
+ * @param[in,out] cdata
+ *   Command data with the BIP44 path of the first address, the number of addresses and the script hashes.
+ *
+ * @return zero or positive integer if success, negative integer otherwise.
+ *
+ */
+int handler_discover_addresses(buffer_t *cdata);
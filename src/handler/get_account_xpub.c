@@ -0,0 +1,49 @@
+/*****************************************************************************
+ *   (c) 2021 COZ Inc.
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *****************************************************************************/
+#include <stdint.h>  // uint*_t
+#include <string.h>  // explicit_bzero
+
+#include "os.h"
+#include "cx.h"
+
+#include "get_account_xpub.h"
+#include "../globals.h"
+#include "../constants.h"
+#include "../io.h"
+#include "../sw.h"
+#include "../crypto.h"
+#include "../common/buffer.h"
+#include "../common/bip44.h"
+#include "../ui/display.h"
+
+int handler_get_account_xpub(buffer_t *cdata) {
+    explicit_bzero(&G_context, sizeof(G_context));
+    G_context.req_type = CONFIRM_XPUB;
+    G_context.state = STATE_NONE;
+
+    uint16_t status;
+    if (!buffer_read_and_validate_bip44_account(cdata, G_context.bip44_path, &status)) {
+        return io_send_sw(status);
+    }
+
+    if (cdata->offset != cdata->size) {
+        return io_send_sw(SW_WRONG_DATA_LENGTH);
+    }
+
+    crypto_derive_account_xpub(G_context.bip44_path, &G_context.xpub);
+
+    return ui_display_account_xpub();
+}
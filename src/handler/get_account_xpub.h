@@ -0,0 +1,18 @@
+#pragma once
+
+#include "../common/buffer.h"
+
+/**
+ * Handler for GET_ACCOUNT_XPUB command. If the account path m/44'/888'/account' is parsed successfully
+ * derive its public key and chain code and ask the user to approve the export.
+ * With them the host derives every change and address key of the account without the device.
+ *
+ * @see G_context.xpub.
+ *
+ * @param[in,out] cdata
+ *   Command data with the account path.
+ *
+ * @return zero or positive integer if success, negative integer otherwise.
+ *
+ */
+int handler_get_account_xpub(buffer_t *cdata);
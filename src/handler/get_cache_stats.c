@@ -0,0 +1,52 @@
+/*****************************************************************************
+ *   (c) 2021 COZ Inc.
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *****************************************************************************/
+
+#include <stdint.h>   // uint*_t
+#include <stdbool.h>  // bool
+#include <stddef.h>   // size_t
+
+#include "get_cache_stats.h"
+#include "../sw.h"
+#include "../io.h"
+#include "../globals.h"
+#include "../common/buffer.h"
+#include "../common/write.h"
+
+int handler_get_cache_stats(bool reset) {
+    uint8_t resp[4 + 4 + 1 + 1] = {0};
+    size_t len = 0;
+
+    write_u32_be(resp, len, G_pubkey_cache.hits);
+    len += 4;
+    write_u32_be(resp, len, G_pubkey_cache.misses);
+    len += 4;
+
+    resp[len++] = PUBKEY_CACHE_SIZE;
+    uint8_t used = 0;
+    for (uint8_t i = 0; i < PUBKEY_CACHE_SIZE; i++) {
+        if (G_pubkey_cache.entries[i].last_used != 0) {
+            used++;
+        }
+    }
+    resp[len++] = used;
+
+    if (reset) {
+        G_pubkey_cache.hits = 0;
+        G_pubkey_cache.misses = 0;
+    }
+
+    return io_send_response(&(const buffer_t){.ptr = resp, .size = len, .offset = 0}, SW_OK);
+}
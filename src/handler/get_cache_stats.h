@@ -0,0 +1,26 @@
+#pragma once
+
+#include <stdint.h>   // uint*_t
+#include <stdbool.h>  // bool
+
+/**
+ * GET_CACHE_STATS P1 to read the counters.
+ */
+#define P1_CACHE_STATS_READ 0x00
+/**
+ * GET_CACHE_STATS P1 to read the counters and reset them afterwards.
+ */
+#define P1_CACHE_STATS_RESET 0x01
+
+/**
+ * Handler for GET_CACHE_STATS command. Send the hit and miss counters of the public key cache.
+ *
+ * @see G_pubkey_cache.
+ *
+ * @param[in] reset
+ *   Whether to reset the counters after sending them.
+ *
+ * @return zero or positive integer if success, negative integer otherwise.
+ *
+ */
+int handler_get_cache_stats(bool reset);
@@ -0,0 +1,51 @@
+/*****************************************************************************
+ *   Ledger App Boilerplate.
+ *   (c) 2020 Ledger SAS.
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *****************************************************************************/
+
+#include <stdint.h>  // uint*_t
+
+#include "get_last_signature.h"
+#include "../sw.h"
+#include "../io.h"
+#include "../globals.h"
+#include "../common/buffer.h"
+#include "../common/bip44.h"
+#include "../transaction/sig_cache.h"
+
+int handler_get_last_signature(buffer_t *cdata) {
+    uint32_t network_magic;
+    const uint8_t *tx_hash;
+    uint32_t bip44_path[BIP44_PATH_LEN];
+    uint16_t status;
+
+    if (cdata->size != 4 + TX_HASH_LEN + BIP44_BYTE_LENGTH || !buffer_read_u32(cdata, &network_magic, LE)) {
+        return io_send_sw(SW_WRONG_DATA_LENGTH);
+    }
+    tx_hash = cdata->ptr + cdata->offset;
+    buffer_seek_cur(cdata, TX_HASH_LEN);
+    if (!buffer_read_and_validate_bip44(cdata, bip44_path, &status)) {
+        return io_send_sw(status);
+    }
+
+    const sig_cache_entry_t *entry = sig_cache_find(&G_sig_cache, bip44_path, network_magic, tx_hash);
+    if (entry == NULL) {
+        return io_send_sw(SW_SIGNATURE_NOT_FOUND);
+    }
+
+    // the user already approved this signature, sending it again needs no review
+    return io_send_response(&(const buffer_t){.ptr = entry->signature, .size = entry->signature_len, .offset = 0},
+                            SW_OK);
+}
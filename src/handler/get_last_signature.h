@@ -0,0 +1,18 @@
+#pragma once
+
+#include "../common/buffer.h"
+
+/**
+ * Handler for GET_LAST_SIGNATURE command. Send again the signature of a recently signed transaction,
+ * so a response lost in transport does not need a new review.
+ *
+ * @see G_sig_cache.
+ *
+ * @param[in,out] cdata
+ *   Command data with network magic, hash of the signed data portion of the transaction and BIP44 path
+ *   of the signing key.
+ *
+ * @return zero or positive integer if success, negative integer otherwise.
+ *
+ */
+int handler_get_last_signature(buffer_t *cdata);
@@ -0,0 +1,133 @@
+/*****************************************************************************
+ *   (c) 2021 COZ Inc.
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *****************************************************************************/
+#include <stdint.h>   // uint*_t
+#include <stdbool.h>  // bool
+#include <stddef.h>   // size_t
+#include <string.h>   // memmove, explicit_bzero
+
+#include "os.h"
+#include "cx.h"
+
+#include "get_multisig_address.h"
+#include "../globals.h"
+#include "../constants.h"
+#include "../io.h"
+#include "../sw.h"
+#include "../crypto.h"
+#include "../common/buffer.h"
+#include "../common/bip44.h"
+#include "../common/multisig.h"
+#include "../ui/display.h"
+#include "../ui/utils.h"
+#include "../helper/send_response.h"
+
+/**
+ * Abort the multi signature account being received, later APDUs for it are answered with SW_BAD_STATE.
+ */
+static int multisig_abort(uint16_t sw) {
+    explicit_bzero(&G_context, sizeof(G_context));
+    return io_send_sw(sw);
+}
+
+/**
+ * Start a new multi signature account from the first APDU: m, n, whether the key of the device is included
+ * and if so its BIP44 path.
+ *
+ * @return true if success, false with 'status_out' set otherwise.
+ */
+static bool start_multisig(buffer_t *cdata, uint16_t *status_out) {
+    multisig_ctx_t *ctx = &G_context.multisig;
+
+    uint8_t own_key;
+    if (!buffer_read_u8(cdata, &ctx->m) || !buffer_read_u8(cdata, &ctx->n) || !buffer_read_u8(cdata, &own_key) ||
+        own_key > 1) {
+        *status_out = SW_WRONG_DATA_LENGTH;
+        return false;
+    }
+
+    if (ctx->m == 0 || ctx->m > ctx->n || ctx->n > MULTISIG_MAX_KEYS) {
+        *status_out = SW_INVALID_MULTISIG;
+        return false;
+    }
+
+    if (own_key) {
+        if (!buffer_read_and_validate_bip44(cdata, G_context.bip44_path, status_out)) {
+            return false;
+        }
+
+        cx_ecfp_private_key_t private_key = {0};
+        cx_ecfp_public_key_t public_key = {0};
+        uint8_t raw_public_key[64];
+
+        crypto_derive_private_key(&private_key, G_context.bip44_path, BIP44_PATH_LEN);
+        crypto_init_public_key(&private_key, &public_key, raw_public_key);
+        explicit_bzero(&private_key, sizeof(private_key));
+
+        compress_public_key(raw_public_key, ctx->keys[ctx->received++]);
+    }
+
+    return true;
+}
+
+int handler_get_multisig_address(buffer_t *cdata, bool first, bool more, bool display) {
+    multisig_ctx_t *ctx = &G_context.multisig;
+
+    if (first) {
+        explicit_bzero(&G_context, sizeof(G_context));
+        G_context.req_type = CONFIRM_MULTISIG;
+        G_context.state = STATE_NONE;
+        ctx->display = display;
+
+        uint16_t status;
+        if (!start_multisig(cdata, &status)) {
+            return multisig_abort(status);
+        }
+    } else if (G_context.req_type != CONFIRM_MULTISIG || G_context.state != STATE_NONE) {
+        return io_send_sw(SW_BAD_STATE);
+    }
+
+    size_t remaining = cdata->size - cdata->offset;
+    if (remaining % 33 != 0) {
+        return multisig_abort(SW_WRONG_DATA_LENGTH);
+    }
+
+    if (ctx->received + remaining / 33 > ctx->n) {
+        return multisig_abort(SW_INVALID_MULTISIG);
+    }
+    memmove(ctx->keys[ctx->received], cdata->ptr + cdata->offset, remaining);
+    ctx->received += remaining / 33;
+
+    if (more) {
+        return io_send_sw(SW_OK);
+    }
+
+    // all public keys are known now
+    if (ctx->received != ctx->n || !multisig_sort_keys(ctx->keys, ctx->n)) {
+        return multisig_abort(SW_INVALID_MULTISIG);
+    }
+
+    uint8_t script[MULTISIG_SCRIPT_MAX_LEN];
+    size_t script_len =
+        multisig_create_script(ctx->m, (const uint8_t(*)[33]) ctx->keys, ctx->n, script, sizeof(script));
+    public_key_hash160(script, script_len, ctx->script_hash);
+    G_context.state = STATE_PARSED;
+
+    if (ctx->display) {
+        return ui_display_multisig_address();
+    }
+
+    return helper_send_response_multisig();
+}
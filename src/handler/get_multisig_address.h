@@ -0,0 +1,28 @@
+#pragma once
+
+#include <stdint.h>   // uint*_t
+#include <stdbool.h>  // bool
+
+#include "../common/buffer.h"
+
+/**
+ * Handler for GET_MULTISIG_ADDRESS command. Collect the public keys of an m-of-n multi signature account,
+ * optionally including the key of the device, over one or more APDUs. Once all keys are received they are
+ * sorted, the verification script is built and its script hash and address are sent, after confirmation
+ * on screen if requested.
+ *
+ * @see G_context.multisig.
+ *
+ * @param[in,out] cdata
+ *   Command data with m, n and the BIP44 path of the device key for the first APDU, followed by public keys.
+ * @param[in]     first
+ *   Whether this is the first APDU of the command.
+ * @param[in]     more
+ *   Whether more APDUs with public keys follow.
+ * @param[in]     display
+ *   Whether to display the address on screen, only used with the first APDU.
+ *
+ * @return zero or positive integer if success, negative integer otherwise.
+ *
+ */
+int handler_get_multisig_address(buffer_t *cdata, bool first, bool more, bool display);
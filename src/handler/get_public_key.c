@@ -33,24 +33,54 @@
 #include "../common/buffer.h"
 #include "../common/bip44.h"
 #include "../ui/display.h"
+#include "../ui/utils.h"
 #include "../helper/send_response.h"
 
-int handler_get_public_key(buffer_t *cdata, bool show_on_screen) {
+int handler_get_public_key(buffer_t *cdata, uint8_t format, bool show_on_screen) {
     explicit_bzero(&G_context, sizeof(G_context));
     G_context.state = CONFIRM_ADDRESS;
+    G_context.pubkey_format = format;
 
     uint16_t status;
     if (!buffer_read_and_validate_bip44(cdata, G_context.bip44_path, &status)) return io_send_sw(status);
 
-    cx_ecfp_private_key_t private_key = {0};
-    cx_ecfp_public_key_t public_key = {0};
+    const pubkey_cache_entry_t *entry = pubkey_cache_find(&G_pubkey_cache, G_context.bip44_path);
+    const pubkey_store_entry_t *stored = NULL;
+    uint8_t seed_fingerprint[PUBKEY_STORE_FINGERPRINT_LEN] = {0};
+    if (entry == NULL && N_storage.pubkey_store_enabled) {
+        // stored keys of another seed (passphrase PIN) must not be returned
+        crypto_seed_fingerprint(seed_fingerprint);
+        stored = pubkey_store_find(N_pubkey_store, G_context.bip44_path, seed_fingerprint);
+    }
+
+    if (entry != NULL) {
+        memmove(G_context.raw_public_key, entry->public_key, sizeof(G_context.raw_public_key));
+    } else if (stored != NULL) {
+        // kept in flash by a previous session
+        memmove(G_context.raw_public_key, stored->public_key, sizeof(G_context.raw_public_key));
+        pubkey_cache_add(&G_pubkey_cache, G_context.bip44_path, stored->public_key, stored->script_hash);
+    } else {
+        cx_ecfp_private_key_t private_key = {0};
+        cx_ecfp_public_key_t public_key = {0};
 
-    // Derive private key according to BIP44 path
-    crypto_derive_private_key(&private_key, G_context.bip44_path, BIP44_PATH_LEN);
-    // Generate corresponding public key
-    crypto_init_public_key(&private_key, &public_key, G_context.raw_public_key);
-    // Clear private key
-    explicit_bzero(&private_key, sizeof(private_key));
+        // Derive private key according to BIP44 path
+        crypto_derive_private_key(&private_key, G_context.bip44_path, BIP44_PATH_LEN);
+        // Generate corresponding public key
+        crypto_init_public_key(&private_key, &public_key, G_context.raw_public_key);
+        // Clear private key
+        explicit_bzero(&private_key, sizeof(private_key));
+
+        uint8_t script_hash[UINT160_LEN];
+        script_hash_from_pubkey(G_context.raw_public_key, script_hash);
+        pubkey_cache_add(&G_pubkey_cache, G_context.bip44_path, G_context.raw_public_key, script_hash);
+        if (N_storage.pubkey_store_enabled) {
+            pubkey_store_add(N_pubkey_store,
+                             G_context.bip44_path,
+                             G_context.raw_public_key,
+                             script_hash,
+                             seed_fingerprint);
+        }
+    }
 
     if (show_on_screen) {
         return ui_display_address();
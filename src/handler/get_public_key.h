@@ -7,6 +7,23 @@
 #include "../types.h"
 #include "../common/buffer.h"
 
+/**
+ * GET_PUBLIC_KEY P1 for the uncompressed public key: 0x04 || X (32) || Y (32).
+ */
+#define P1_PUBKEY_UNCOMPRESSED 0x00
+/**
+ * GET_PUBLIC_KEY P1 for the compressed public key: 0x02 or 0x03 || X (32).
+ */
+#define P1_PUBKEY_COMPRESSED 0x01
+/**
+ * GET_PUBLIC_KEY P1 for the script hash (20) of the single signature verification script.
+ */
+#define P1_PUBKEY_SCRIPT_HASH 0x02
+/**
+ * GET_PUBLIC_KEY P1 for the base58 encoded address (34 characters).
+ */
+#define P1_PUBKEY_ADDRESS 0x03
+
 /**
  * Handler for GET_PUBLIC_KEY command. If the BIP44 path is parsed successfully
  * derive the public key and send APDU response.
@@ -15,10 +32,12 @@
  *
  * @param[in,out] cdata
  *   Command data with BIP44 path.
+ * @param[in]     format
+ *   Response format, one of P1_PUBKEY_*.
  * @param[in]     show_on_screen
  *   Whether to display address on screen or not.
  *
  * @return zero or positive integer if success, negative integer otherwise.
  *
  */
-int handler_get_public_key(buffer_t *cdata, bool show_on_screen);
+int handler_get_public_key(buffer_t *cdata, uint8_t format, bool show_on_screen);
@@ -0,0 +1,89 @@
+/*****************************************************************************
+ *   (c) 2021 COZ Inc.
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *****************************************************************************/
+
+#include <stdint.h>   // uint*_t
+#include <stddef.h>   // size_t
+#include <string.h>   // memmove, explicit_bzero
+
+#include "os.h"
+#include "cx.h"
+
+#include "get_public_keys.h"
+#include "../globals.h"
+#include "../constants.h"
+#include "../io.h"
+#include "../sw.h"
+#include "../crypto.h"
+#include "../common/buffer.h"
+#include "../common/bip44.h"
+#include "../ui/utils.h"
+
+int handler_get_public_keys(buffer_t *cdata, uint8_t format) {
+    explicit_bzero(&G_context, sizeof(G_context));
+
+    uint16_t status;
+    if (!buffer_read_and_validate_bip44(cdata, G_context.bip44_path, &status)) {
+        return io_send_sw(status);
+    }
+
+    uint16_t count;
+    if (!buffer_read_u16(cdata, &count, BE) || cdata->offset != cdata->size) {
+        return io_send_sw(SW_WRONG_DATA_LENGTH);
+    }
+
+    // the last address must still be within the range accepted for a single address
+    if (count == 0 || G_context.bip44_path[4] + count > BIP44_MAX_ADDRESS_INDEX) {
+        return io_send_sw(SW_BIP44_BAD_ADDRESS);
+    }
+
+    size_t item_len = (format == PUBKEYS_FORMAT_COMPRESSED) ? 33 : UINT160_LEN;
+    uint16_t max_items = (format == PUBKEYS_FORMAT_COMPRESSED) ? MAX_PUBKEYS_PER_RESPONSE
+                                                               : MAX_SCRIPT_HASHES_PER_RESPONSE;
+    uint8_t n = (uint8_t) ((count < max_items) ? count : max_items);
+
+    uint8_t resp[1 + MAX_SCRIPT_HASHES_PER_RESPONSE * UINT160_LEN] = {0};
+    size_t len = 0;
+    resp[len++] = n;
+
+    cx_ecfp_private_key_t private_key = {0};
+    cx_ecfp_public_key_t public_key = {0};
+
+    for (uint8_t i = 0; i < n; i++) {
+        // a scan only peeks at the cache, it would otherwise skew the counters and push out the keys that are
+        // queried repeatedly
+        const pubkey_cache_entry_t *entry = pubkey_cache_peek(&G_pubkey_cache, G_context.bip44_path);
+        if (entry != NULL) {
+            memmove(G_context.raw_public_key, entry->public_key, sizeof(G_context.raw_public_key));
+        } else {
+            crypto_derive_private_key(&private_key, G_context.bip44_path, BIP44_PATH_LEN);
+            crypto_init_public_key(&private_key, &public_key, G_context.raw_public_key);
+            explicit_bzero(&private_key, sizeof(private_key));
+        }
+
+        if (format == PUBKEYS_FORMAT_COMPRESSED) {
+            compress_public_key(G_context.raw_public_key, resp + len);
+        } else if (entry != NULL) {
+            memmove(resp + len, entry->script_hash, UINT160_LEN);
+        } else {
+            script_hash_from_pubkey(G_context.raw_public_key, resp + len);
+        }
+        len += item_len;
+
+        G_context.bip44_path[4]++;
+    }
+
+    return io_send_response(&(const buffer_t){.ptr = resp, .size = len, .offset = 0}, SW_OK);
+}
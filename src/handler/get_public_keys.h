@@ -0,0 +1,37 @@
+#pragma once
+
+#include <stdint.h>  // uint*_t
+
+#include "../common/buffer.h"
+
+/**
+ * GET_PUBLIC_KEYS format (P1) returning compressed public keys.
+ */
+#define PUBKEYS_FORMAT_COMPRESSED 0x00
+/**
+ * GET_PUBLIC_KEYS format (P1) returning script hashes of the single signature verification scripts.
+ */
+#define PUBKEYS_FORMAT_SCRIPT_HASH 0x01
+
+/**
+ * Maximum number of compressed public keys (33 bytes) in one response.
+ */
+#define MAX_PUBKEYS_PER_RESPONSE 7
+/**
+ * Maximum number of script hashes (20 bytes) in one response.
+ */
+#define MAX_SCRIPT_HASHES_PER_RESPONSE 12
+
+/**
+ * Handler for GET_PUBLIC_KEYS command. Derive the public keys of consecutive address indexes
+ * and send as many as fit in the APDU response. The host asks for the rest with a new start index.
+ *
+ * @param[in,out] cdata
+ *   Command data with the BIP44 path of the first address and the number of addresses.
+ * @param[in]     format
+ *   PUBKEYS_FORMAT_COMPRESSED or PUBKEYS_FORMAT_SCRIPT_HASH.
+ *
+ * @return zero or positive integer if success, negative integer otherwise.
+ *
+ */
+int handler_get_public_keys(buffer_t *cdata, uint8_t format);
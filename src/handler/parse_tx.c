@@ -0,0 +1,76 @@
+/*****************************************************************************
+ *   Ledger App Boilerplate.
+ *   (c) 2020 Ledger SAS.
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *****************************************************************************/
+
+#include <stdint.h>   // uint*_t
+#include <stdbool.h>  // bool
+#include <string.h>   // explicit_bzero
+
+#include "os.h"
+
+#include "parse_tx.h"
+#include "../sw.h"
+#include "../globals.h"
+#include "../common/buffer.h"
+#include "../helper/send_response.h"
+#include "../transaction/types.h"
+#include "../transaction/deserialize.h"
+#include "../transaction/tx_hash.h"
+
+/**
+ * Send the summary and end the dry run, so no further chunk or signing request can build on it.
+ */
+static int send_summary(parser_status_e status, uint32_t offset) {
+    int ret = helper_send_response_tx_summary(status, offset);
+    explicit_bzero(&G_context, sizeof(G_context));
+
+    return ret;
+}
+
+int handler_parse_tx(buffer_t *cdata, bool first, bool more) {
+    if (first) {
+        explicit_bzero(&G_context, sizeof(G_context));
+        G_context.req_type = CHECK_TRANSACTION;
+        G_context.state = STATE_NONE;
+
+        transaction_parser_init(&G_context.tx_info.parser, &G_context.tx_info.transaction);
+        transaction_hash_init(&G_context.tx_info.tx_hash);
+    } else if (G_context.req_type != CHECK_TRANSACTION) {
+        return io_send_sw(SW_BAD_STATE);
+    }
+
+    tx_parser_t *parser = &G_context.tx_info.parser;
+
+    transaction_hash_update(&G_context.tx_info.tx_hash, cdata);
+
+    parser_status_e status = transaction_parser_feed(parser, &G_context.tx_info.transaction, cdata);
+    if (status != PARSING_OK) {
+        // data after the end of the transaction or beyond the maximum length fails at the current offset
+        return send_summary(status, (status == INVALID_LENGTH_ERROR) ? parser->offset : parser->field_offset);
+    }
+
+    if (more) {
+        return io_send_sw(SW_OK);
+    }
+
+    // the transaction ended early, report where the data ran out
+    status = transaction_parser_finish(parser);
+    if (status == PARSING_OK) {
+        transaction_hash_final(&G_context.tx_info.tx_hash, G_context.tx_info.hash);
+    }
+
+    return send_summary(status, parser->offset);
+}
@@ -0,0 +1,23 @@
+#pragma once
+
+#include <stdbool.h>  // bool
+
+#include "../common/buffer.h"
+
+/**
+ * Handler for PARSE_TX command. Run the on-device transaction parser on streamed data and send back a summary
+ * of the result. Nothing is shown to the user and the transaction can't be signed afterwards.
+ *
+ * @see G_context.tx_info.parser, G_context.tx_info.transaction.
+ *
+ * @param[in,out] cdata
+ *   Command data with the next part of the raw transaction.
+ * @param[in]     first
+ *   Whether this is the first chunk of the transaction.
+ * @param[in]     more
+ *   Whether more chunks are expected to be received or not.
+ *
+ * @return zero or positive integer if success, negative integer otherwise.
+ *
+ */
+int handler_parse_tx(buffer_t *cdata, bool first, bool more);
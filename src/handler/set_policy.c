@@ -0,0 +1,91 @@
+/*****************************************************************************
+ *   Ledger App Boilerplate.
+ *   (c) 2020 Ledger SAS.
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *****************************************************************************/
+
+#include <stdint.h>   // uint*_t
+#include <stdbool.h>  // bool
+#include <string.h>   // explicit_bzero
+
+#include "os.h"
+
+#include "set_policy.h"
+#include "../sw.h"
+#include "../globals.h"
+#include "../crypto.h"
+#include "../ui/display.h"
+#include "../ui/utils.h"
+#include "../common/buffer.h"
+#include "../common/bip44.h"
+#include "../apdu/dispatcher.h"
+
+int handler_set_policy(buffer_t *cdata, uint8_t p1) {
+    explicit_bzero(&G_context, sizeof(G_context));
+    // A new policy always replaces the current one, even when it ends up rejected
+    explicit_bzero(&G_policy, sizeof(G_policy));
+
+    if (p1 == P1_POLICY_CLEAR) {
+        return io_send_sw(SW_OK);
+    }
+
+    G_context.req_type = CONFIRM_POLICY;
+    G_context.state = STATE_NONE;
+
+    uint16_t status;
+    if (!buffer_read_and_validate_bip44(cdata, G_policy.bip44_path, &status)) {
+        return io_send_sw(status);
+    }
+
+    if (!buffer_read_u32(cdata, &G_policy.network_magic, LE)) {
+        return io_send_sw(SW_MAGIC_PARSING_FAIL);
+    }
+
+    if (!buffer_can_read(cdata, UINT160_LEN)) {
+        return io_send_sw(SW_WRONG_DATA_LENGTH);
+    }
+    script_hash_to_address((char *) G_policy.dst_address, sizeof(G_policy.dst_address), cdata->ptr + cdata->offset);
+    buffer_seek_cur(cdata, UINT160_LEN);
+
+    uint8_t asset;
+    if (!buffer_read_u8(cdata, &asset) ||                                //
+        !buffer_read_u64(cdata, &G_policy.max_amount, LE) ||             //
+        !buffer_read_u64(cdata, &G_policy.max_total, LE) ||              //
+        !buffer_read_u64(cdata, &G_policy.max_fee, LE) ||                //
+        !buffer_read_u32(cdata, &G_policy.max_valid_until_block, LE) ||  //
+        !buffer_read_u8(cdata, &G_policy.max_count) ||                   //
+        cdata->offset != cdata->size) {
+        return io_send_sw(SW_WRONG_DATA_LENGTH);
+    }
+
+    if (asset > POLICY_ASSET_GAS || G_policy.max_count == 0) {
+        return io_send_sw(SW_INVALID_POLICY);
+    }
+    G_policy.is_neo = (asset == POLICY_ASSET_NEO);
+
+    // the policy only signs for the account of its path, see policy_allows()
+    cx_ecfp_private_key_t private_key = {0};
+    cx_ecfp_public_key_t public_key = {0};
+    uint8_t raw_public_key[64];
+    crypto_derive_private_key(&private_key, G_policy.bip44_path, BIP44_PATH_LEN);
+    crypto_init_public_key(&private_key, &public_key, raw_public_key);
+    explicit_bzero(&private_key, sizeof(private_key));
+    script_hash_from_pubkey(raw_public_key, G_policy.account);
+
+    // the policy is shown with the network name of the transaction review
+    G_context.network_magic = G_policy.network_magic;
+    G_context.state = STATE_PARSED;
+
+    return ui_display_policy();
+}
@@ -0,0 +1,30 @@
+#pragma once
+
+#include <stdint.h>  // uint*_t
+
+#include "../common/buffer.h"
+
+/**
+ * Policy asset identifier for NEO.
+ */
+#define POLICY_ASSET_NEO 0x00
+/**
+ * Policy asset identifier for GAS.
+ */
+#define POLICY_ASSET_GAS 0x01
+
+/**
+ * Handler for SET_POLICY command. Shows the spending policy to the user and, once approved,
+ * signs matching NEO or GAS transfers without review for the rest of the session.
+ *
+ * @see G_policy.
+ *
+ * @param[in,out] cdata
+ *   Command data with BIP44 path, network magic, destination script hash, asset and limits.
+ * @param[in]     p1
+ *   P1_POLICY_SET to set a new policy, P1_POLICY_CLEAR to remove the current one.
+ *
+ * @return zero or positive integer if success, negative integer otherwise.
+ *
+ */
+int handler_set_policy(buffer_t *cdata, uint8_t p1);
@@ -0,0 +1,200 @@
+/*****************************************************************************
+ *   Ledger App Boilerplate.
+ *   (c) 2020 Ledger SAS.
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *****************************************************************************/
+
+#include <stdint.h>   // uint*_t, UINT64_MAX
+#include <stdbool.h>  // bool
+#include <string.h>   // memcmp, memcpy, explicit_bzero
+
+#include "os.h"
+#include "cx.h"
+
+#include "sign_batch.h"
+#include "../sw.h"
+#include "../globals.h"
+#include "../crypto.h"
+#include "../ui/display.h"
+#include "../ui/utils.h"
+#include "../common/buffer.h"
+#include "../common/bip44.h"
+#include "../transaction/types.h"
+#include "../transaction/deserialize.h"
+#include "../transaction/tx_hash.h"
+#include "../apdu/dispatcher.h"
+
+/**
+ * Add 'value' to 'total', fails if the sum does not fit.
+ */
+static bool add_to_total(uint64_t *total, uint64_t value) {
+    if (*total > UINT64_MAX - value) {
+        return false;
+    }
+    *total += value;
+
+    return true;
+}
+
+/**
+ * Add a fully received transaction to the batch and get ready for the next one.
+ */
+static int add_transaction(void) {
+    batch_ctx_t *batch = &G_context.tx_info.batch;
+    const transaction_t *tx = &G_context.tx_info.transaction;
+
+    // The summary can only show totals for NEO and GAS transfers
+    if (!tx->is_system_asset_transfer || tx->amount < 0) {
+        G_context.state = STATE_NONE;
+        return io_send_sw(SW_BATCH_TX_NOT_SUPPORTED);
+    }
+
+    // The summary doesn't show signers or attributes: only the account of the batch path may sign, with a witness
+    // limited to the entry script, and only HighPriority leaves what the transaction does unchanged
+    if (tx->signers_size != 1 || tx->signers[0].scope != CALLED_BY_ENTRY ||
+        memcmp(transaction_signer_account(tx, 0), batch->account, UINT160_LEN) != 0) {
+        G_context.state = STATE_NONE;
+        return io_send_sw(SW_BATCH_TX_NOT_SUPPORTED);
+    }
+    for (uint8_t i = 0; i < tx->attributes_size; i++) {
+        if (tx->attributes[i].type != HIGH_PRIORITY) {
+            G_context.state = STATE_NONE;
+            return io_send_sw(SW_BATCH_TX_NOT_SUPPORTED);
+        }
+    }
+
+    if (!add_to_total(tx->is_neo ? &batch->neo_total : &batch->gas_total, (uint64_t) tx->amount) ||
+        !add_to_total(&batch->fees_total, (uint64_t) tx->system_fee + (uint64_t) tx->network_fee)) {
+        G_context.state = STATE_NONE;
+        return io_send_sw(SW_BATCH_TX_NOT_SUPPORTED);
+    }
+
+    if (batch->count == 0) {
+        memcpy(batch->dst_address, tx->dst_address, sizeof(batch->dst_address));
+    } else if (memcmp(batch->dst_address, tx->dst_address, sizeof(batch->dst_address)) != 0) {
+        batch->mixed_destinations = true;
+    }
+
+    if (tx->valid_until_block > batch->max_valid_until_block) {
+        batch->max_valid_until_block = tx->valid_until_block;
+    }
+
+    transaction_hash_final(&G_context.tx_info.tx_hash, batch->hashes[batch->count]);
+    PRINTF("Batch hash %d: %.*H\n", batch->count, TX_HASH_LEN, batch->hashes[batch->count]);
+    batch->count++;
+
+    transaction_parser_init(&G_context.tx_info.parser, &G_context.tx_info.transaction);
+    transaction_hash_init(&G_context.tx_info.tx_hash);
+
+    return io_send_sw(SW_OK);
+}
+
+static int receive_transaction(buffer_t *cdata, bool more) {
+    if (G_context.req_type != CONFIRM_BATCH || G_context.state != STATE_MAGIC_OK) {
+        return io_send_sw(SW_BAD_STATE);
+    }
+
+    if (G_context.tx_info.batch.count == MAX_BATCH_TX) {
+        return io_send_sw(SW_BATCH_FULL);
+    }
+
+    if (G_context.tx_info.parser.offset + (cdata->size - cdata->offset) > MAX_TRANSACTION_LEN) {
+        G_context.state = STATE_NONE;
+        return io_send_sw(SW_WRONG_TX_LENGTH);
+    }
+
+    transaction_hash_update(&G_context.tx_info.tx_hash, cdata);
+
+    parser_status_e status = transaction_parser_feed(&G_context.tx_info.parser, &G_context.tx_info.transaction, cdata);
+    if (status == PARSING_OK && !more) {
+        status = transaction_parser_finish(&G_context.tx_info.parser);
+    }
+    if (status != PARSING_OK) {
+        PRINTF("Parsing status: %d.\n", status);
+        G_context.state = STATE_NONE;
+        uint8_t status_byte = (uint8_t) status;
+        return io_send_response(&(const buffer_t){.ptr = &status_byte, .size = 1, .offset = 0}, SW_TX_PARSING_FAIL);
+    }
+
+    if (more) {  // APDU with another part of the current transaction
+        return io_send_sw(SW_OK);
+    }
+
+    return add_transaction();
+}
+
+static int send_signature(buffer_t *cdata) {
+    if (G_context.req_type != CONFIRM_BATCH || G_context.state != STATE_APPROVED) {
+        return io_send_sw(SW_BAD_STATE);
+    }
+
+    uint8_t index;
+    if (!buffer_read_u8(cdata, &index) || index >= G_context.tx_info.batch.count) {
+        return io_send_sw(SW_WRONG_DATA_LENGTH);
+    }
+
+    // Signatures are only produced on request, so the batch never has to hold them all
+    if (crypto_sign_tx_hash(G_context.tx_info.batch.hashes[index]) < 0) {
+        return io_send_sw(SW_SIGN_FAIL);
+    }
+
+    return io_send_response(
+        &(const buffer_t){.ptr = G_context.tx_info.signature, .size = G_context.tx_info.signature_len, .offset = 0},
+        SW_OK);
+}
+
+int handler_sign_batch(buffer_t *cdata, uint8_t p1, bool more) {
+    if (p1 == P1_BATCH_START) {
+        explicit_bzero(&G_context, sizeof(G_context));
+        G_context.req_type = CONFIRM_BATCH;
+        G_context.state = STATE_NONE;
+
+        uint16_t status;
+        if (!buffer_read_and_validate_bip44(cdata, G_context.bip44_path, &status)) {
+            return io_send_sw(status);
+        }
+
+        if (!buffer_read_u32(cdata, &G_context.network_magic, LE)) {
+            return io_send_sw(SW_MAGIC_PARSING_FAIL);
+        }
+
+        // every transaction of the batch must be signed by the account of the path only, see add_transaction()
+        cx_ecfp_private_key_t private_key = {0};
+        cx_ecfp_public_key_t public_key = {0};
+        uint8_t raw_public_key[64];
+        crypto_derive_private_key(&private_key, G_context.bip44_path, BIP44_PATH_LEN);
+        crypto_init_public_key(&private_key, &public_key, raw_public_key);
+        explicit_bzero(&private_key, sizeof(private_key));
+        script_hash_from_pubkey(raw_public_key, G_context.tx_info.batch.account);
+
+        transaction_parser_init(&G_context.tx_info.parser, &G_context.tx_info.transaction);
+        transaction_hash_init(&G_context.tx_info.tx_hash);
+
+        G_context.state = STATE_MAGIC_OK;
+        return io_send_sw(SW_OK);
+    } else if (p1 == P1_BATCH_TX) {
+        return receive_transaction(cdata, more);
+    } else if (p1 == P1_BATCH_REVIEW) {
+        // all transactions must be complete before the summary can be shown
+        if (G_context.req_type != CONFIRM_BATCH || G_context.state != STATE_MAGIC_OK ||
+            G_context.tx_info.batch.count == 0 || G_context.tx_info.parser.offset != 0) {
+            return io_send_sw(SW_BAD_STATE);
+        }
+
+        G_context.state = STATE_PARSED;
+        return ui_display_batch();
+    } else {  // P1_BATCH_GET_SIGNATURE
+        return send_signature(cdata);
+    }
+}
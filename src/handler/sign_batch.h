@@ -0,0 +1,25 @@
+#pragma once
+
+#include <stdint.h>   // uint*_t
+#include <stdbool.h>  // bool
+
+#include "../common/buffer.h"
+
+/**
+ * Handler for SIGN_BATCH command. Receives several transactions for the same BIP44 path and network magic,
+ * keeps only their hashes and, once the summary of the batch is approved, signs them one by one on request.
+ *
+ * @see G_context.bip44_path, G_context.tx_info.batch,
+ * G_context.tx_info.signature.
+ *
+ * @param[in,out] cdata
+ *   Command data with BIP44 path and network magic, raw transaction data or the index of the signature.
+ * @param[in]     p1
+ *   Step of the batch session (P1_BATCH_*).
+ * @param[in]     more
+ *   Whether the current transaction continues in the next APDU or not.
+ *
+ * @return zero or positive integer if success, negative integer otherwise.
+ *
+ */
+int handler_sign_batch(buffer_t *cdata, uint8_t p1, bool more);
@@ -28,88 +28,247 @@
 #include "../globals.h"
 #include "../crypto.h"
 #include "../ui/display.h"
+#include "../ui/menu.h"
 #include "../common/buffer.h"
 #include "../common/bip44.h"
 #include "../transaction/types.h"
 #include "../transaction/deserialize.h"
+#include "../transaction/tx_hash.h"
+#include "../transaction/policy.h"
+#include "../apdu/dispatcher.h"
+#include "../helper/send_response.h"
+#include "../ui/utils.h"
 
-int handler_sign_tx(buffer_t *cdata, uint8_t chunk, bool more) {
-    if (chunk == 0) {  // First APDU, parse BIP44 path
-        explicit_bzero(&G_context, sizeof(G_context));
-        G_context.req_type = CONFIRM_TRANSACTION;
-        G_context.state = STATE_NONE;
+static int send_parsing_error(parser_status_e status) {
+    // No further chunks are accepted for a transaction that failed to parse
+    G_context.state = STATE_NONE;
+
+    if (G_context.tx_info.review_started) {  // drop the screens of a review that can't complete
+        G_context.tx_info.review_started = false;
+        ui_menu_main();
+    }
+
+    char status_char[1] = {(uint8_t) status};
+    return io_send_response(&(const buffer_t){.ptr = (unsigned char *) status_char, .size = 1, .offset = 0},
+                            SW_TX_PARSING_FAIL);
+}
 
-        uint16_t status;
-        if (!buffer_read_and_validate_bip44(cdata, G_context.bip44_path, &status)) {
-            return io_send_sw(status);
+/**
+ * Reset the signing context and parse the BIP44 path.
+ *
+ * @return SW_OK if success, a status word indicating the failure otherwise.
+ */
+static uint16_t parse_bip44_path(buffer_t *cdata, uint8_t options) {
+    explicit_bzero(&G_context, sizeof(G_context));
+    G_context.req_type = CONFIRM_TRANSACTION;
+    G_context.state = STATE_NONE;
+    G_context.tx_info.large_script = (options & P2_LARGE_SCRIPT) != 0;
+    G_context.tx_info.raw_signature = (options & P2_RAW_SIGNATURE) != 0;
+
+    uint16_t status;
+    if (options & P2_MULTI_SIGNER) {
+        signer_paths_t *signer_paths = &G_context.tx_info.signer_paths;
+        if (!buffer_read_u8(cdata, &signer_paths->count) || signer_paths->count == 0 ||
+            signer_paths->count > MAX_SIGNER_PATHS) {
+            return SW_WRONG_DATA_LENGTH;
         }
 
-        G_context.state = STATE_BIP44_OK;
-        return io_send_sw(SW_OK);
-    } else if (chunk == 1) {
-        if (G_context.req_type != CONFIRM_TRANSACTION && G_context.state != STATE_BIP44_OK) {
-            return io_send_sw(SW_BAD_STATE);
+        for (uint8_t i = 0; i < signer_paths->count; i++) {
+            if (!buffer_read_and_validate_bip44(cdata, signer_paths->paths[i], &status)) {
+                return status;
+            }
         }
+        memmove(G_context.bip44_path, signer_paths->paths[0], sizeof(G_context.bip44_path));
+    } else if (!buffer_read_and_validate_bip44(cdata, G_context.bip44_path, &status)) {
+        return status;
+    }
+
+    G_context.state = STATE_BIP44_OK;
+    return SW_OK;
+}
+
+/**
+ * Parse the network magic and get ready to receive the transaction.
+ *
+ * @return SW_OK if success, a status word indicating the failure otherwise.
+ */
+static uint16_t parse_network_magic(buffer_t *cdata) {
+    if (G_context.req_type != CONFIRM_TRANSACTION || G_context.state != STATE_BIP44_OK) {
+        return SW_BAD_STATE;
+    }
+
+    if (!buffer_read_u32(cdata, &G_context.network_magic, LE)) {
+        return SW_MAGIC_PARSING_FAIL;
+    }
 
-        if (!buffer_read_u32(cdata, &G_context.network_magic, LE)) {
-            return io_send_sw(SW_MAGIC_PARSING_FAIL);
+    transaction_parser_init(&G_context.tx_info.parser, &G_context.tx_info.transaction);
+    if (G_context.tx_info.large_script) {
+        transaction_parser_allow_large_script(&G_context.tx_info.parser);
+    }
+    /**
+     * Here we hash the signed part of the transaction while it streams in. This is _not_ the final hash used as
+     * input for ecdsa (see crypto_sign_tx()) The final hash is: sha256(network magic + sha256(signed part of tx
+     * data)), but we don't hash this until we've approved among others the network magic
+     */
+    transaction_hash_init(&G_context.tx_info.tx_hash);
+
+    G_context.state = STATE_MAGIC_OK;
+    return SW_OK;
+}
+
+/**
+ * Find the signer of the transaction for each of the BIP44 paths of a multi signer SIGN_TX.
+ *
+ * @return true if every path is the account of a signer and no two paths are of the same signer.
+ */
+static bool match_signer_paths(void) {
+    signer_paths_t *signer_paths = &G_context.tx_info.signer_paths;
+    const transaction_t *tx = &G_context.tx_info.transaction;
+
+    cx_ecfp_private_key_t private_key = {0};
+    cx_ecfp_public_key_t public_key = {0};
+    uint8_t raw_public_key[64];
+    uint8_t script_hash[UINT160_LEN];
+
+    for (uint8_t i = 0; i < signer_paths->count; i++) {
+        crypto_derive_private_key(&private_key, signer_paths->paths[i], BIP44_PATH_LEN);
+        crypto_init_public_key(&private_key, &public_key, raw_public_key);
+        explicit_bzero(&private_key, sizeof(private_key));
+        script_hash_from_pubkey(raw_public_key, script_hash);
+
+        uint8_t s = 0;
+        while (s < tx->signers_size && memcmp(transaction_signer_account(tx, s), script_hash, UINT160_LEN) != 0) {
+            s++;
         }
-        G_context.state = STATE_MAGIC_OK;
-        return io_send_sw(SW_OK);
-    } else {  // Receive transaction
-        if (G_context.req_type != CONFIRM_TRANSACTION && G_context.state != STATE_MAGIC_OK) {
-            return io_send_sw(SW_BAD_STATE);
+        if (s == tx->signers_size) {
+            return false;
         }
 
-        if (more) {  // APDU with another transaction part
-            if (G_context.tx_info.raw_tx_len + cdata->size > MAX_TRANSACTION_LEN ||
-                !buffer_move(cdata, G_context.tx_info.raw_tx + G_context.tx_info.raw_tx_len, cdata->size)) {
-                return io_send_sw(SW_WRONG_TX_LENGTH);
+        // signers are unique, so a second path of the same signer is the same path
+        for (uint8_t j = 0; j < i; j++) {
+            if (signer_paths->signer_indexes[j] == s) {
+                return false;
             }
+        }
+        signer_paths->signer_indexes[i] = s;
+    }
 
-            G_context.tx_info.raw_tx_len += cdata->size;
+    return true;
+}
 
-            return io_send_sw(SW_OK);
-        } else {  // Last APDU, let's parse and sign
-            if (G_context.tx_info.raw_tx_len + cdata->size > MAX_TRANSACTION_LEN ||
-                !buffer_move(cdata, G_context.tx_info.raw_tx + G_context.tx_info.raw_tx_len, cdata->size)) {
-                return io_send_sw(SW_WRONG_TX_LENGTH);
-            }
+/**
+ * Sign a transaction covered by the approved spending policy, without review.
+ */
+static int sign_with_policy(void) {
+    G_context.state = STATE_APPROVED;
 
-            G_context.tx_info.raw_tx_len += cdata->size;
+    if (crypto_sign_tx() < 0) {
+        G_context.state = STATE_NONE;
+        return io_send_sw(SW_SIGN_FAIL);
+    }
 
-            buffer_t buf = {.ptr = G_context.tx_info.raw_tx, .size = G_context.tx_info.raw_tx_len, .offset = 0};
+    policy_record(&G_policy, &G_context.tx_info.transaction);
 
-            parser_status_e status = transaction_deserialize(&buf, &G_context.tx_info.transaction);
-            PRINTF("Parsing status: %d.\n", status);
-            if (status != PARSING_OK) {
-                char status_char[1] = {(uint8_t) status};
-                return io_send_response(&(const buffer_t){.ptr = (unsigned char *) status_char, .size = 1, .offset = 0},
-                                        SW_TX_PARSING_FAIL);
-            }
+    return helper_send_response_sig();
+}
+
+/**
+ * Parse and hash the unread part of 'cdata' as the next part of the transaction.
+ * Starts the review with the header screens as soon as they are parsed, the
+ * remaining screens are added once the last part has been received.
+ */
+static int receive_transaction(buffer_t *cdata, bool more) {
+    if (G_context.req_type == CONFIRM_TRANSACTION && G_context.state == STATE_REJECTED) {
+        // The user rejected the review before the whole transaction was received
+        G_context.state = STATE_NONE;
+        return io_send_sw(SW_DENY);
+    }
+
+    if (G_context.req_type != CONFIRM_TRANSACTION || G_context.state != STATE_MAGIC_OK) {
+        return io_send_sw(SW_BAD_STATE);
+    }
+
+    if (!G_context.tx_info.large_script &&
+        G_context.tx_info.parser.offset + (cdata->size - cdata->offset) > MAX_TRANSACTION_LEN) {
+        G_context.state = STATE_NONE;
+        if (G_context.tx_info.review_started) {
+            G_context.tx_info.review_started = false;
+            ui_menu_main();
+        }
+        return io_send_sw(SW_WRONG_TX_LENGTH);
+    }
+
+    transaction_hash_update(&G_context.tx_info.tx_hash, cdata);
+
+    // Parse the chunk right away, so a malformed transaction is rejected on the first bad chunk
+    parser_status_e status = transaction_parser_feed(&G_context.tx_info.parser, &G_context.tx_info.transaction, cdata);
+    if (status != PARSING_OK) {
+        PRINTF("Parsing status: %d.\n", status);
+        return send_parsing_error(status);
+    }
+
+    if (more) {  // APDU with another transaction part
+        if (!G_context.tx_info.review_started && G_context.tx_info.parser.step >= TX_STEP_ATTRIBUTES_LENGTH) {
+            // Fees, validity and signers are known, let the user go through them while the rest arrives
+            G_context.tx_info.review_started = true;
+            return ui_display_transaction_header();
+        }
 
-            G_context.state = STATE_PARSED;
+        return io_send_sw(SW_OK);
+    }
+
+    // Last APDU, make sure the transaction is complete and sign
+    status = transaction_parser_finish(&G_context.tx_info.parser);
+    PRINTF("Parsing status: %d.\n", status);
+    if (status != PARSING_OK) {
+        return send_parsing_error(status);
+    }
 
-            /**
-             * Here we hash the signed part of the transaction. This is _not_ the final hash used as input for ecdsa
-             * (see crypto_sign_tx()) The final hash is: sha256(network magic + sha256(signed part of tx data)), but we
-             * don't hash this until we've approved among others the network magic
-             */
+    G_context.state = STATE_PARSED;
 
-            cx_sha256_t tx_hash;
-            cx_sha256_init(&tx_hash);
-            cx_hash((cx_hash_t *) &tx_hash,
-                    CX_LAST /*mode*/,
-                    G_context.tx_info.raw_tx /* data in */,
-                    G_context.tx_info.raw_tx_len /* data in len */,
-                    G_context.tx_info.hash /* hash out*/,
-                    sizeof(G_context.tx_info.hash) /* hash out len */);
+    // All chunks are already hashed, only the digest is left to compute
+    transaction_hash_final(&G_context.tx_info.tx_hash, G_context.tx_info.hash);
 
-            PRINTF("Hash: %.*H\n", sizeof(G_context.tx_info.hash), G_context.tx_info.hash);
+    PRINTF("Hash: %.*H\n", sizeof(G_context.tx_info.hash), G_context.tx_info.hash);
+
+    if (G_context.tx_info.signer_paths.count > 0 && !match_signer_paths()) {
+        G_context.state = STATE_NONE;
+        if (G_context.tx_info.review_started) {
+            G_context.tx_info.review_started = false;
+            ui_menu_main();
+        }
+        return io_send_sw(SW_SIGNER_NOT_FOUND);
+    }
 
-            return ui_display_transaction();
+    // a policy covers a single signer, several signers are always reviewed
+    if (G_context.tx_info.signer_paths.count == 0 &&
+        policy_allows(&G_policy, G_context.bip44_path, G_context.network_magic, &G_context.tx_info.transaction)) {
+        if (G_context.tx_info.review_started) {  // no review needed after all
+            ui_menu_main();
         }
+        return sign_with_policy();
     }
 
-    return 0;
+    // Derive the key and hash the message now, while the user goes through the review
+    crypto_prepare_signing_key(G_context.tx_info.hash);
+
+    return ui_display_transaction();
+}
+
+int handler_sign_tx(buffer_t *cdata, uint8_t chunk, bool more, uint8_t options) {
+    uint16_t sw;
+
+    if (chunk == P1_START) {  // First APDU, parse BIP44 path
+        return io_send_sw(parse_bip44_path(cdata, options));
+    } else if (chunk == P1_MAGIC) {
+        return io_send_sw(parse_network_magic(cdata));
+    } else if (chunk == P1_START_WITH_TX) {  // BIP44 path, network magic and the start of the transaction at once
+        if ((sw = parse_bip44_path(cdata, options)) != SW_OK || (sw = parse_network_magic(cdata)) != SW_OK) {
+            return io_send_sw(sw);
+        }
+
+        return receive_transaction(cdata, more);
+    } else {  // Receive transaction
+        return receive_transaction(cdata, more);
+    }
 }
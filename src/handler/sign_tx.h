@@ -9,7 +9,7 @@
  * Handler for SIGN_TX command. If the BIP44 path is parsed successfully
  * sign the transaction and send the signature in the APDU response.
  *
- * @see G_context.bip44_path, G_context.tx_info.raw_transaction,
+ * @see G_context.bip44_path, G_context.tx_info.parser,
  * G_context.tx_info.signature.
  *
  * @param[in,out] cdata
@@ -18,8 +18,10 @@
  *   Index number of the APDU chunk.
  * @param[in]       more
  *   Whether more chunks are expected to be received or not.
+ * @param[in]       options
+ *   P2_LARGE_SCRIPT, P2_RAW_SIGNATURE and P2_MULTI_SIGNER flags, only used on the first APDU.
  *
  * @return zero or positive integer if success, negative integer otherwise.
  *
  */
-int handler_sign_tx(buffer_t *cdata, uint8_t chunk, bool more);
+int handler_sign_tx(buffer_t *cdata, uint8_t chunk, bool more, uint8_t options);
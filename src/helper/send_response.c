@@ -7,14 +7,147 @@
 #include "../globals.h"
 #include "../sw.h"
 #include "common/buffer.h"
+#include "common/write.h"
+#include "../handler/get_public_key.h"
+#include "../ui/utils.h"
 
 int helper_send_response_pubkey() {
     uint8_t resp[1 + PUBKEY_LEN] = {0};
-    size_t offset = 1;
+    size_t offset = 0;
+    uint8_t script_hash[UINT160_LEN];
 
-    resp[0] = 0x04;
-    memmove(resp + offset, G_context.raw_public_key, PUBKEY_LEN);
-    offset += PUBKEY_LEN;
+    switch (G_context.pubkey_format) {
+        case P1_PUBKEY_COMPRESSED:
+            compress_public_key(G_context.raw_public_key, resp);
+            offset = 33;
+            break;
+        case P1_PUBKEY_SCRIPT_HASH:
+            script_hash_from_pubkey(G_context.raw_public_key, resp);
+            offset = UINT160_LEN;
+            break;
+        case P1_PUBKEY_ADDRESS:
+            script_hash_from_pubkey(G_context.raw_public_key, script_hash);
+            // base58 output is written without terminator, the buffer holds exactly the address
+            script_hash_to_address((char *) resp, ADDRESS_LEN, script_hash);
+            offset = ADDRESS_LEN;
+            break;
+        default:
+            resp[offset++] = 0x04;
+            memmove(resp + offset, G_context.raw_public_key, PUBKEY_LEN);
+            offset += PUBKEY_LEN;
+            break;
+    }
 
     return io_send_response(&(const buffer_t){.ptr = resp, .size = offset, .offset = 0}, SW_OK);
-}
\ No newline at end of file
+}
+
+int helper_send_response_xpub() {
+    uint8_t resp[sizeof(G_context.xpub.public_key) + sizeof(G_context.xpub.chain_code)] = {0};
+    size_t offset = 0;
+
+    memmove(resp + offset, G_context.xpub.public_key, sizeof(G_context.xpub.public_key));
+    offset += sizeof(G_context.xpub.public_key);
+    memmove(resp + offset, G_context.xpub.chain_code, sizeof(G_context.xpub.chain_code));
+    offset += sizeof(G_context.xpub.chain_code);
+
+    return io_send_response(&(const buffer_t){.ptr = resp, .size = offset, .offset = 0}, SW_OK);
+}
+
+int helper_send_response_multisig() {
+    uint8_t resp[UINT160_LEN + ADDRESS_LEN] = {0};
+    size_t offset = 0;
+
+    memmove(resp + offset, G_context.multisig.script_hash, UINT160_LEN);
+    offset += UINT160_LEN;
+    script_hash_to_address((char *) resp + offset, ADDRESS_LEN, G_context.multisig.script_hash);
+    offset += ADDRESS_LEN;
+
+    return io_send_response(&(const buffer_t){.ptr = resp, .size = offset, .offset = 0}, SW_OK);
+}
+
+int helper_send_response_sig() {
+    if (!G_context.tx_info.raw_signature) {
+        return io_send_response(
+            &(const buffer_t){.ptr = G_context.tx_info.signature, .size = G_context.tx_info.signature_len, .offset = 0},
+            SW_OK);
+    }
+
+    uint8_t resp[RAW_SIG_RESPONSE_LEN] = {0};
+
+    if (!der_signature_to_rs(G_context.tx_info.signature, G_context.tx_info.signature_len, resp)) {
+        return io_send_sw(SW_SIGN_FAIL);
+    }
+    memmove(resp + RS_SIGNATURE_LEN, G_context.tx_info.hash, TX_HASH_LEN);
+
+    return io_send_response(&(const buffer_t){.ptr = resp, .size = sizeof(resp), .offset = 0}, SW_OK);
+}
+
+int helper_send_response_sigs() {
+    const signer_paths_t *signer_paths = &G_context.tx_info.signer_paths;
+    // large enough for either format, r || s is shorter than a DER signature with its length
+    uint8_t resp[1 + MAX_SIGNER_PATHS * (1 + 1 + MAX_DER_SIG_LEN) + TX_HASH_LEN] = {0};
+    size_t len = 0;
+
+    resp[len++] = signer_paths->count;
+    for (uint8_t i = 0; i < signer_paths->count; i++) {
+        resp[len++] = signer_paths->signer_indexes[i];
+
+        if (G_context.tx_info.raw_signature) {
+            if (!der_signature_to_rs(signer_paths->signatures[i], signer_paths->signature_lens[i], resp + len)) {
+                return io_send_sw(SW_SIGN_FAIL);
+            }
+            len += RS_SIGNATURE_LEN;
+        } else {
+            resp[len++] = signer_paths->signature_lens[i];
+            memmove(resp + len, signer_paths->signatures[i], signer_paths->signature_lens[i]);
+            len += signer_paths->signature_lens[i];
+        }
+    }
+
+    if (G_context.tx_info.raw_signature) {
+        memmove(resp + len, G_context.tx_info.hash, TX_HASH_LEN);
+        len += TX_HASH_LEN;
+    }
+
+    return io_send_response(&(const buffer_t){.ptr = resp, .size = len, .offset = 0}, SW_OK);
+}
+
+int helper_send_response_tx_summary(parser_status_e status, uint32_t offset) {
+    const transaction_t *tx = &G_context.tx_info.transaction;
+    uint8_t resp[TX_SUMMARY_MAX_LEN] = {0};
+    size_t len = 0;
+
+    resp[len++] = (uint8_t) status;
+    write_u32_le(resp, len, offset);
+    len += 4;
+
+    if (status != PARSING_OK) {
+        return io_send_response(&(const buffer_t){.ptr = resp, .size = len, .offset = 0}, SW_OK);
+    }
+
+    // fees are never negative after a successful parse
+    write_u64_le(resp, len, (uint64_t) tx->system_fee);
+    len += 8;
+    write_u64_le(resp, len, (uint64_t) tx->network_fee);
+    len += 8;
+
+    resp[len++] = tx->signers_size;
+    for (uint8_t i = 0; i < tx->signers_size; i++) {
+        resp[len++] = (uint8_t) tx->signers[i].scope;
+    }
+
+    if (tx->is_system_asset_transfer) {
+        resp[len++] = tx->is_neo ? TX_SUMMARY_ASSET_NEO : TX_SUMMARY_ASSET_GAS;
+        write_u64_le(resp, len, (uint64_t) tx->amount);
+        len += 8;
+        memmove(resp + len, tx->dst_address, ADDRESS_LEN);
+        len += ADDRESS_LEN;
+    } else {
+        resp[len++] = TX_SUMMARY_ASSET_NONE;
+    }
+
+    memmove(resp + len, G_context.tx_info.hash, TX_HASH_LEN);
+    len += TX_HASH_LEN;
+
+    return io_send_response(&(const buffer_t){.ptr = resp, .size = len, .offset = 0}, SW_OK);
+}
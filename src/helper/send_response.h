@@ -1,12 +1,114 @@
 #pragma once
 
+#include <stdint.h>  // uint*_t
+
 #include "os.h"
 
 #include "../common/macros.h"
+#include "../common/der.h"
+#include "../transaction/types.h"
+#include "../transaction/tx_hash.h"
 
 /**
  * Length of public key.
  */
 #define PUBKEY_LEN 64
 
-int helper_send_response_pubkey(void);
\ No newline at end of file
+/**
+ * Send the public key in G_context.raw_public_key in the format of G_context.pubkey_format:
+ * uncompressed, compressed, script hash or address.
+ *
+ * @return zero or positive integer if success, -1 otherwise.
+ *
+ */
+int helper_send_response_pubkey(void);
+
+/**
+ * Helper to send APDU response with the account extended public key.
+ *
+ * response = public_key (33) ||
+ *            chain_code (32)
+ *
+ * @see G_context.xpub.
+ *
+ * @return zero or positive integer if success, -1 otherwise.
+ *
+ */
+int helper_send_response_xpub(void);
+
+/**
+ * Helper to send APDU response with the script hash and address of a multi signature account.
+ *
+ * response = script_hash (20) ||
+ *            address (34)
+ *
+ * @see G_context.multisig.
+ *
+ * @return zero or positive integer if success, -1 otherwise.
+ *
+ */
+int helper_send_response_multisig(void);
+
+/**
+ * Helper to send APDU response with the signatures of a multi signer SIGN_TX.
+ *
+ * response = count (1) ||
+ *            for each signature: signer index (1) || len(signature) (1) || signature (len)
+ *
+ * In raw signature format each signature is r || s (RS_SIGNATURE_LEN) without length,
+ * followed by the transaction hash (TX_HASH_LEN) once after all signatures.
+ *
+ * @see G_context.tx_info.signer_paths.
+ *
+ * @return zero or positive integer if success, -1 otherwise.
+ *
+ */
+int helper_send_response_sigs(void);
+
+/**
+ * Length of the SIGN_TX response in raw signature format: r || s (RS_SIGNATURE_LEN) || transaction hash (TX_HASH_LEN).
+ */
+#define RAW_SIG_RESPONSE_LEN (RS_SIGNATURE_LEN + TX_HASH_LEN)
+
+/**
+ * Send the signature of G_context.tx_info. Either as ASN.1 DER, or as r || s followed by the transaction
+ * hash when G_context.tx_info.raw_signature is set.
+ *
+ * @return zero or positive integer if success, -1 otherwise.
+ *
+ */
+int helper_send_response_sig(void);
+
+/**
+ * Maximum length of the PARSE_TX summary.
+ * status (1) || offset (4) || system fee (8) || network fee (8) || signers count (1) || scopes (MAX_TX_SIGNERS) ||
+ * asset (1) || amount (8) || destination address (ADDRESS_LEN) || transaction hash (TX_HASH_LEN)
+ */
+#define TX_SUMMARY_MAX_LEN (1 + 4 + 8 + 8 + 1 + MAX_TX_SIGNERS + 1 + 8 + ADDRESS_LEN + TX_HASH_LEN)
+
+/**
+ * Summary asset for a script that is not a NEO or GAS transfer.
+ */
+#define TX_SUMMARY_ASSET_NONE 0x00
+/**
+ * Summary asset for a NEO transfer.
+ */
+#define TX_SUMMARY_ASSET_NEO 0x01
+/**
+ * Summary asset for a GAS transfer.
+ */
+#define TX_SUMMARY_ASSET_GAS 0x02
+
+/**
+ * Send the summary of the transaction parsed in G_context.tx_info. Only status and offset are sent
+ * when the transaction failed to parse.
+ *
+ * @param[in] status
+ *   Result of the transaction parser.
+ * @param[in] offset
+ *   Offset of the field that failed to parse, or length of the transaction if parsing succeeded.
+ *
+ * @return zero or positive integer if success, -1 otherwise.
+ *
+ */
+int helper_send_response_tx_summary(parser_status_e status, uint32_t offset);
\ No newline at end of file
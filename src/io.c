@@ -23,6 +23,7 @@
 #include "io.h"
 #include "globals.h"
 #include "sw.h"
+#include "crypto.h"
 #include "common/buffer.h"
 #include "common/write.h"
 
@@ -48,6 +49,11 @@ uint8_t io_event(uint8_t channel) {
             UX_DISPLAYED_EVENT({});
             break;
         case SEPROXYHAL_TAG_TICKER_EVENT:
+            // the device locked itself, keys derived from the seed must not stay in RAM meanwhile
+            if ((G_account_node.valid || G_seed_fingerprint.valid || G_signing_key.valid || G_pubkey_cache.uses != 0) &&
+                os_global_pin_is_validated() != BOLOS_TRUE) {
+                crypto_clear_seed_cache();
+            }
             UX_TICKER_EVENT(G_io_seproxyhal_spi_buffer, {});
             break;
         default:
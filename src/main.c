@@ -25,6 +25,7 @@
 #include "globals.h"
 #include "io.h"
 #include "sw.h"
+#include "crypto.h"
 #include "ui/menu.h"
 #include "apdu/parser.h"
 #include "apdu/dispatcher.h"
@@ -34,6 +35,13 @@ io_state_e G_io_state;
 ux_state_t G_ux;
 bolos_ux_params_t G_ux_params;
 global_ctx_t G_context;
+policy_t G_policy;
+sig_cache_t G_sig_cache;
+account_node_t G_account_node;
+seed_fingerprint_t G_seed_fingerprint;
+signing_key_t G_signing_key;
+pubkey_cache_t G_pubkey_cache;
+const internal_storage_t N_storage_real;
 
 /**
  * Handle APDU command received and send back APDU response using handlers.
@@ -50,6 +58,12 @@ void app_main() {
 
     // Reset context
     explicit_bzero(&G_context, sizeof(G_context));
+    explicit_bzero(&G_policy, sizeof(G_policy));
+    explicit_bzero(&G_sig_cache, sizeof(G_sig_cache));
+    explicit_bzero(&G_account_node, sizeof(G_account_node));
+    explicit_bzero(&G_seed_fingerprint, sizeof(G_seed_fingerprint));
+    explicit_bzero(&G_signing_key, sizeof(G_signing_key));
+    explicit_bzero(&G_pubkey_cache, sizeof(G_pubkey_cache));
 
     for (;;) {
         BEGIN_TRY {
@@ -78,6 +92,9 @@ void app_main() {
                        cmd.lc,
                        cmd.data);
 
+                // A key prepared for a review is not used across commands
+                crypto_clear_signing_key();
+
                 // Dispatch structured APDU command to handler
                 if (apdu_dispatcher(&cmd) < 0) {
                     return;
@@ -100,6 +117,11 @@ void app_main() {
  * Exit the application and go back to the dashboard.
  */
 void app_exit() {
+    // don't leave key material of the account behind
+    explicit_bzero(&G_account_node, sizeof(G_account_node));
+    explicit_bzero(&G_seed_fingerprint, sizeof(G_seed_fingerprint));
+    crypto_clear_signing_key();
+
     BEGIN_TRY_L(exit) {
         TRY_L(exit) {
             os_sched_exit(-1);
@@ -118,6 +140,16 @@ __attribute__((section(".boot"))) int main() {
 
     os_boot();
 
+    // First start after install, the storage is all zeros but make the defaults explicit. The fields are
+    // written one by one, a copy of the whole storage (public key store included) does not fit on the stack.
+    if (N_storage.initialized != 0x01) {
+        uint8_t value = 0x00;
+        nvm_write((void *) &N_storage.pubkey_store_enabled, &value, sizeof(value));
+        pubkey_store_clear(N_pubkey_store);
+        value = 0x01;
+        nvm_write((void *) &N_storage.initialized, &value, sizeof(value));
+    }
+
     for (;;) {
         // Reset UI
         memset(&G_ux, 0, sizeof(G_ux));
@@ -48,6 +48,30 @@
  * Status word for signing failure.
  */
 #define SW_SIGN_FAIL 0xB005
+/**
+ * Status word for a batch that already holds MAX_BATCH_TX transactions.
+ */
+#define SW_BATCH_FULL 0xB006
+/**
+ * Status word for a transaction that can't be part of a batch (not a NEO or GAS transfer, or totals overflow).
+ */
+#define SW_BATCH_TX_NOT_SUPPORTED 0xB007
+/**
+ * Status word for a spending policy with an unknown asset or without any transaction allowed.
+ */
+#define SW_INVALID_POLICY 0xB008
+/**
+ * Status word for a transaction that is not in the signature cache.
+ */
+#define SW_SIGNATURE_NOT_FOUND 0xB009
+/**
+ * Status word for a multi signature account with invalid m or n, an invalid public key or a duplicate public key.
+ */
+#define SW_INVALID_MULTISIG 0xB00A
+/**
+ * Status word for a BIP44 path whose account is not a signer of the transaction, or of the same signer as another path.
+ */
+#define SW_SIGNER_NOT_FOUND 0xB00B
 /**
  * Status word for invalid BIP44 purpose field
  */
@@ -15,165 +15,657 @@
  *  limitations under the License.
  *****************************************************************************/
 
+#include <string.h>  // memcpy, memcmp
+
 #include "deserialize.h"
 #include "types.h"
 #include "constants.h"
 #include "../common/buffer.h"
-#include "stdlib.h"
+#include "../common/read.h"
+#include "../common/write.h"
+#include "../common/varint.h"
+#include "tx_hash.h"
 #include "tx_utils.h"
 
-parser_status_e transaction_deserialize(buffer_t *buf, transaction_t *tx) {
-    if (buf->size > MAX_TRANSACTION_LEN) {
-        return INVALID_LENGTH_ERROR;
+/**
+ * Take the next 'len' bytes of the current field from 'chunk'.
+ * A field that straddles two chunks is collected in 'parser->pending' until it is complete.
+ *
+ * @return true and set 'out' to the field bytes if complete, false if more data is needed.
+ */
+static bool parser_take(tx_parser_t *parser, buffer_t *chunk, size_t len, const uint8_t **out) {
+    if (parser->pending_len == 0) {
+        parser->field_offset = parser->offset;
     }
 
-    // This can actually never fail because 'buf' would contain the tx data send in the 3rd apdu.
-    // If the 3rd apdu has no data, it will fail in the dispatcher.
-    // Leaving it just in case code might change in the future. Better safe than sorrow
-    if (!buffer_read_u8(buf, &tx->version)) {
-        return VERSION_PARSING_ERROR;
+    if (parser->pending_len == 0 && (*out = buffer_view(chunk, len)) != NULL) {
+        // fast path, the field is entirely in this chunk
+        parser->offset += len;
+        return true;
     }
 
-    if (tx->version > 0) {
-        return VERSION_VALUE_ERROR;
+    size_t n;
+    const uint8_t *part = buffer_view_at_most(chunk, len - parser->pending_len, &n);
+
+    memcpy(parser->pending + parser->pending_len, part, n);
+    parser->pending_len += n;
+    parser->offset += n;
+
+    if (parser->pending_len < len) {
+        return false;
+    }
+
+    parser->pending_len = 0;
+    *out = parser->pending;
+    return true;
+}
+
+/**
+ * Take a varint from 'chunk', the prefix and the value may be split over two chunks.
+ *
+ * @return true and set 'value' if complete, false if more data is needed.
+ */
+static bool parser_take_varint(tx_parser_t *parser, buffer_t *chunk, uint64_t *value) {
+    uint8_t prefix;
+    if (parser->pending_len > 0) {
+        prefix = parser->pending[0];
+    } else if (buffer_can_read(chunk, 1)) {
+        prefix = chunk->ptr[chunk->offset];
+    } else {
+        return false;
     }
 
-    if (!buffer_read_u32(buf, &tx->nonce, LE)) {
-        return NONCE_PARSING_ERROR;
+    size_t len = (prefix == 0xFD) ? 3 : (prefix == 0xFE) ? 5 : (prefix == 0xFF) ? 9 : 1;
+
+    const uint8_t *data;
+    if (!parser_take(parser, chunk, len, &data)) {
+        return false;
     }
 
-    if (!buffer_read_s64(buf, &tx->system_fee, LE)) {
-        return SYSTEM_FEE_PARSING_ERROR;
+    // can't fail, 'data' holds exactly the amount of bytes indicated by the prefix
+    varint_read(data, len, value);
+    return true;
+}
+
+/**
+ * Transaction layout generated from TX_PARSER_STEPS, indexed by step.
+ */
+static const struct {
+    uint8_t width;            // bytes read before the step runs, or TX_FIELD_VARINT / TX_FIELD_CUSTOM
+    int8_t truncated_status;  // parser_status_e reported when the transaction ends at this step
+} tx_fields[] = {
+#define X(step, width, truncated_status) [step] = {width, truncated_status},
+    TX_PARSER_STEPS(X)
+#undef X
+};
+
+static void parser_next_signer(tx_parser_t *parser, transaction_t *tx) {
+    parser->index++;
+    parser->step = (parser->index < tx->signers_size) ? TX_STEP_SIGNER_ACCOUNT : TX_STEP_ATTRIBUTES_LENGTH;
+}
+
+/**
+ * Check that 'len' more bytes of the current signer fit in 'tx->signers_data', while keeping room for the accounts
+ * of the signers that follow.
+ */
+static bool signers_data_fits(const tx_parser_t *parser, const transaction_t *tx, uint64_t len) {
+    size_t next_accounts_len = (size_t) (tx->signers_size - parser->index - 1) * UINT160_LEN;
+    return len <= MAX_SIGNERS_DATA_LEN - tx->signers_data_len - next_accounts_len;
+}
+
+/**
+ * Check whether 'account' is the account of one of the signers parsed so far.
+ * The first byte bitmap rules out most accounts without comparing them.
+ */
+static bool signer_account_seen(const tx_parser_t *parser, const transaction_t *tx, const uint8_t *account) {
+    if ((parser->account_first_bytes[account[0] / 8] & (1 << (account[0] % 8))) == 0) {
+        return false;
     }
-    if (tx->system_fee < 0) {
-        return SYSTEM_FEE_VALUE_ERROR;
+
+    for (uint8_t s = 0; s < parser->index; s++) {
+        if (memcmp(transaction_signer_account(tx, s), account, UINT160_LEN) == 0) {
+            return true;
+        }
     }
 
-    if (!buffer_read_s64(buf, &tx->network_fee, LE)) {
-        return NETWORK_FEE_PARSING_ERROR;
+    return false;
+}
+
+static void parser_after_groups(tx_parser_t *parser, transaction_t *tx) {
+    if ((tx->signers[parser->index].scope & WITNESS_RULES) == WITNESS_RULES) {
+        parser->step = TX_STEP_SIGNER_RULES_LENGTH;
+    } else {
+        parser_next_signer(parser, tx);
     }
+}
 
-    if (tx->network_fee < 0) {
-        return NETWORK_FEE_VALUE_ERROR;
+static void parser_after_contracts(tx_parser_t *parser, transaction_t *tx) {
+    if ((tx->signers[parser->index].scope & CUSTOM_GROUPS) == CUSTOM_GROUPS) {
+        parser->step = TX_STEP_SIGNER_GROUPS_LENGTH;
+    } else {
+        parser_after_groups(parser, tx);
     }
+}
 
-    if (!buffer_read_u32(buf, &tx->valid_until_block, LE)) {
-        return VALID_UNTIL_BLOCK_PARSING_ERROR;
+/**
+ * Length of the data following the kind byte of a witness condition, 0 for an unknown condition type.
+ */
+static size_t condition_data_len(uint8_t type) {
+    switch (type) {
+        case CONDITION_BOOLEAN:
+            return 1;
+        case CONDITION_SCRIPT_HASH:
+        case CONDITION_CALLED_BY_CONTRACT:
+            return UINT160_LEN;
+        case CONDITION_GROUP:
+        case CONDITION_CALLED_BY_GROUP:
+            return ECPOINT_LEN;
+        default:
+            return 0;
     }
+}
 
-    // Parse (Co)Signers
-    uint64_t signer_length;
-    if (!buffer_read_varint(buf, &signer_length)) {
-        return SIGNER_LENGTH_PARSING_ERROR;
+/**
+ * Append an item of 'len' bytes to the witness rules of the current signer.
+ *
+ * @return false if the item doesn't fit in 'tx->signers_data'.
+ */
+static bool parser_store_rule_item(tx_parser_t *parser, transaction_t *tx, const uint8_t *item, size_t len) {
+    if (!signers_data_fits(parser, tx, len)) {
+        return false;
     }
-    if (signer_length < MIN_TX_SIGNERS || signer_length > MAX_TX_SIGNERS) {
-        return SIGNER_LENGTH_VALUE_ERROR;
+
+    memcpy(tx->signers_data + tx->signers_data_len, item, len);
+    tx->signers_data_len += len;
+    return true;
+}
+
+/**
+ * Open an And, Or or Not condition of 'count' sub-conditions.
+ *
+ * @return false if the conditions are nested too deep.
+ */
+static bool parser_push_condition(tx_parser_t *parser, uint8_t count) {
+    if (parser->condition_depth == MAX_WITNESS_CONDITION_NESTING) {
+        return false;
     }
 
-    tx->signers_size = (uint8_t) signer_length;
-    for (int i = 0; i < tx->signers_size; i++) {
-        tx->signers[i].account = (uint8_t *) (buf->ptr + buf->offset);
-        if (!buffer_seek_cur(buf, UINT160_LEN)) {
-            return SIGNER_ACCOUNT_PARSING_ERROR;
+    parser->condition_stack[parser->condition_depth++] = count;
+    parser->step = TX_STEP_SIGNER_RULE_CONDITION;
+    return true;
+}
+
+/**
+ * A condition is complete, close the And, Or and Not conditions it completes and move on to the next
+ * sub-condition, rule or signer.
+ */
+static void parser_after_condition(tx_parser_t *parser, transaction_t *tx) {
+    while (parser->condition_depth > 0) {
+        if (--parser->condition_stack[parser->condition_depth - 1] > 0) {
+            parser->step = TX_STEP_SIGNER_RULE_CONDITION;
+            return;
         }
+        parser->condition_depth--;
+    }
+
+    if (++parser->sub_index < tx->signers[parser->index].rules_size) {
+        parser->step = TX_STEP_SIGNER_RULE_ACTION;
+    } else {
+        parser_next_signer(parser, tx);
+    }
+}
+
+/**
+ * Length of the data of an attribute in the transaction, the result of an OracleResponse excluded.
+ */
+static size_t attribute_data_len(uint8_t type) {
+    switch (type) {
+        case ORACLE_RESPONSE:
+            return 8 + 1;  // id, code
+        case NOT_VALID_BEFORE:
+            return 4;  // height
+        case CONFLICTS:
+            return UINT256_LEN;  // transaction hash
+        case NOTARY_ASSISTED:
+            return 1;  // keys count
+        default:
+            return 0;
+    }
+}
+
+static bool oracle_response_code_valid(uint8_t code) {
+    switch (code) {
+        case ORACLE_SUCCESS:
+        case ORACLE_PROTOCOL_NOT_SUPPORTED:
+        case ORACLE_CONSENSUS_UNREACHABLE:
+        case ORACLE_NOT_FOUND:
+        case ORACLE_TIMEOUT:
+        case ORACLE_FORBIDDEN:
+        case ORACLE_RESPONSE_TOO_LARGE:
+        case ORACLE_INSUFFICIENT_FUNDS:
+        case ORACLE_CONTENT_TYPE_NOT_SUPPORTED:
+        case ORACLE_ERROR:
+            return true;
+        default:
+            return false;
+    }
+}
+
+static void parser_next_attribute(tx_parser_t *parser, transaction_t *tx) {
+    parser->index++;
+    parser->step = (parser->index < tx->attributes_size) ? TX_STEP_ATTRIBUTE : TX_STEP_SCRIPT_LENGTH;
+}
 
-        // Check that the signer is unique by comparing its account property vs existing accounts
-        // 'i' determines how many signers (and thus accounts) have been added so far.
-        for (int s = 0; s < i; s++) {
-            if (!os_secure_memcmp(tx->signers[s].account, tx->signers[i].account, UINT160_LEN)) {
-                return SIGNER_ACCOUNT_DUPLICATE_ERROR;
+void transaction_parser_init(tx_parser_t *parser, transaction_t *tx) {
+    memset(parser, 0, sizeof(*parser));
+    memset(tx, 0, sizeof(*tx));
+    parser->step = TX_STEP_VERSION;
+}
+
+void transaction_parser_allow_large_script(tx_parser_t *parser) {
+    parser->large_script = true;
+    transaction_hash_init(&parser->script_hash);
+}
+
+parser_status_e transaction_parser_feed(tx_parser_t *parser, transaction_t *tx, buffer_t *chunk) {
+    if (!parser->large_script && parser->offset + (chunk->size - chunk->offset) > MAX_TRANSACTION_LEN) {
+        return INVALID_LENGTH_ERROR;
+    }
+
+    const uint8_t *data = NULL;
+    uint64_t value = 0;
+
+    while (parser->step != TX_STEP_DONE) {
+        // read the field of the step from the layout table, steps of custom width read their own data
+        uint8_t width = tx_fields[parser->step].width;
+        if (width == TX_FIELD_VARINT) {
+            if (!parser_take_varint(parser, chunk, &value)) {
+                return PARSING_OK;
             }
+        } else if (width != TX_FIELD_CUSTOM && !parser_take(parser, chunk, width, &data)) {
+            return PARSING_OK;
         }
 
-        uint8_t value;
-        if (!buffer_read_u8(buf, &value)) {
-            return SIGNER_SCOPE_PARSING_ERROR;
-        }
-        tx->signers[i].scope = (witness_scope_e) value;
+        switch (parser->step) {
+            case TX_STEP_VERSION:
+                tx->version = data[0];
+                if (tx->version > 0) {
+                    return VERSION_VALUE_ERROR;
+                }
+                parser->step = TX_STEP_NONCE;
+                break;
 
-        // Scope GLOBAL is not allowed to have other flags
-        if ((((witness_scope_e) value & GLOBAL) == GLOBAL) && ((witness_scope_e) value != GLOBAL)) {
-            return SIGNER_SCOPE_VALUE_ERROR_GLOBAL_FLAG;
-        }
+            case TX_STEP_NONCE:
+                tx->nonce = read_u32_le(data, 0);
+                parser->step = TX_STEP_SYSTEM_FEE;
+                break;
 
-        uint64_t var_int_length;
-        if (((witness_scope_e) value & CUSTOM_CONTRACTS) == CUSTOM_CONTRACTS) {
-            if (!buffer_read_varint(buf, &var_int_length)) {
-                return SIGNER_ALLOWED_CONTRACTS_LENGTH_PARSING_ERROR;
-            }
-            if (var_int_length > MAX_SIGNER_SUB_ITEMS) {
-                return SIGNER_ALLOWED_CONTRACTS_LENGTH_VALUE_ERROR;
+            case TX_STEP_SYSTEM_FEE:
+                tx->system_fee = read_s64_le(data, 0);
+                if (tx->system_fee < 0) {
+                    return SYSTEM_FEE_VALUE_ERROR;
+                }
+                parser->step = TX_STEP_NETWORK_FEE;
+                break;
+
+            case TX_STEP_NETWORK_FEE:
+                tx->network_fee = read_s64_le(data, 0);
+                if (tx->network_fee < 0) {
+                    return NETWORK_FEE_VALUE_ERROR;
+                }
+                parser->step = TX_STEP_VALID_UNTIL_BLOCK;
+                break;
+
+            case TX_STEP_VALID_UNTIL_BLOCK:
+                tx->valid_until_block = read_u32_le(data, 0);
+                parser->step = TX_STEP_SIGNERS_LENGTH;
+                break;
+
+            // Parse (Co)Signers
+            case TX_STEP_SIGNERS_LENGTH:
+                if (value < MIN_TX_SIGNERS || value > MAX_TX_SIGNERS) {
+                    return SIGNER_LENGTH_VALUE_ERROR;
+                }
+                tx->signers_size = (uint8_t) value;
+                parser->index = 0;
+                parser->step = TX_STEP_SIGNER_ACCOUNT;
+                break;
+
+            case TX_STEP_SIGNER_ACCOUNT:
+                // Check that the signer is unique by comparing its account property vs existing accounts
+                if (signer_account_seen(parser, tx, data)) {
+                    return SIGNER_ACCOUNT_DUPLICATE_ERROR;
+                }
+                parser->account_first_bytes[data[0] / 8] |= 1 << (data[0] % 8);
+                // room for the account was kept by the signers before it, see signers_data_fits()
+                tx->signers[parser->index].offset = tx->signers_data_len;
+                memcpy(tx->signers_data + tx->signers_data_len, data, UINT160_LEN);
+                tx->signers_data_len += UINT160_LEN;
+                parser->step = TX_STEP_SIGNER_SCOPE;
+                break;
+
+            case TX_STEP_SIGNER_SCOPE:
+                tx->signers[parser->index].scope = data[0];
+
+                // Scope GLOBAL is not allowed to have other flags
+                if (((data[0] & GLOBAL) == GLOBAL) && (data[0] != GLOBAL)) {
+                    return SIGNER_SCOPE_VALUE_ERROR_GLOBAL_FLAG;
+                }
+
+                if ((data[0] & CUSTOM_CONTRACTS) == CUSTOM_CONTRACTS) {
+                    parser->step = TX_STEP_SIGNER_CONTRACTS_LENGTH;
+                } else {
+                    parser_after_contracts(parser, tx);
+                }
+                break;
+
+            case TX_STEP_SIGNER_CONTRACTS_LENGTH:
+                if (value > MAX_SIGNER_SUB_ITEMS || !signers_data_fits(parser, tx, value * UINT160_LEN)) {
+                    return SIGNER_ALLOWED_CONTRACTS_LENGTH_VALUE_ERROR;
+                }
+                tx->signers[parser->index].allowed_contracts_size = (uint8_t) value;
+                parser->sub_index = 0;
+                if (value > 0) {
+                    parser->step = TX_STEP_SIGNER_CONTRACT;
+                } else {
+                    parser_after_contracts(parser, tx);
+                }
+                break;
+
+            case TX_STEP_SIGNER_CONTRACT:
+                memcpy(tx->signers_data + tx->signers_data_len, data, UINT160_LEN);
+                tx->signers_data_len += UINT160_LEN;
+                if (++parser->sub_index == tx->signers[parser->index].allowed_contracts_size) {
+                    parser_after_contracts(parser, tx);
+                }
+                break;
+
+            case TX_STEP_SIGNER_GROUPS_LENGTH:
+                if (value > MAX_SIGNER_SUB_ITEMS || !signers_data_fits(parser, tx, value * ECPOINT_LEN)) {
+                    return SIGNER_ALLOWED_GROUPS_LENGTH_VALUE_ERROR;
+                }
+                tx->signers[parser->index].allowed_groups_size = (uint8_t) value;
+                parser->sub_index = 0;
+                if (value > 0) {
+                    parser->step = TX_STEP_SIGNER_GROUP;
+                } else {
+                    parser_after_groups(parser, tx);
+                }
+                break;
+
+            case TX_STEP_SIGNER_GROUP:
+                memcpy(tx->signers_data + tx->signers_data_len, data, ECPOINT_LEN);
+                tx->signers_data_len += ECPOINT_LEN;
+                if (++parser->sub_index == tx->signers[parser->index].allowed_groups_size) {
+                    parser_after_groups(parser, tx);
+                }
+                break;
+
+            case TX_STEP_SIGNER_RULES_LENGTH:
+                if (value > MAX_SIGNER_SUB_ITEMS) {
+                    return SIGNER_RULES_LENGTH_VALUE_ERROR;
+                }
+                tx->signers[parser->index].rules_size = (uint8_t) value;
+                parser->sub_index = 0;
+                if (value > 0) {
+                    parser->step = TX_STEP_SIGNER_RULE_ACTION;
+                } else {
+                    parser_next_signer(parser, tx);
+                }
+                break;
+
+            case TX_STEP_SIGNER_RULE_ACTION:
+                if (data[0] != WITNESS_RULE_DENY && data[0] != WITNESS_RULE_ALLOW) {
+                    return SIGNER_RULE_VALUE_ERROR;
+                }
+                if (!parser_store_rule_item(parser, tx, data, 1)) {
+                    return SIGNER_RULES_LENGTH_VALUE_ERROR;
+                }
+                tx->signers[parser->index].rule_items_size++;
+                parser->condition_depth = 0;
+                parser->step = TX_STEP_SIGNER_RULE_CONDITION;
+                break;
+
+            case TX_STEP_SIGNER_RULE_CONDITION: {
+                parser->condition_type = data[0];
+
+                // the data of the condition (if any) is stored right after its kind byte, see below
+                uint8_t kind = (uint8_t) ((parser->condition_depth + 1) << 6) | data[0];
+                size_t data_len = condition_data_len(data[0]);
+                if (data[0] == CONDITION_AND || data[0] == CONDITION_OR) {
+                    data_len = 1;  // sub-condition count
+                } else if (data_len == 0 && data[0] != CONDITION_NOT && data[0] != CONDITION_CALLED_BY_ENTRY) {
+                    return SIGNER_RULE_VALUE_ERROR;
+                }
+                // room for the data is checked now, so it can be stored without checks once received
+                if (!signers_data_fits(parser, tx, 1 + data_len) || !parser_store_rule_item(parser, tx, &kind, 1)) {
+                    return SIGNER_RULES_LENGTH_VALUE_ERROR;
+                }
+                tx->signers[parser->index].rule_items_size++;
+
+                if (data[0] == CONDITION_AND || data[0] == CONDITION_OR) {
+                    parser->step = TX_STEP_SIGNER_RULE_CONDITION_COUNT;
+                } else if (data[0] == CONDITION_NOT) {
+                    if (!parser_push_condition(parser, 1)) {
+                        return SIGNER_RULE_VALUE_ERROR;
+                    }
+                } else if (data_len > 0) {
+                    parser->step = TX_STEP_SIGNER_RULE_CONDITION_DATA;
+                } else {
+                    parser_after_condition(parser, tx);
+                }
+                break;
             }
-            tx->signers[i].allowed_contracts_size = var_int_length;
-            for (size_t j = 0; j < var_int_length; j++) {
-                tx->signers[i].allowed_contracts[j] = (uint8_t *) (buf->ptr + buf->offset);
-                if (!buffer_seek_cur(buf, UINT160_LEN)) {
-                    return SIGNER_ALLOWED_CONTRACT_PARSING_ERROR;
+
+            case TX_STEP_SIGNER_RULE_CONDITION_COUNT: {
+                if (value == 0 || value > MAX_SIGNER_SUB_ITEMS) {
+                    return SIGNER_RULE_VALUE_ERROR;
                 }
+                uint8_t count = (uint8_t) value;
+                parser_store_rule_item(parser, tx, &count, 1);
+                if (!parser_push_condition(parser, count)) {
+                    return SIGNER_RULE_VALUE_ERROR;
+                }
+                break;
             }
-        }
 
-        var_int_length = 0;
-        if (((witness_scope_e) value & CUSTOM_GROUPS) == CUSTOM_GROUPS) {
-            if (!buffer_read_varint(buf, &var_int_length)) {
-                return SIGNER_ALLOWED_GROUPS_LENGTH_PARSING_ERROR;
+            case TX_STEP_SIGNER_RULE_CONDITION_DATA: {
+                size_t data_len = condition_data_len(parser->condition_type);
+                if (!parser_take(parser, chunk, data_len, &data)) {
+                    return PARSING_OK;
+                }
+                if (parser->condition_type == CONDITION_BOOLEAN && data[0] > 1) {
+                    return SIGNER_RULE_VALUE_ERROR;
+                }
+                parser_store_rule_item(parser, tx, data, data_len);
+                parser_after_condition(parser, tx);
+                break;
             }
-            if (var_int_length > MAX_SIGNER_SUB_ITEMS) {
-                return SIGNER_ALLOWED_GROUPS_LENGTH_VALUE_ERROR;
+
+            // Parse transaction attributes
+            case TX_STEP_ATTRIBUTES_LENGTH:
+                // signers and attributes share the same limit on the network
+                if (value > (uint64_t) (MAX_ATTRIBUTES - tx->signers_size)) {
+                    return ATTRIBUTES_LENGTH_VALUE_ERROR;
+                }
+                tx->attributes_size = (uint8_t) value;
+                parser->index = 0;
+                parser->step = (value > 0) ? TX_STEP_ATTRIBUTE : TX_STEP_SCRIPT_LENGTH;
+                break;
+
+            case TX_STEP_ATTRIBUTE: {
+                if (data[0] != HIGH_PRIORITY && data[0] != ORACLE_RESPONSE && data[0] != NOT_VALID_BEFORE &&
+                    data[0] != CONFLICTS && data[0] != NOTARY_ASSISTED) {
+                    return ATTRIBUTES_UNSUPPORTED_TYPE;
+                }
+                // check for duplicates, only Conflicts may be attached more than once
+                uint8_t conflicts = 0;
+                for (int j = 0; j < parser->index; j++) {
+                    if (tx->attributes[j].type == CONFLICTS) {
+                        conflicts++;
+                    } else if (tx->attributes[j].type == data[0]) {
+                        return ATTRIBUTES_DUPLICATE_TYPE;
+                    }
+                }
+                if (data[0] == CONFLICTS && conflicts == MAX_CONFLICTS) {
+                    return ATTRIBUTES_LENGTH_VALUE_ERROR;
+                }
+                // the pool fits the data of each attribute type and MAX_CONFLICTS hashes
+                tx->attributes[parser->index] = (attribute_t){.type = data[0], .offset = tx->attributes_data_len};
+                if (attribute_data_len(data[0]) > 0) {
+                    parser->step = TX_STEP_ATTRIBUTE_DATA;
+                } else {
+                    parser_next_attribute(parser, tx);
+                }
+                break;
             }
-            tx->signers[i].allowed_groups_size = var_int_length;
-            for (size_t j = 0; j < var_int_length; j++) {
-                tx->signers[i].allowed_groups[j] = (uint8_t *) (buf->ptr + buf->offset);
-                if (!buffer_seek_cur(buf, ECPOINT_LEN)) {
-                    return SIGNER_ALLOWED_CONTRACT_PARSING_ERROR;
+
+            case TX_STEP_ATTRIBUTE_DATA: {
+                const attribute_t *attribute = &tx->attributes[parser->index];
+                size_t data_len = attribute_data_len(attribute->type);
+                if (!parser_take(parser, chunk, data_len, &data)) {
+                    return PARSING_OK;
+                }
+                memcpy(tx->attributes_data + tx->attributes_data_len, data, data_len);
+                tx->attributes_data_len += data_len;
+                if (attribute->type != ORACLE_RESPONSE) {
+                    parser_next_attribute(parser, tx);
+                } else if (!oracle_response_code_valid(data[8])) {
+                    return ATTRIBUTE_DATA_VALUE_ERROR;
+                } else {
+                    parser->step = TX_STEP_ORACLE_RESULT_LENGTH;
                 }
+                break;
             }
-        }
-    }
 
-    // Parse transaction attributes
-    uint64_t attributes_length;
-    if (!buffer_read_varint(buf, &attributes_length)) {
-        return ATTRIBUTES_LENGTH_PARSING_ERROR;
-    }
-    // The actual network does (MAX_TX_SIGNERS (16) - signer length) but due to memory constraints we lowered the
-    // MAX_ATTRIBUTES and hardcode the attributes limit to 2
-    if (attributes_length > MAX_ATTRIBUTES || attributes_length > 2) {
-        return ATTRIBUTES_LENGTH_VALUE_ERROR;
-    }
-    tx->attributes_size = (uint8_t) attributes_length;
+            case TX_STEP_ORACLE_RESULT_LENGTH: {
+                // only a successful response has a result
+                uint8_t code = tx->attributes_data[tx->attributes[parser->index].offset + 8];
+                if (value > 0xFFFF || (code != ORACLE_SUCCESS && value > 0)) {
+                    return ATTRIBUTE_DATA_VALUE_ERROR;
+                }
+                // the result is not kept, only its length and where it is in the transaction
+                write_u16_le(tx->attributes_data, tx->attributes_data_len, (uint16_t) value);
+                write_u32_le(tx->attributes_data, tx->attributes_data_len + 2, parser->offset);
+                tx->attributes_data_len += 6;
+                parser->oracle_result_remaining = (uint16_t) value;
+                if (value > 0) {
+                    parser->step = TX_STEP_ORACLE_RESULT;
+                } else {
+                    parser_next_attribute(parser, tx);
+                }
+                break;
+            }
 
-    if (tx->attributes_size > 0) {
-        for (int i = 0; i < tx->attributes_size; i++) {
-            uint8_t attribute_type;
-            if (!buffer_read_u8(buf, &attribute_type) || attribute_type != HIGH_PRIORITY) {
-                return ATTRIBUTES_UNSUPPORTED_TYPE;
+            case TX_STEP_ORACLE_RESULT: {
+                size_t n;
+                buffer_view_at_most(chunk, parser->oracle_result_remaining, &n);
+                parser->offset += n;
+                parser->oracle_result_remaining -= n;
+                if (parser->oracle_result_remaining > 0) {
+                    return PARSING_OK;
+                }
+                parser_next_attribute(parser, tx);
+                break;
             }
-            // check for duplicates
-            for (int j = 0; j < tx->attributes_size; j++) {
-                if (tx->attributes[j].type == attribute_type) {
-                    return ATTRIBUTES_DUPLICATE_TYPE;
+
+            // Parse out script
+            case TX_STEP_SCRIPT_LENGTH:
+                if (value == 0 || value > (parser->large_script ? UINT32_MAX - parser->offset : 0xFFFF)) {
+                    return SCRIPT_LENGTH_VALUE_ERROR;
+                }
+                tx->script_size = (uint32_t) value;
+                parser->script_remaining = (uint32_t) value;
+                parser->field_offset = parser->offset;
+                parser->step = TX_STEP_SCRIPT;
+                break;
+
+            case TX_STEP_SCRIPT: {
+                size_t n;
+                const uint8_t *part = buffer_view_at_most(chunk, parser->script_remaining, &n);
+
+                // Only scripts that can be a NEO or GAS transfer are kept, other scripts are skipped
+                if (tx->script_size <= MAX_TRANSFER_SCRIPT_LEN) {
+                    memcpy(parser->script + (tx->script_size - parser->script_remaining), part, n);
+                }
+                if (parser->large_script) {
+                    buffer_t script_part = {.ptr = part, .size = n, .offset = 0};
+                    transaction_hash_update(&parser->script_hash, &script_part);
                 }
+                parser->offset += n;
+                parser->script_remaining -= n;
+
+                if (parser->script_remaining > 0) {
+                    return PARSING_OK;
+                }
+
+                // test if script is NEO or GAS transfer
+                if (tx->script_size <= MAX_TRANSFER_SCRIPT_LEN) {
+                    buffer_t script_buf = {.ptr = parser->script, .size = tx->script_size, .offset = 0};
+                    try_parse_transfer_script(&script_buf, tx);
+                }
+                if (parser->large_script) {
+                    transaction_hash_final(&parser->script_hash, tx->script_hash);
+                }
+                parser->step = TX_STEP_DONE;
+                break;
             }
-            tx->attributes[i] = (attribute_t){.type = attribute_type};
+
+            case TX_STEP_DONE:
+                break;
         }
     }
 
-    // Parse out script
-    uint64_t script_length;
-    if (!buffer_read_varint(buf, &script_length)) {
-        return SCRIPT_LENGTH_PARSING_ERROR;
-    }
+    // there should be no data after the script
+    return (chunk->offset == chunk->size) ? PARSING_OK : INVALID_LENGTH_ERROR;
+}
+
+parser_status_e transaction_parser_finish(const tx_parser_t *parser) {
+    // The transaction ended in the middle of a field, report the field that could not be read
+    return (parser_status_e) tx_fields[parser->step].truncated_status;
+}
+
+parser_status_e transaction_deserialize(buffer_t *buf, transaction_t *tx) {
+    tx_parser_t parser;
+    transaction_parser_init(&parser, tx);
 
-    tx->script = (uint8_t *) (buf->ptr + buf->offset);
-    if (script_length > 0xFFFF || script_length == 0 || !buffer_seek_cur(buf, script_length)) {
-        return SCRIPT_LENGTH_VALUE_ERROR;
+    parser_status_e status = transaction_parser_feed(&parser, tx, buf);
+    if (status != PARSING_OK) {
+        return status;
     }
-    tx->script_size = (uint16_t) script_length;
 
-    // test if script is NEO or GAS transfer
-    buffer_t scriptBuf = {.ptr = tx->script, .size = script_length, .offset = 0};
-    try_parse_transfer_script(&scriptBuf, tx);
+    return transaction_parser_finish(&parser);
+}
+
+const uint8_t *transaction_signer_account(const transaction_t *tx, uint8_t index) {
+    return tx->signers_data + tx->signers[index].offset;
+}
+
+const uint8_t *transaction_signer_contract(const transaction_t *tx, uint8_t index, uint8_t contract) {
+    return transaction_signer_account(tx, index) + UINT160_LEN + contract * UINT160_LEN;
+}
+
+const uint8_t *transaction_signer_group(const transaction_t *tx, uint8_t index, uint8_t group) {
+    const signer_t *signer = &tx->signers[index];
+    return transaction_signer_contract(tx, index, signer->allowed_contracts_size) + group * ECPOINT_LEN;
+}
+
+const uint8_t *transaction_signer_rule_item(const transaction_t *tx, uint8_t index, uint16_t item, uint8_t *rule) {
+    const uint8_t *kind = transaction_signer_group(tx, index, tx->signers[index].allowed_groups_size);
+
+    *rule = 0;
+    for (uint16_t i = 0; i < item; i++) {
+        if (WITNESS_RULE_ITEM_LEVEL(*kind) == 0) {
+            kind += 1;
+            continue;
+        }
+
+        uint8_t type = WITNESS_RULE_ITEM_TYPE(*kind);
+        kind += 1 + ((type == CONDITION_AND || type == CONDITION_OR) ? 1 : condition_data_len(type));
+        if (WITNESS_RULE_ITEM_LEVEL(*kind) == 0) {
+            (*rule)++;
+        }
+    }
 
-    return (buf->offset == buf->size) ? PARSING_OK : INVALID_LENGTH_ERROR;
+    return kind;
 }
@@ -3,6 +3,56 @@
 #include "types.h"
 #include "../common/buffer.h"
 
+/**
+ * Reset the streaming parser and the transaction structure it fills.
+ *
+ * @param[out] parser
+ *   Pointer to streaming parser state.
+ * @param[out] tx
+ *   Pointer to transaction structure.
+ *
+ */
+void transaction_parser_init(tx_parser_t *parser, transaction_t *tx);
+
+/**
+ * Accept scripts of any size after transaction_parser_init(). The 0xFFFF script length and the
+ * MAX_TRANSACTION_LEN limits are lifted, the script bytes are hashed as they stream in and the
+ * digest is stored in 'tx->script_hash' once the script is complete.
+ *
+ * @param[in, out] parser
+ *   Pointer to streaming parser state.
+ *
+ */
+void transaction_parser_allow_large_script(tx_parser_t *parser);
+
+/**
+ * Feed the next chunk of a serialized transaction to the streaming parser.
+ * Fields (including varints) may be split over chunk boundaries, only the fields
+ * needed for display are kept in the transaction structure.
+ *
+ * @param[in, out] parser
+ *   Pointer to streaming parser state.
+ * @param[out]     tx
+ *   Pointer to transaction structure.
+ * @param[in, out] chunk
+ *   Pointer to buffer with the next part of the serialized transaction.
+ *
+ * @return PARSING_OK if no error was found so far, error status otherwise.
+ *
+ */
+parser_status_e transaction_parser_feed(tx_parser_t *parser, transaction_t *tx, buffer_t *chunk);
+
+/**
+ * Check that the streaming parser received a complete transaction.
+ *
+ * @param[in] parser
+ *   Pointer to streaming parser state.
+ *
+ * @return PARSING_OK if the transaction is complete, the status of the field that could not be read otherwise.
+ *
+ */
+parser_status_e transaction_parser_finish(const tx_parser_t *parser);
+
 /**
  * Deserialize raw transaction in structure.
  *
@@ -15,3 +65,63 @@
  *
  */
 parser_status_e transaction_deserialize(buffer_t *buf, transaction_t *tx);
+
+/**
+ * Account of a parsed signer.
+ *
+ * @param[in] tx
+ *   Pointer to transaction structure.
+ * @param[in] index
+ *   Index of the signer, below tx->signers_size.
+ *
+ * @return pointer to the UInt160 account in 'tx->signers_data'.
+ *
+ */
+const uint8_t *transaction_signer_account(const transaction_t *tx, uint8_t index);
+
+/**
+ * Allowed contract of a parsed signer.
+ *
+ * @param[in] tx
+ *   Pointer to transaction structure.
+ * @param[in] index
+ *   Index of the signer, below tx->signers_size.
+ * @param[in] contract
+ *   Index of the contract, below the allowed_contracts_size of the signer.
+ *
+ * @return pointer to the UInt160 contract hash in 'tx->signers_data'.
+ *
+ */
+const uint8_t *transaction_signer_contract(const transaction_t *tx, uint8_t index, uint8_t contract);
+
+/**
+ * Allowed group of a parsed signer.
+ *
+ * @param[in] tx
+ *   Pointer to transaction structure.
+ * @param[in] index
+ *   Index of the signer, below tx->signers_size.
+ * @param[in] group
+ *   Index of the group, below the allowed_groups_size of the signer.
+ *
+ * @return pointer to the compressed ECPoint in 'tx->signers_data'.
+ *
+ */
+const uint8_t *transaction_signer_group(const transaction_t *tx, uint8_t index, uint8_t group);
+
+/**
+ * Witness rule item of a parsed signer, see WITNESS_RULE_ITEM_LEVEL() for the layout of the items.
+ *
+ * @param[in]  tx
+ *   Pointer to transaction structure.
+ * @param[in]  index
+ *   Index of the signer, below tx->signers_size.
+ * @param[in]  item
+ *   Index of the item, below the rule_items_size of the signer.
+ * @param[out] rule
+ *   Index of the rule the item belongs to.
+ *
+ * @return pointer to the kind byte of the item in 'tx->signers_data'.
+ *
+ */
+const uint8_t *transaction_signer_rule_item(const transaction_t *tx, uint8_t index, uint16_t item, uint8_t *rule);
@@ -0,0 +1,76 @@
+/*****************************************************************************
+ *   (c) 2021 COZ Inc.
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *****************************************************************************/
+
+
+#include <stdint.h>   // uint*_t
+#include <stdbool.h>  // bool
+#include <string.h>   // memcmp
+
+#include "policy.h"
+
+bool policy_allows(const policy_t *policy,
+                   const uint32_t bip44_path[static BIP44_PATH_LEN],
+                   uint32_t network_magic,
+                   const transaction_t *tx) {
+    if (!policy->active || policy->count >= policy->max_count) {
+        return false;
+    }
+
+    if (memcmp(policy->bip44_path, bip44_path, sizeof(policy->bip44_path)) != 0 ||
+        policy->network_magic != network_magic) {
+        return false;
+    }
+
+    // a single signer, the policy account, with a witness limited to the entry script: a wider scope
+    // (Global, CustomContracts, WitnessRules) would let the called contracts reuse the witness
+    if (tx->signers_size != 1 || tx->signers[0].scope != CALLED_BY_ENTRY ||
+        memcmp(tx->signers_data + tx->signers[0].offset, policy->account, UINT160_LEN) != 0) {
+        return false;
+    }
+
+    // only plain NEO or GAS transfers can be checked against the policy
+    if (!tx->is_system_asset_transfer || tx->is_neo != policy->is_neo || tx->amount < 0) {
+        return false;
+    }
+
+    if (memcmp(policy->dst_address, tx->dst_address, sizeof(policy->dst_address)) != 0) {
+        return false;
+    }
+
+    // attributes other than HighPriority change what the transaction does and need a review
+    for (uint8_t i = 0; i < tx->attributes_size; i++) {
+        if (tx->attributes[i].type != HIGH_PRIORITY) {
+            return false;
+        }
+    }
+
+    // amounts and fees are never negative (see transaction_parser_feed()), so the casts are safe
+    uint64_t amount = (uint64_t) tx->amount;
+    if (amount > policy->max_amount || amount > policy->max_total - policy->total) {
+        return false;
+    }
+
+    if ((uint64_t) tx->system_fee + (uint64_t) tx->network_fee > policy->max_fee) {
+        return false;
+    }
+
+    return tx->valid_until_block <= policy->max_valid_until_block;
+}
+
+void policy_record(policy_t *policy, const transaction_t *tx) {
+    policy->total += (uint64_t) tx->amount;
+    policy->count++;
+}
@@ -0,0 +1,58 @@
+#pragma once
+
+#include <stdint.h>   // uint*_t
+#include <stdbool.h>  // bool
+
+#include "types.h"
+#include "../constants.h"
+
+/**
+ * Spending policy approved once by the user. Transactions matching it are signed without review
+ * for the rest of the session. The policy only lives in RAM and is lost when the app exits.
+ */
+typedef struct {
+    bool active;                          // set once the user approved the policy
+    uint32_t bip44_path[BIP44_PATH_LEN];  // the only account the policy can sign for
+    uint8_t account[UINT160_LEN];         // script hash of that account, the only signer a transaction may have
+    uint32_t network_magic;               // the only network the policy can sign for
+    uint8_t dst_address[ADDRESS_LEN];     // allowed destination of the transfers
+    bool is_neo;                          // allowed asset, NEO if true, GAS otherwise
+    uint64_t max_amount;                  // maximum amount of a single transfer
+    uint64_t max_total;                   // maximum cumulative amount of all transfers
+    uint64_t max_fee;                     // maximum system + network fee of a single transaction
+    uint32_t max_valid_until_block;       // transactions must expire at or before this height
+    uint8_t max_count;                    // maximum number of transactions signed under the policy
+    uint64_t total;                       // cumulative amount signed so far
+    uint8_t count;                        // number of transactions signed so far
+} policy_t;
+
+/**
+ * Check whether a parsed transaction fits the policy and can be signed without review.
+ *
+ * @param[in] policy
+ *   Pointer to the spending policy.
+ * @param[in] bip44_path
+ *   BIP44 path the transaction will be signed with.
+ * @param[in] network_magic
+ *   Network magic the transaction will be signed for.
+ * @param[in] tx
+ *   Pointer to the parsed transaction.
+ *
+ * @return true if the transaction fits the policy, false otherwise.
+ *
+ */
+bool policy_allows(const policy_t *policy,
+                   const uint32_t bip44_path[static BIP44_PATH_LEN],
+                   uint32_t network_magic,
+                   const transaction_t *tx);
+
+/**
+ * Account for a transaction signed under the policy.
+ *
+ * @param[in, out] policy
+ *   Pointer to the spending policy.
+ * @param[in]      tx
+ *   Pointer to the transaction that was signed, it must be allowed by policy_allows().
+ *
+ */
+void policy_record(policy_t *policy, const transaction_t *tx);
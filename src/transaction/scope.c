@@ -0,0 +1,75 @@
+/*****************************************************************************
+ *   (c) 2021 COZ Inc.
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *****************************************************************************/
+
+#include <stdint.h>  // uint*_t
+#include <stddef.h>  // size_t
+#include <stdio.h>   // snprintf
+
+#include "scope.h"
+#include "types.h"
+
+/**
+ * Append 'name' and a comma at 'len' in 'out'.
+ *
+ * @return new length, -1 if it doesn't fit.
+ */
+static int scope_append(char *out, size_t out_len, int len, const char *name) {
+    if (len < 0) {
+        return -1;
+    }
+
+    int written = snprintf(out + len, out_len - (size_t) len, "%s,", name);
+    if (written < 0 || (size_t) written >= out_len - (size_t) len) {
+        return -1;
+    }
+
+    return len + written;
+}
+
+int scope_format(uint8_t scope, char *out, size_t out_len) {
+    if (out_len == 0) {
+        return -1;
+    }
+
+    int len = 0;
+    out[0] = '\0';
+
+    if (scope == NONE) {
+        len = scope_append(out, out_len, len, "None");
+    } else if (scope == GLOBAL) {
+        len = scope_append(out, out_len, len, "Global");
+    } else {
+        if (scope & CALLED_BY_ENTRY) {
+            len = scope_append(out, out_len, len, "By Entry");
+        }
+        if (scope & CUSTOM_CONTRACTS) {
+            len = scope_append(out, out_len, len, "Contracts");
+        }
+        if (scope & CUSTOM_GROUPS) {
+            len = scope_append(out, out_len, len, "Groups");
+        }
+        if (scope & WITNESS_RULES) {
+            len = scope_append(out, out_len, len, "Rules");
+        }
+    }
+
+    if (len <= 0) {
+        return len;
+    }
+
+    out[--len] = '\0';  // take off the comma
+    return len;
+}
@@ -0,0 +1,24 @@
+#pragma once
+
+#include <stdint.h>  // uint*_t
+#include <stddef.h>  // size_t
+
+/**
+ * Longest scope name: "By Entry,Contracts,Groups,Rules," (32) + \0, the trailing comma is removed once written.
+ */
+#define MAX_SCOPE_NAME_LEN 33
+
+/**
+ * Format the flags of a signer scope as a comma separated list of names.
+ *
+ * @param[in]  scope
+ *   Witness scope of the signer.
+ * @param[out] out
+ *   Pointer to output string.
+ * @param[in]  out_len
+ *   Length of output string, at least MAX_SCOPE_NAME_LEN.
+ *
+ * @return length of the name written, -1 if it doesn't fit.
+ *
+ */
+int scope_format(uint8_t scope, char *out, size_t out_len);
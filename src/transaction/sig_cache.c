@@ -0,0 +1,72 @@
+/*****************************************************************************
+ *   (c) 2021 COZ Inc.
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *****************************************************************************/
+
+
+#include <stdint.h>   // uint*_t
+#include <stdbool.h>  // bool
+#include <stddef.h>   // NULL
+#include <string.h>   // memcmp, memcpy
+
+#include "sig_cache.h"
+
+/**
+ * Whether 'entry' holds the signature of the transaction 'hash' with the key of 'bip44_path'.
+ */
+static bool entry_matches(const sig_cache_entry_t *entry,
+                          const uint32_t bip44_path[static BIP44_PATH_LEN],
+                          uint32_t network_magic,
+                          const uint8_t hash[static TX_HASH_LEN]) {
+    return entry->signature_len != 0 && entry->network_magic == network_magic &&
+           memcmp(entry->bip44_path, bip44_path, sizeof(entry->bip44_path)) == 0 &&
+           memcmp(entry->hash, hash, TX_HASH_LEN) == 0;
+}
+
+void sig_cache_add(sig_cache_t *cache,
+                   const uint32_t bip44_path[static BIP44_PATH_LEN],
+                   uint32_t network_magic,
+                   const uint8_t hash[static TX_HASH_LEN],
+                   const uint8_t *signature,
+                   uint8_t signature_len) {
+    if (signature_len == 0 || signature_len > MAX_DER_SIG_LEN) {
+        return;
+    }
+
+    // signing the same transaction again must not evict the signatures of other transactions
+    sig_cache_entry_t *entry = (sig_cache_entry_t *) sig_cache_find(cache, bip44_path, network_magic, hash);
+    if (entry == NULL) {
+        entry = &cache->entries[cache->next];
+        cache->next = (cache->next + 1) % SIG_CACHE_SIZE;
+    }
+
+    memcpy(entry->bip44_path, bip44_path, sizeof(entry->bip44_path));
+    entry->network_magic = network_magic;
+    memcpy(entry->hash, hash, TX_HASH_LEN);
+    memcpy(entry->signature, signature, signature_len);
+    entry->signature_len = signature_len;
+}
+
+const sig_cache_entry_t *sig_cache_find(const sig_cache_t *cache,
+                                        const uint32_t bip44_path[static BIP44_PATH_LEN],
+                                        uint32_t network_magic,
+                                        const uint8_t hash[static TX_HASH_LEN]) {
+    for (uint8_t i = 0; i < SIG_CACHE_SIZE; i++) {
+        if (entry_matches(&cache->entries[i], bip44_path, network_magic, hash)) {
+            return &cache->entries[i];
+        }
+    }
+
+    return NULL;
+}
@@ -0,0 +1,77 @@
+#pragma once
+
+#include <stdint.h>  // uint*_t
+
+#include "tx_hash.h"
+#include "../constants.h"
+
+/**
+ * Number of signatures remembered for GET_LAST_SIGNATURE.
+ */
+#define SIG_CACHE_SIZE 3
+
+/**
+ * Signature produced for a transaction with the key of a BIP44 path. A transaction with several signers
+ * on this device has one entry per path.
+ */
+typedef struct {
+    uint32_t bip44_path[BIP44_PATH_LEN];  // path of the signing key
+    uint32_t network_magic;               // network the transaction was signed for
+    uint8_t hash[TX_HASH_LEN];            // hash of the signed data portion of the transaction
+    uint8_t signature[MAX_DER_SIG_LEN];   // signature encoded in ASN1.DER
+    uint8_t signature_len;                // length of the signature, 0 for an unused entry
+} sig_cache_entry_t;
+
+/**
+ * Last signatures produced, so a host that lost a response can fetch it again without a new review.
+ * Only lives in RAM, the oldest entry is replaced first.
+ */
+typedef struct {
+    sig_cache_entry_t entries[SIG_CACHE_SIZE];
+    uint8_t next;  // entry to replace on the next signature
+} sig_cache_t;
+
+/**
+ * Remember a signature. A signature of the same path and transaction is replaced, otherwise the oldest one
+ * when the cache is full.
+ *
+ * @param[in, out] cache
+ *   Pointer to the signature cache.
+ * @param[in]      bip44_path
+ *   BIP44 path of the signing key.
+ * @param[in]      network_magic
+ *   Network magic the transaction was signed for.
+ * @param[in]      hash
+ *   Hash of the signed data portion of the transaction.
+ * @param[in]      signature
+ *   Signature encoded in ASN1.DER.
+ * @param[in]      signature_len
+ *   Length of the signature, at most MAX_DER_SIG_LEN.
+ *
+ */
+void sig_cache_add(sig_cache_t *cache,
+                   const uint32_t bip44_path[static BIP44_PATH_LEN],
+                   uint32_t network_magic,
+                   const uint8_t hash[static TX_HASH_LEN],
+                   const uint8_t *signature,
+                   uint8_t signature_len);
+
+/**
+ * Look up the most recent signature of a transaction with the key of a BIP44 path.
+ *
+ * @param[in] cache
+ *   Pointer to the signature cache.
+ * @param[in] bip44_path
+ *   BIP44 path of the signing key.
+ * @param[in] network_magic
+ *   Network magic the transaction was signed for.
+ * @param[in] hash
+ *   Hash of the signed data portion of the transaction.
+ *
+ * @return pointer to the cache entry, NULL if the transaction was not signed recently with this path.
+ *
+ */
+const sig_cache_entry_t *sig_cache_find(const sig_cache_t *cache,
+                                        const uint32_t bip44_path[static BIP44_PATH_LEN],
+                                        uint32_t network_magic,
+                                        const uint8_t hash[static TX_HASH_LEN]);
@@ -0,0 +1,32 @@
+/*****************************************************************************
+ *   (c) 2021 COZ Inc.
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *****************************************************************************/
+
+#include <stdint.h>  // uint*_t
+#include <stddef.h>  // NULL
+
+#include "tx_hash.h"
+
+void transaction_hash_init(cx_sha256_t *hash) {
+    cx_sha256_init(hash);
+}
+
+void transaction_hash_update(cx_sha256_t *hash, const buffer_t *chunk) {
+    cx_hash((cx_hash_t *) hash, 0 /*mode*/, chunk->ptr + chunk->offset, chunk->size - chunk->offset, NULL, 0);
+}
+
+void transaction_hash_final(cx_sha256_t *hash, uint8_t out[static TX_HASH_LEN]) {
+    cx_hash((cx_hash_t *) hash, CX_LAST /*mode*/, NULL, 0, out, TX_HASH_LEN);
+}
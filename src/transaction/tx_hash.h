@@ -0,0 +1,44 @@
+#pragma once
+
+#include <stdint.h>  // uint*_t
+
+#include "cx.h"
+
+#include "../common/buffer.h"
+
+/**
+ * Length of the SHA-256 digest of the signed part of a transaction.
+ */
+#define TX_HASH_LEN 32
+
+/**
+ * Start hashing a transaction that is received in chunks.
+ *
+ * @param[out] hash
+ *   Pointer to the SHA-256 context.
+ *
+ */
+void transaction_hash_init(cx_sha256_t *hash);
+
+/**
+ * Add the unread part of a transaction chunk to the hash.
+ * Must be called before the chunk is consumed by the parser.
+ *
+ * @param[in, out] hash
+ *   Pointer to the SHA-256 context.
+ * @param[in]      chunk
+ *   Pointer to buffer with the next part of the serialized transaction.
+ *
+ */
+void transaction_hash_update(cx_sha256_t *hash, const buffer_t *chunk);
+
+/**
+ * Finalize the SHA-256 digest of the signed part of the transaction.
+ *
+ * @param[in, out] hash
+ *   Pointer to the SHA-256 context.
+ * @param[out]     out
+ *   Pointer to output digest.
+ *
+ */
+void transaction_hash_final(cx_sha256_t *hash, uint8_t out[static TX_HASH_LEN]);
@@ -1,4 +1,4 @@
 #include "../common/buffer.h"
 #include "types.h"
 
-void try_parse_transfer_script(buffer_t *script, transaction_t *tx) __attribute__((optnone));
\ No newline at end of file
+void try_parse_transfer_script(buffer_t *script, transaction_t *tx);
\ No newline at end of file
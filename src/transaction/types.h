@@ -4,66 +4,113 @@
 #include <stdint.h>   // uint*_t
 #include <stdbool.h>  // bool
 
+#include "cx.h"
+
 #define ADDRESS_LEN 34  // base58 encoded address size
 #define UINT160_LEN 20
+#define UINT256_LEN 32
 #define ECPOINT_LEN 33
 
 /**
- * Maximum signer_t count in a transaction.
- * Actual network value is 16, we limit it because we run out of SRAM
+ * Maximum signer_t count in a transaction, same as the network.
  * The individual signers must be unique as compared by the account field.
  */
-#define MAX_TX_SIGNERS 2
+#define MAX_TX_SIGNERS 16
 /**
  * The minimum number of signers. First signer is always the sender of the tx
  */
 #define MIN_TX_SIGNERS 1
 /**
- * Limits the maximum 'allowed_contracts' or 'allowed_groups' of a signer_t
- * Actual network value is 16, we limit it because we run out of SRAM
+ * Limits the maximum 'allowed_contracts' or 'allowed_groups' of a signer_t, same as the network.
+ */
+#define MAX_SIGNER_SUB_ITEMS 16
+/**
+ * How deep And, Or and Not conditions of a witness rule may nest, same as the network.
+ * The parser tracks the open conditions in tx_parser_t.condition_stack instead of recursing, so this is also the
+ * worst case number of stack entries it uses.
+ */
+#define MAX_WITNESS_CONDITION_NESTING 2
+/**
+ * Size of the pool holding the accounts, allowed contracts and allowed groups of all signers.
+ * It always fits the accounts of MAX_TX_SIGNERS signers, contracts and groups share what the accounts leave free.
+ */
+#define MAX_SIGNERS_DATA_LEN (MAX_TX_SIGNERS * UINT160_LEN)
+/**
+ * Maximum attribute_t count in a transaction. Same as the network, the signers count is subtracted from it.
+ */
+#define MAX_ATTRIBUTES 16
+/**
+ * Maximum Conflicts attributes in a transaction, the other attribute types can only be attached once.
+ * The network allows as many as MAX_ATTRIBUTES, we limit it to keep the hashes for display.
+ */
+#define MAX_CONFLICTS 4
+/**
+ * Length of the data kept for an OracleResponse attribute: id (8) || code (1) || result length (2, LE) ||
+ * offset of the result in the transaction (4, LE). The result itself is not kept.
  */
-#define MAX_SIGNER_SUB_ITEMS 2
+#define ORACLE_RESPONSE_DATA_LEN 15
 /**
- * The NEO network actually limits the attributes to (16 - signers count).
- * However, there currently only exist 2 attribute types, both can only be attached once
- * thus we limit the size to 2.
- *
- * The 16 magic is also reduced to 8 (see @MAX_TX_SIGNERS) due to SRAM limitation being reached.
+ * Size of the pool holding the data of all attributes: the NotValidBefore height (4), the NotaryAssisted keys
+ * count (1), the OracleResponse data and the Conflicts hashes.
  */
-#define MAX_ATTRIBUTES 2
+#define MAX_ATTRIBUTES_DATA_LEN (4 + 1 + ORACLE_RESPONSE_DATA_LEN + MAX_CONFLICTS * UINT256_LEN)
+/**
+ * Length of the largest script try_parse_transfer_script() can accept:
+ * PUSHNULL (1) + PUSHINT64 amount (9) + 2x PUSHDATA1 UInt160 (2 * 22) + fixed call sequence (15) +
+ * contract script hash (20) + SYSCALL (5).
+ * Longer scripts can never be a NEO or GAS transfer, so their bytes are not kept while streaming.
+ */
+#define MAX_TRANSFER_SCRIPT_LEN 94
+
+/**
+ * Length of the SHA-256 digest of the script, computed for large scripts instead of keeping their bytes.
+ */
+#define SCRIPT_DIGEST_LEN 32
 
 /**
- * Transaction parsing codes
+ * Transaction parsing codes, X(name, value).
+ * The Python tests build their ParserStatus from this list, values are part of the APDU interface.
  */
+#define PARSER_STATUS_CODES(X)                                                                         \
+    X(PARSING_OK, 1)                                                                                   \
+    X(INVALID_LENGTH_ERROR, -1)                                                                        \
+    X(VERSION_PARSING_ERROR, -2)                                                                       \
+    X(VERSION_VALUE_ERROR, -3)                                                                         \
+    X(NONCE_PARSING_ERROR, -4)                                                                         \
+    X(SYSTEM_FEE_PARSING_ERROR, -5)                                                                    \
+    X(SYSTEM_FEE_VALUE_ERROR, -6)                                                                      \
+    X(NETWORK_FEE_PARSING_ERROR, -7)                                                                   \
+    X(NETWORK_FEE_VALUE_ERROR, -8)                                                                     \
+    X(VALID_UNTIL_BLOCK_PARSING_ERROR, -9)                                                             \
+    X(SIGNER_LENGTH_PARSING_ERROR, -10)                                                                \
+    X(SIGNER_LENGTH_VALUE_ERROR, -11)                                                                  \
+    X(SIGNER_ACCOUNT_PARSING_ERROR, -12) /* not enough data to get account */                          \
+    X(SIGNER_ACCOUNT_DUPLICATE_ERROR, -13)                                                             \
+    X(SIGNER_SCOPE_PARSING_ERROR, -14)                                                                 \
+    X(SIGNER_SCOPE_VALUE_ERROR_GLOBAL_FLAG, -15) /* scope GLOBAL is not allowed to have other flags */ \
+    X(SIGNER_ALLOWED_CONTRACTS_LENGTH_PARSING_ERROR, -16)                                              \
+    X(SIGNER_ALLOWED_CONTRACTS_LENGTH_VALUE_ERROR, -17)                                                \
+    X(SIGNER_ALLOWED_CONTRACT_PARSING_ERROR, -18)                                                      \
+    X(SIGNER_ALLOWED_GROUPS_LENGTH_PARSING_ERROR, -19)                                                 \
+    X(SIGNER_ALLOWED_GROUPS_LENGTH_VALUE_ERROR, -20)                                                   \
+    X(SIGNER_ALLOWED_GROUPS_PARSING_ERROR, -21)                                                        \
+    X(ATTRIBUTES_LENGTH_PARSING_ERROR, -22)                                                            \
+    X(ATTRIBUTES_LENGTH_VALUE_ERROR, -23) /* exceeding count limits */                                 \
+    X(ATTRIBUTES_UNSUPPORTED_TYPE, -24)                                                                \
+    X(ATTRIBUTES_DUPLICATE_TYPE, -25)                                                                  \
+    X(SCRIPT_LENGTH_PARSING_ERROR, -26)                                                                \
+    X(SCRIPT_LENGTH_VALUE_ERROR, -27) /* requesting more data than available */                        \
+    X(SIGNER_RULES_LENGTH_PARSING_ERROR, -28)                                                          \
+    X(SIGNER_RULES_LENGTH_VALUE_ERROR, -29) /* exceeding count limits, or the rules don't fit */       \
+    X(SIGNER_RULE_PARSING_ERROR, -30) /* not enough data to get a rule action or condition */          \
+    X(SIGNER_RULE_VALUE_ERROR, -31) /* invalid action, condition type or value, or nesting too deep */ \
+    X(ATTRIBUTE_DATA_PARSING_ERROR, -32) /* not enough data to get the data of an attribute */         \
+    X(ATTRIBUTE_DATA_VALUE_ERROR, -33) /* invalid oracle response code or result */
+
 typedef enum {
-    PARSING_OK = 1,
-    INVALID_LENGTH_ERROR = -1,
-    VERSION_PARSING_ERROR = -2,
-    VERSION_VALUE_ERROR = -3,
-    NONCE_PARSING_ERROR = -4,
-    SYSTEM_FEE_PARSING_ERROR = -5,
-    SYSTEM_FEE_VALUE_ERROR = -6,
-    NETWORK_FEE_PARSING_ERROR = -7,
-    NETWORK_FEE_VALUE_ERROR = -8,
-    VALID_UNTIL_BLOCK_PARSING_ERROR = -9,
-    SIGNER_LENGTH_PARSING_ERROR = -10,
-    SIGNER_LENGTH_VALUE_ERROR = -11,
-    SIGNER_ACCOUNT_PARSING_ERROR = -12,  // not enough data to get account
-    SIGNER_ACCOUNT_DUPLICATE_ERROR = -13,
-    SIGNER_SCOPE_PARSING_ERROR = -14,
-    SIGNER_SCOPE_VALUE_ERROR_GLOBAL_FLAG = -15,  // scope GLOBAL is not allowed to have other flags
-    SIGNER_ALLOWED_CONTRACTS_LENGTH_PARSING_ERROR = -16,
-    SIGNER_ALLOWED_CONTRACTS_LENGTH_VALUE_ERROR = -17,
-    SIGNER_ALLOWED_CONTRACT_PARSING_ERROR = -18,
-    SIGNER_ALLOWED_GROUPS_LENGTH_PARSING_ERROR = -19,
-    SIGNER_ALLOWED_GROUPS_LENGTH_VALUE_ERROR = -20,
-    SIGNER_ALLOWED_GROUPS_PARSING_ERROR = -21,
-    ATTRIBUTES_LENGTH_PARSING_ERROR = -22,
-    ATTRIBUTES_LENGTH_VALUE_ERROR = -23,  // exceeding count limits
-    ATTRIBUTES_UNSUPPORTED_TYPE = -24,
-    ATTRIBUTES_DUPLICATE_TYPE = -25,
-    SCRIPT_LENGTH_PARSING_ERROR = -26,
-    SCRIPT_LENGTH_VALUE_ERROR = -27  // requesting more data than available
+#define X(name, value) name = value,
+    PARSER_STATUS_CODES(X)
+#undef X
 } parser_status_e;
 
 typedef enum {
@@ -71,26 +118,78 @@ typedef enum {
     CALLED_BY_ENTRY = 0x1,
     CUSTOM_CONTRACTS = 0x10,
     CUSTOM_GROUPS = 0x20,
+    WITNESS_RULES = 0x40,
     GLOBAL = 0x80
 } witness_scope_e;
 
+typedef enum {
+    WITNESS_RULE_DENY = 0x0,
+    WITNESS_RULE_ALLOW = 0x1
+} witness_rule_action_e;
+
+typedef enum {
+    CONDITION_BOOLEAN = 0x00,
+    CONDITION_NOT = 0x01,
+    CONDITION_AND = 0x02,
+    CONDITION_OR = 0x03,
+    CONDITION_SCRIPT_HASH = 0x18,
+    CONDITION_GROUP = 0x19,
+    CONDITION_CALLED_BY_ENTRY = 0x20,
+    CONDITION_CALLED_BY_CONTRACT = 0x28,
+    CONDITION_CALLED_BY_GROUP = 0x29
+} witness_condition_type_e;
+
+/**
+ * Witness rules are stored as a flat list of items, each starting with a kind byte.
+ * A rule is a single kind byte holding its witness_rule_action_e (level 0). It is followed by its conditions in
+ * depth first order: a kind byte holding the witness_condition_type_e and the nesting level (1 for the condition of
+ * the rule) in the upper 2 bits, then the boolean (1), the And/Or sub-condition count (1), the UInt160 (20) or the
+ * ECPoint (33) of the condition, if any.
+ */
+#define WITNESS_RULE_ITEM_LEVEL(kind) ((kind) >> 6)
+#define WITNESS_RULE_ITEM_TYPE(kind)  ((kind) & 0x3F)
+
+/**
+ * Signer of a transaction. Its account (UInt160), allowed contracts (UInt160s), allowed groups (ECPoints in
+ * compressed format) and witness rule items are stored back to back in transaction_t.signers_data, see
+ * transaction_signer_account().
+ */
 typedef struct {
-    uint8_t *account;  // UInt160, 20 bytes
-    witness_scope_e scope;
-    uint8_t *allowed_contracts[MAX_SIGNER_SUB_ITEMS];  // array of UInt160s
-    uint8_t allowed_contracts_size;
-    uint8_t *allowed_groups[MAX_SIGNER_SUB_ITEMS];  // array of ECPoints in compressed format, 33 bytes
-    uint8_t allowed_groups_size;
+    uint16_t offset;                 // offset of the account in transaction_t.signers_data
+    uint8_t scope;                   // witness_scope_e flags
+    uint8_t allowed_contracts_size;  // number of UInt160s following the account
+    uint8_t allowed_groups_size;     // number of ECPoints following the allowed contracts
+    uint8_t rules_size;              // number of witness rules following the allowed groups
+    uint16_t rule_items_size;        // number of rule and condition items of the witness rules
 } signer_t;
 
 typedef enum {
     HIGH_PRIORITY = 0x1,
-    ORACLE_RESPONSE = 0x11  // do not support signing this
+    ORACLE_RESPONSE = 0x11,
+    NOT_VALID_BEFORE = 0x20,
+    CONFLICTS = 0x21,
+    NOTARY_ASSISTED = 0x22
 } tx_attribute_type_e;
 
+typedef enum {
+    ORACLE_SUCCESS = 0x00,
+    ORACLE_PROTOCOL_NOT_SUPPORTED = 0x10,
+    ORACLE_CONSENSUS_UNREACHABLE = 0x12,
+    ORACLE_NOT_FOUND = 0x14,
+    ORACLE_TIMEOUT = 0x16,
+    ORACLE_FORBIDDEN = 0x18,
+    ORACLE_RESPONSE_TOO_LARGE = 0x1a,
+    ORACLE_INSUFFICIENT_FUNDS = 0x1c,
+    ORACLE_CONTENT_TYPE_NOT_SUPPORTED = 0x1f,
+    ORACLE_ERROR = 0xff
+} oracle_response_code_e;
+
+/**
+ * Attribute of a transaction, its data (if any) is stored in transaction_t.attributes_data.
+ */
 typedef struct {
-    tx_attribute_type_e type;
-    // might expand this later if new attributes are introduced to have data beyond a type
+    uint8_t type;    // tx_attribute_type_e
+    uint8_t offset;  // offset of the attribute data in transaction_t.attributes_data
 } attribute_t;
 
 typedef struct {
@@ -100,13 +199,89 @@ typedef struct {
     int64_t network_fee;
     uint32_t valid_until_block;
     signer_t signers[MAX_TX_SIGNERS];
-    uint8_t signers_size;  // the actual signers count after parsing
+    uint8_t signers_size;                        // the actual signers count after parsing
+    uint8_t signers_data[MAX_SIGNERS_DATA_LEN];  // accounts, allowed contracts and allowed groups of the signers
+    uint16_t signers_data_len;                   // number of bytes used in 'signers_data'
     attribute_t attributes[MAX_ATTRIBUTES];
-    uint8_t attributes_size;  // the actual attributes count after parsing
-    uint8_t *script;          // VM opcodes
-    uint16_t script_size;
+    // data of the attributes, see attribute_t
+    uint8_t attributes_data[MAX_ATTRIBUTES_DATA_LEN];
+    uint8_t attributes_data_len;    // number of bytes used in 'attributes_data'
+    uint8_t attributes_size;        // the actual attributes count after parsing
+    uint32_t script_size;           // VM opcodes are not kept, see tx_parser_t.script
     bool is_system_asset_transfer;  // indicates if the instructions in `script` match a standard GAS or NEO transfer
     bool is_neo;                    // indicates if 'transfer' is called on the NEO contract. False means GAS contract
     int64_t amount;                 // transfer amount
     uint8_t dst_address[ADDRESS_LEN];
+    uint8_t script_hash[SCRIPT_DIGEST_LEN];  // SHA-256 of the script, only set in large script mode
 } transaction_t;
+
+/**
+ * Widths in TX_PARSER_STEPS that are not a number of bytes.
+ */
+#define TX_FIELD_CUSTOM 0    // the step reads its own data
+#define TX_FIELD_VARINT 255  // a varint, read with its prefix
+
+/**
+ * Layout of a transaction as the fields the streaming parser expects in turn, X(step, width, truncated status).
+ * The truncated status is reported when the transaction ends while the field is expected, a truncated group
+ * reports SIGNER_ALLOWED_CONTRACT_PARSING_ERROR as previous versions did.
+ */
+#define TX_PARSER_STEPS(X)                                                                             \
+    X(TX_STEP_VERSION, 1, VERSION_PARSING_ERROR)                                                       \
+    X(TX_STEP_NONCE, 4, NONCE_PARSING_ERROR)                                                           \
+    X(TX_STEP_SYSTEM_FEE, 8, SYSTEM_FEE_PARSING_ERROR)                                                 \
+    X(TX_STEP_NETWORK_FEE, 8, NETWORK_FEE_PARSING_ERROR)                                               \
+    X(TX_STEP_VALID_UNTIL_BLOCK, 4, VALID_UNTIL_BLOCK_PARSING_ERROR)                                   \
+    X(TX_STEP_SIGNERS_LENGTH, TX_FIELD_VARINT, SIGNER_LENGTH_PARSING_ERROR)                            \
+    X(TX_STEP_SIGNER_ACCOUNT, UINT160_LEN, SIGNER_ACCOUNT_PARSING_ERROR)                               \
+    X(TX_STEP_SIGNER_SCOPE, 1, SIGNER_SCOPE_PARSING_ERROR)                                             \
+    X(TX_STEP_SIGNER_CONTRACTS_LENGTH, TX_FIELD_VARINT, SIGNER_ALLOWED_CONTRACTS_LENGTH_PARSING_ERROR) \
+    X(TX_STEP_SIGNER_CONTRACT, UINT160_LEN, SIGNER_ALLOWED_CONTRACT_PARSING_ERROR)                     \
+    X(TX_STEP_SIGNER_GROUPS_LENGTH, TX_FIELD_VARINT, SIGNER_ALLOWED_GROUPS_LENGTH_PARSING_ERROR)       \
+    X(TX_STEP_SIGNER_GROUP, ECPOINT_LEN, SIGNER_ALLOWED_CONTRACT_PARSING_ERROR)                        \
+    X(TX_STEP_SIGNER_RULES_LENGTH, TX_FIELD_VARINT, SIGNER_RULES_LENGTH_PARSING_ERROR)                 \
+    X(TX_STEP_SIGNER_RULE_ACTION, 1, SIGNER_RULE_PARSING_ERROR)                                        \
+    X(TX_STEP_SIGNER_RULE_CONDITION, 1, SIGNER_RULE_PARSING_ERROR)                                     \
+    X(TX_STEP_SIGNER_RULE_CONDITION_COUNT, TX_FIELD_VARINT, SIGNER_RULE_PARSING_ERROR)                 \
+    X(TX_STEP_SIGNER_RULE_CONDITION_DATA, TX_FIELD_CUSTOM, SIGNER_RULE_PARSING_ERROR)                  \
+    X(TX_STEP_ATTRIBUTES_LENGTH, TX_FIELD_VARINT, ATTRIBUTES_LENGTH_PARSING_ERROR)                     \
+    X(TX_STEP_ATTRIBUTE, 1, ATTRIBUTES_UNSUPPORTED_TYPE)                                               \
+    X(TX_STEP_ATTRIBUTE_DATA, TX_FIELD_CUSTOM, ATTRIBUTE_DATA_PARSING_ERROR)                           \
+    X(TX_STEP_ORACLE_RESULT_LENGTH, TX_FIELD_VARINT, ATTRIBUTE_DATA_PARSING_ERROR)                     \
+    X(TX_STEP_ORACLE_RESULT, TX_FIELD_CUSTOM, ATTRIBUTE_DATA_PARSING_ERROR)                            \
+    X(TX_STEP_SCRIPT_LENGTH, TX_FIELD_VARINT, SCRIPT_LENGTH_PARSING_ERROR)                             \
+    X(TX_STEP_SCRIPT, TX_FIELD_CUSTOM, SCRIPT_LENGTH_VALUE_ERROR)                                      \
+    X(TX_STEP_DONE, TX_FIELD_CUSTOM, PARSING_OK)
+
+/**
+ * Transaction field the streaming parser expects next.
+ */
+typedef enum {
+#define X(step, width, truncated_status) step,
+    TX_PARSER_STEPS(X)
+#undef X
+} tx_parser_step_e;
+
+/**
+ * State of the streaming transaction parser. It allows the transaction to be parsed chunk by chunk
+ * as APDUs arrive, without keeping the raw transaction around.
+ */
+typedef struct {
+    tx_parser_step_e step;
+    uint32_t offset;                          // number of transaction bytes consumed so far
+    uint32_t field_offset;                    // offset of the first byte of the field being parsed
+    uint8_t pending[ECPOINT_LEN];             // partial field that straddles a chunk boundary
+    uint8_t pending_len;                      // number of bytes collected in 'pending'
+    uint8_t index;                            // current signer or attribute index
+    uint8_t sub_index;                        // current allowed contract, group or rule index of the signer
+    uint8_t account_first_bytes[32];          // bitmap of the first byte of the signer accounts parsed so far
+    uint8_t condition_type;                   // witness_condition_type_e of the condition being parsed
+    // sub-conditions left in each open And, Or or Not condition, a stack instead of recursion
+    uint8_t condition_stack[MAX_WITNESS_CONDITION_NESTING];
+    uint8_t condition_depth;                  // number of open conditions in 'condition_stack'
+    uint16_t oracle_result_remaining;         // oracle response result bytes still to be received
+    uint32_t script_remaining;                // script bytes still to be received
+    uint8_t script[MAX_TRANSFER_SCRIPT_LEN];  // script bytes, only kept if it can be a NEO or GAS transfer
+    bool large_script;                        // no size limits, the script is hashed as it streams in
+    cx_sha256_t script_hash;                  // running digest of the script in large script mode
+} tx_parser_t;
@@ -1,10 +1,14 @@
 #pragma once
 
-#include <stddef.h>  // size_t
-#include <stdint.h>  // uint*_t
+#include <stddef.h>   // size_t
+#include <stdint.h>   // uint*_t
+#include <stdbool.h>  // bool
 
 #include "constants.h"
 #include "transaction/types.h"
+#include "transaction/tx_hash.h"
+#include "common/pubkey_store.h"
+#include "common/multisig.h"
 
 /**
  * Enumeration for the status of IO.
@@ -19,10 +23,19 @@ typedef enum {
  * Enumeration with expected INS of APDU commands.
  */
 typedef enum {
-    GET_APP_NAME = 0x0,    /// name of the application
-    GET_VERSION = 0x01,    /// version of the application
-    SIGN_TX = 0x02,        /// sign transaction with BIP44 path and return signature
-    GET_PUBLIC_KEY = 0x04  /// public key of corresponding BIP44 path and return uncompressed public key
+    GET_APP_NAME = 0x0,          /// name of the application
+    GET_VERSION = 0x01,          /// version of the application
+    SIGN_TX = 0x02,              /// sign transaction with BIP44 path and return signature
+    GET_PUBLIC_KEY = 0x04,       /// public key of corresponding BIP44 path and return uncompressed public key
+    SIGN_BATCH = 0x05,           /// sign multiple transactions with BIP44 path after a single review
+    SET_POLICY = 0x06,           /// approve a spending policy to sign matching transfers without review
+    GET_LAST_SIGNATURE = 0x07,   /// signature of a recently signed transaction, without review
+    PARSE_TX = 0x08,             /// parse a transaction and return a summary, without review or signing
+    GET_PUBLIC_KEYS = 0x09,      /// compressed public keys or script hashes of a range of address indexes
+    GET_CACHE_STATS = 0x0A,      /// hit and miss counters of the public key cache
+    GET_ACCOUNT_XPUB = 0x0B,     /// public key and chain code of an account, after user approval
+    DISCOVER_ADDRESSES = 0x0C,   /// address indexes of the given script hashes within a range of indexes
+    GET_MULTISIG_ADDRESS = 0x0D  /// script hash and address of a multi signature account
 } command_e;
 
 /**
@@ -45,33 +58,91 @@ typedef enum {
     STATE_BIP44_OK,  /// BIP44 path parsed
     STATE_MAGIC_OK,  /// Network magic parsed
     STATE_PARSED,    /// Transaction data parsed
-    STATE_APPROVED   /// Transaction data approved
+    STATE_APPROVED,  /// Transaction data approved
+    STATE_REJECTED   /// Transaction rejected while it was still being received
 } state_e;
 
 /**
  * Enumeration with user request type.
  */
 typedef enum {
-    CONFIRM_ADDRESS,     /// Confirm address derived from public key
-    CONFIRM_TRANSACTION  /// Confirm transaction information
+    CONFIRM_ADDRESS,      /// Confirm address derived from public key
+    CONFIRM_TRANSACTION,  /// Confirm transaction information
+    CONFIRM_BATCH,        /// Confirm the summary of a batch of transactions
+    CONFIRM_POLICY,       /// Confirm a spending policy
+    CHECK_TRANSACTION,    /// Parse a transaction without signing it
+    CONFIRM_XPUB,         /// Confirm the export of an account extended public key
+    CONFIRM_MULTISIG      /// Confirm the address of a multi signature account
 } request_type_e;
 
+/**
+ * Structure for the transactions of a SIGN_BATCH session.
+ * Transactions are only parsed and hashed while they stream in, their hashes are signed once the summary is approved.
+ */
+typedef struct {
+    uint8_t count;                              /// Number of transactions received
+    uint8_t hashes[MAX_BATCH_TX][TX_HASH_LEN];  /// Hash of the signed data portion of each transaction
+    uint64_t neo_total;                         /// Sum of the NEO transfer amounts
+    uint64_t gas_total;                         /// Sum of the GAS transfer amounts
+    uint64_t fees_total;                        /// Sum of the system and network fees
+    uint8_t dst_address[ADDRESS_LEN];           /// Destination of the first transfer
+    bool mixed_destinations;                    /// Whether the transfers go to more than one destination
+    uint32_t max_valid_until_block;             /// Highest valid until height of the transactions
+    uint8_t account[UINT160_LEN];               /// Script hash of the account of the BIP44 path, the only signer
+} batch_ctx_t;
+
+/**
+ * Structure for the signers of a transaction that are accounts on this device, when SIGN_TX has several BIP44 paths.
+ */
+typedef struct {
+    uint8_t count;                                          /// Number of BIP44 paths, 0 for a single path
+    uint32_t paths[MAX_SIGNER_PATHS][BIP44_PATH_LEN];       /// BIP44 paths, the first is also G_context.bip44_path
+    uint8_t signer_indexes[MAX_SIGNER_PATHS];               /// Index in transaction.signers of each path
+    uint8_t signatures[MAX_SIGNER_PATHS][MAX_DER_SIG_LEN];  /// Signature of each path encoded in ASN1.DER
+    uint8_t signature_lens[MAX_SIGNER_PATHS];               /// Length of each signature
+} signer_paths_t;
+
 /**
  * Structure for transaction information context.
  */
 typedef struct {
-    uint8_t raw_tx[MAX_TRANSACTION_LEN];  /// Raw transaction serialized
-    size_t raw_tx_len;                    /// Length of raw transaction
-    transaction_t transaction;            /// Structured transaction
+    tx_parser_t parser;         /// Streaming parser state of the raw transaction
+    cx_sha256_t tx_hash;        /// Running hash of the raw transaction chunks received so far
+    transaction_t transaction;  /// Structured transaction
 
     /// Transaction hash digest
     /// This is just the hash of the tx signed data portion
     /// this is not the actual hash going used for signing
-    uint8_t hash[32];                    /// as that also includes the network magic
+    uint8_t hash[TX_HASH_LEN];           /// as that also includes the network magic
     uint8_t signature[MAX_DER_SIG_LEN];  /// Transaction signature encoded in ASN1.DER
     uint8_t signature_len;               /// Length of transaction signature
+    batch_ctx_t batch;                   /// Transactions of a SIGN_BATCH session
+    bool review_started;                 /// Header screens are shown while the transaction is still received
+    bool large_script;                   /// Scripts of any size are accepted and reviewed by their hash
+    bool raw_signature;                  /// Respond with r || s and the transaction hash instead of DER
+    signer_paths_t signer_paths;         /// Signers of the transaction on this device, when there are several
 } transaction_ctx_t;
 
+/**
+ * Structure for the extended public key of m/44'/888'/account'.
+ */
+typedef struct {
+    uint8_t public_key[33];  /// compressed public key
+    uint8_t chain_code[32];  /// BIP32 chain code
+} account_xpub_t;
+
+/**
+ * Structure for the public keys of a multi signature account while they are received.
+ */
+typedef struct {
+    uint8_t m;                            /// Number of signatures required
+    uint8_t n;                            /// Number of public keys
+    uint8_t received;                     /// Number of public keys received so far
+    bool display;                         /// Whether the address is confirmed on screen
+    uint8_t keys[MULTISIG_MAX_KEYS][33];  /// Compressed public keys, sorted once all are received
+    uint8_t script_hash[UINT160_LEN];     /// Script hash of the verification script
+} multisig_ctx_t;
+
 /**
  * Structure for global context.
  */
@@ -80,8 +151,53 @@ typedef struct {
     union {
         uint8_t raw_public_key[64];  /// x-coordinate (32), y-coodinate (32)
         transaction_ctx_t tx_info;   /// Transaction context
+        account_xpub_t xpub;         /// Account extended public key
+        multisig_ctx_t multisig;     /// Multi signature account
     };
     uint32_t network_magic;
     request_type_e req_type;              /// User request
     uint32_t bip44_path[BIP44_PATH_LEN];  /// BIP44 path
+    uint8_t pubkey_format;                /// GET_PUBLIC_KEY response format (P1_PUBKEY_*)
 } global_ctx_t;
+
+/**
+ * Derived node of m/44'/888'/account'/change, the address index is derived from it with a single
+ * non hardened step instead of a full derivation from the seed.
+ */
+typedef struct {
+    bool valid;                         /// Whether the node below is derived
+    uint32_t path[BIP44_PATH_LEN - 1];  /// BIP44 path of the node, without address index
+    uint8_t private_key[32];            /// Private key of the node
+    uint8_t chain_code[32];             /// Chain code of the node
+    uint8_t compressed_public_key[33];  /// Public key of the node, input of the non hardened derivation
+} account_node_t;
+
+/**
+ * Fingerprint of the seed of the session, computed on first use, see crypto_seed_fingerprint().
+ */
+typedef struct {
+    bool valid;                                   /// Whether the fingerprint below is computed
+    uint8_t value[PUBKEY_STORE_FINGERPRINT_LEN];  /// First bytes of the SHA-256 of the public key of m/44'/888'
+} seed_fingerprint_t;
+
+/**
+ * Private key and message hash of the transaction under review, prepared while the review is shown
+ * so approving only has to sign. Wiped after signing, on reject, on any new command and on exit.
+ */
+typedef struct {
+    bool valid;                           /// Whether the slot below is prepared
+    uint32_t bip44_path[BIP44_PATH_LEN];  /// BIP44 path of the key
+    uint32_t network_magic;               /// Network magic included in the message hash
+    uint8_t tx_hash[TX_HASH_LEN];         /// Hash of the signed data portion of the transaction
+    uint8_t message_hash[32];             /// sha256(network magic || tx_hash), input of ECDSA
+    uint8_t private_key[32];              /// Private key of the BIP44 path
+} signing_key_t;
+
+/**
+ * Settings and data persisted in flash.
+ */
+typedef struct {
+    uint8_t initialized;           /// Whether the storage has been set up after install
+    uint8_t pubkey_store_enabled;  /// Whether public keys are kept in flash, off until the user enables it
+    pubkey_store_t pubkey_store;   /// Public keys kept across app restarts
+} internal_storage_t;
@@ -16,6 +16,7 @@
  *****************************************************************************/
 
 #include <stdbool.h>  // bool
+#include <string.h>   // explicit_bzero
 
 #include "validate.h"
 #include "../menu.h"
@@ -35,21 +36,81 @@ void ui_action_validate_pubkey(bool approved) {
     ui_menu_main();
 }
 
+void ui_action_validate_xpub(bool approved) {
+    if (approved) {
+        helper_send_response_xpub();
+    } else {
+        io_send_sw(SW_DENY);
+    }
+    explicit_bzero(&G_context, sizeof(G_context));
+
+    ui_menu_main();
+}
+
+void ui_action_validate_multisig(bool approved) {
+    if (approved) {
+        helper_send_response_multisig();
+    } else {
+        io_send_sw(SW_DENY);
+    }
+    explicit_bzero(&G_context, sizeof(G_context));
+
+    ui_menu_main();
+}
+
 void ui_action_validate_transaction(bool approved) {
+    if (!approved && G_context.state == STATE_MAGIC_OK) {
+        // Rejected during a progressive review, there is no pending command to answer.
+        // The next transaction chunk is answered with SW_DENY instead.
+        G_context.state = STATE_REJECTED;
+        ui_menu_main();
+        return;
+    }
+
     if (approved) {
         G_context.state = STATE_APPROVED;
 
-        if (crypto_sign_tx() < 0) {
+        bool multi_signer = G_context.tx_info.signer_paths.count > 0;
+        if ((multi_signer ? crypto_sign_tx_signer_paths() : crypto_sign_tx()) < 0) {
             G_context.state = STATE_NONE;
             io_send_sw(SW_SIGN_FAIL);
+        } else if (multi_signer) {
+            helper_send_response_sigs();
         } else {
-            io_send_response(&(const buffer_t){.ptr = G_context.tx_info.signature,
-                                               .size = G_context.tx_info.signature_len,
-                                               .offset = 0},
-                             SW_OK);
+            helper_send_response_sig();
         }
     } else {
         G_context.state = STATE_NONE;
+        crypto_clear_signing_key();
+        io_send_sw(SW_DENY);
+    }
+
+    ui_menu_main();
+}
+
+void ui_action_validate_batch(bool approved) {
+    if (approved) {
+        G_context.state = STATE_APPROVED;
+
+        io_send_response(&(const buffer_t){.ptr = &G_context.tx_info.batch.count, .size = 1, .offset = 0}, SW_OK);
+    } else {
+        G_context.state = STATE_NONE;
+        io_send_sw(SW_DENY);
+    }
+
+    ui_menu_main();
+}
+
+void ui_action_validate_policy(bool approved) {
+    if (approved) {
+        G_policy.active = true;
+        G_context.state = STATE_APPROVED;
+
+        io_send_sw(SW_OK);
+    } else {
+        explicit_bzero(&G_policy, sizeof(G_policy));
+        G_context.state = STATE_NONE;
+
         io_send_sw(SW_DENY);
     }
 
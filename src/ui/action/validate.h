@@ -11,6 +11,24 @@
  */
 void ui_action_validate_pubkey(bool approved);
 
+/**
+ * Action for the export of an account extended public key.
+ *
+ * @param[in] approved
+ *   User approved or rejected.
+ *
+ */
+void ui_action_validate_xpub(bool approved);
+
+/**
+ * Action for the address of a multi signature account.
+ *
+ * @param[in] approved
+ *   User approved or rejected.
+ *
+ */
+void ui_action_validate_multisig(bool approved);
+
 /**
  * Action for transaction information validation.
  *
@@ -19,3 +37,21 @@ void ui_action_validate_pubkey(bool approved);
  *
  */
 void ui_action_validate_transaction(bool approved);
+
+/**
+ * Action for the summary of a batch of transactions.
+ *
+ * @param[in] approved
+ *   User approved or rejected the batch. The signatures are then fetched one by one.
+ *
+ */
+void ui_action_validate_batch(bool approved);
+
+/**
+ * Action for spending policy validation.
+ *
+ * @param[in] approved
+ *   User approved or rejected. An approved policy is active until the app exits or it is replaced.
+ *
+ */
+void ui_action_validate_policy(bool approved);
@@ -33,22 +33,40 @@
 #include "../sw.h"
 #include "action/validate.h"
 #include "../transaction/types.h"
+#include "../transaction/deserialize.h"
+#include "../transaction/scope.h"
 #include "../common/format.h"
+#include "../common/read.h"
 #include "utils.h"
 
 static action_validate_cb g_validate_callback;
 static char g_system_fee[30];
 static char g_network_fee[30];
 static char g_total_fees[30];
-static char g_network[11];            // Target network the tx in tended for
-                                      // ("MainNet", "TestNet" or uint32 network number for private nets)
-static char g_valid_until_block[11];  // uint32 (=max 10 chars) + \0
-static char g_scope[28];              // Longest combination is: "By Entry, Contracts, Groups" (27) + \0
-static char g_title[64];              // generic step title
-static char g_text[64];               // generic step text
+static char g_network[11];                // Target network the tx in tended for
+                                          // ("MainNet", "TestNet" or uint32 network number for private nets)
+static char g_valid_until_block[11];      // uint32 (=max 10 chars) + \0
+static char g_scope[MAX_SCOPE_NAME_LEN];  // Longest combination is: "By Entry,Contracts,Groups,Rules," (32) + \0
+static char g_title[64];                  // generic step title
+static char g_text[88];                   // generic step text, fits a condition name and a hex encoded ECPoint
 
 static char g_address[35];  // 34 + \0
 
+static char g_script_size[17];  // uint32 (=max 10 chars) + " bytes" + \0
+static char g_script_hash[65];  // SHA-256 in hex + \0
+static char g_sign_as[24];      // signer numbers of the BIP44 paths of a multi signer SIGN_TX
+
+static char g_not_valid_before[11];                              // uint32 (=max 10 chars) + \0
+static char g_notary_keys[10];                                   // uint8 (=max 3 chars) + " keys" + \0
+static char g_oracle_response[72];                               // "ID <uint64>, <code>, <uint16> bytes" + \0
+static char g_conflicts[MAX_CONFLICTS * (2 * UINT256_LEN + 1)];  // hashes in hex, separated by spaces + \0
+
+static char g_batch_count[4];  // uint8 (=max 3 chars) + \0
+static char g_neo_total[30];
+static char g_gas_total[30];
+static char g_max_amount[30];
+static char g_max_total[30];
+
 // Step with icon and text
 UX_STEP_NOCB(ux_display_confirm_addr_step, pn, {&C_icon_eye, "Confirm Address"});
 // Step with title/text for address
@@ -117,6 +135,7 @@ struct display_ctx_t {
     uint8_t p_index;             // track which signer property is displayed (see also: e_signer_state)
     int8_t c_index;              // track which signer.contract is to be displayed
     int8_t g_index;              // track which signer.group is to be displayed
+    int16_t r_index;             // track which signer witness rule item is to be displayed
 } display_ctx;
 
 // Step with icon and text
@@ -142,6 +161,62 @@ UX_STEP_NOCB(ux_display_token_amount_step,
                  .text = g_text,
              });
 
+UX_STEP_NOCB(ux_display_script_size_step,
+             bnnn_paging,
+             {
+                 .title = "Script size",
+                 .text = g_script_size,
+             });
+
+UX_STEP_NOCB(ux_display_script_hash_step,
+             bnnn_paging,
+             {
+                 .title = "Script SHA-256",
+                 .text = g_script_hash,
+             });
+
+UX_STEP_NOCB(ux_display_sign_as_step,
+             bnnn_paging,
+             {
+                 .title = "Signing as",
+                 .text = g_sign_as,
+             });
+
+UX_STEP_NOCB(ux_display_high_priority_step,
+             bnnn_paging,
+             {
+                 .title = "Priority",
+                 .text = "High",
+             });
+
+UX_STEP_NOCB(ux_display_not_valid_before_step,
+             bnnn_paging,
+             {
+                 .title = "Not valid before",
+                 .text = g_not_valid_before,
+             });
+
+UX_STEP_NOCB(ux_display_notary_assisted_step,
+             bnnn_paging,
+             {
+                 .title = "Notary assisted",
+                 .text = g_notary_keys,
+             });
+
+UX_STEP_NOCB(ux_display_oracle_response_step,
+             bnnn_paging,
+             {
+                 .title = "Oracle response",
+                 .text = g_oracle_response,
+             });
+
+UX_STEP_NOCB(ux_display_conflicts_step,
+             bnnn_paging,
+             {
+                 .title = "Conflicts with",
+                 .text = g_conflicts,
+             });
+
 UX_STEP_NOCB(ux_display_systemfee_step,
              bnnn_paging,
              {
@@ -192,6 +267,15 @@ UX_STEP_CB(ux_display_abort_step,
                "Understood, abort..",
            });
 
+// Shown in place of the script dependent screens while the transaction is still being received
+UX_STEP_NOCB(ux_display_wait_step,
+             pnn,
+             {
+                 &C_icon_processing,
+                 "Receiving",
+                 "transaction...",
+             });
+
 // 3 special steps for runtime dynamic screen generation, used to display attached signers and their properties
 UX_STEP_INIT(ux_upper_delimiter, NULL, NULL, { display_next_state(true); });
 
@@ -209,15 +293,52 @@ void reset_signer_display_state() {
     display_ctx.s_index = 0;
     display_ctx.g_index = -1;
     display_ctx.c_index = -1;
+    display_ctx.r_index = -1;
     display_ctx.p_index = 0;
 }
 
-#define MAX_NUM_STEPS 13
+#define MAX_NUM_STEPS 19
 const ux_flow_step_t *ux_display_transaction_flow[MAX_NUM_STEPS + 1];
 
+/**
+ * Add a step for each attribute type of the transaction, Conflicts attributes share a single step.
+ *
+ * @return index of the step after the attribute steps.
+ */
+static uint8_t add_attribute_steps(uint8_t index) {
+    const transaction_t *tx = &G_context.tx_info.transaction;
+    bool conflicts = false;
+
+    for (uint8_t i = 0; i < tx->attributes_size; i++) {
+        switch (tx->attributes[i].type) {
+            case HIGH_PRIORITY:
+                ux_display_transaction_flow[index++] = &ux_display_high_priority_step;
+                break;
+            case NOT_VALID_BEFORE:
+                ux_display_transaction_flow[index++] = &ux_display_not_valid_before_step;
+                break;
+            case NOTARY_ASSISTED:
+                ux_display_transaction_flow[index++] = &ux_display_notary_assisted_step;
+                break;
+            case ORACLE_RESPONSE:
+                ux_display_transaction_flow[index++] = &ux_display_oracle_response_step;
+                break;
+            case CONFLICTS:
+                if (!conflicts) {
+                    ux_display_transaction_flow[index++] = &ux_display_conflicts_step;
+                    conflicts = true;
+                }
+                break;
+        }
+    }
+
+    return index;
+}
+
 void create_transaction_flow() {
     uint8_t index = 0;
-    if (!G_context.tx_info.transaction.is_system_asset_transfer) {
+    bool is_transfer = G_context.tx_info.transaction.is_system_asset_transfer;
+    if (!is_transfer && !G_context.tx_info.large_script) {
         // We currently do not support transaction scripts that are not NEO or GAS transfers
         // will be added later
         ux_display_transaction_flow[index++] = &ux_display_no_arbitrary_script_step;
@@ -228,8 +349,13 @@ void create_transaction_flow() {
 
     ux_display_transaction_flow[index++] = &ux_display_review_step;
 
-    ux_display_transaction_flow[index++] = &ux_display_dst_address_step;
-    ux_display_transaction_flow[index++] = &ux_display_token_amount_step;
+    if (is_transfer) {
+        ux_display_transaction_flow[index++] = &ux_display_dst_address_step;
+        ux_display_transaction_flow[index++] = &ux_display_token_amount_step;
+    } else {  // large script mode, the script is reviewed by its size and hash
+        ux_display_transaction_flow[index++] = &ux_display_script_size_step;
+        ux_display_transaction_flow[index++] = &ux_display_script_hash_step;
+    }
 
     ux_display_transaction_flow[index++] = &ux_display_network_step;
     ux_display_transaction_flow[index++] = &ux_display_systemfee_step;
@@ -246,38 +372,70 @@ void create_transaction_flow() {
     // dynamics screens when applicable
     ux_display_transaction_flow[index++] = &ux_lower_delimiter;
 
+    index = add_attribute_steps(index);
+    if (G_context.tx_info.signer_paths.count > 0) {
+        ux_display_transaction_flow[index++] = &ux_display_sign_as_step;
+    }
     ux_display_transaction_flow[index++] = &ux_display_approve_step;
     ux_display_transaction_flow[index++] = &ux_display_reject_step;
     ux_display_transaction_flow[index++] = FLOW_END_STEP;
 }
 
-int ui_display_transaction() {
-    if (G_context.req_type != CONFIRM_TRANSACTION || G_context.state != STATE_PARSED) {
-        G_context.state = STATE_NONE;
-        return io_send_sw(SW_BAD_STATE);
-    }
+/**
+ * Build the review flow that starts with the header screens.
+ *
+ * @return index of the first step that depends on the complete transaction.
+ */
+uint8_t create_progressive_flow(bool complete) {
+    uint8_t index = 0;
 
-    if (G_context.tx_info.transaction.is_system_asset_transfer) {
-        memset(g_address, 0, sizeof(g_address));
-        snprintf(g_address, sizeof(g_address), "%s", G_context.tx_info.transaction.dst_address);
-        PRINTF("Destination address: %s\n", g_address);
+    // the header screens come first, they can be shown before the script is received
+    ux_display_transaction_flow[index++] = &ux_display_review_step;
+    ux_display_transaction_flow[index++] = &ux_display_network_step;
+    ux_display_transaction_flow[index++] = &ux_display_systemfee_step;
+    ux_display_transaction_flow[index++] = &ux_display_networkfee_step;
+    ux_display_transaction_flow[index++] = &ux_display_total_fee;
+    ux_display_transaction_flow[index++] = &ux_display_validuntilblock_step;
+    ux_display_transaction_flow[index++] = &ux_upper_delimiter;
+    ux_display_transaction_flow[index++] = &ux_display_generic;
+    ux_display_transaction_flow[index++] = &ux_lower_delimiter;
 
-        memset(g_text, 0, sizeof(g_text));
-        char token_amount[30] = {0};
-        if (!format_fpu64(token_amount,
-                          sizeof(token_amount),
-                          (uint64_t) G_context.tx_info.transaction.amount,
-                          G_context.tx_info.transaction.is_neo ? 0 : 8)) {
-            return io_send_sw(SW_DISPLAY_TOKEN_TRANSFER_AMOUNT_FAIL);
+    uint8_t gate = index;
+    if (!complete) {
+        // no approve step until the whole transaction is parsed and hashed
+        ux_display_transaction_flow[index++] = &ux_display_wait_step;
+        ux_display_transaction_flow[index++] = &ux_display_reject_step;
+    } else if (G_context.tx_info.transaction.is_system_asset_transfer) {
+        ux_display_transaction_flow[index++] = &ux_display_dst_address_step;
+        ux_display_transaction_flow[index++] = &ux_display_token_amount_step;
+        index = add_attribute_steps(index);
+        if (G_context.tx_info.signer_paths.count > 0) {
+            ux_display_transaction_flow[index++] = &ux_display_sign_as_step;
+        }
+        ux_display_transaction_flow[index++] = &ux_display_approve_step;
+        ux_display_transaction_flow[index++] = &ux_display_reject_step;
+    } else if (G_context.tx_info.large_script) {
+        ux_display_transaction_flow[index++] = &ux_display_script_size_step;
+        ux_display_transaction_flow[index++] = &ux_display_script_hash_step;
+        index = add_attribute_steps(index);
+        if (G_context.tx_info.signer_paths.count > 0) {
+            ux_display_transaction_flow[index++] = &ux_display_sign_as_step;
         }
-        snprintf(g_text,
-                 sizeof(g_text),
-                 "%s %.*s",
-                 G_context.tx_info.transaction.is_neo ? "NEO" : "GAS",
-                 sizeof(token_amount),
-                 token_amount);
+        ux_display_transaction_flow[index++] = &ux_display_approve_step;
+        ux_display_transaction_flow[index++] = &ux_display_reject_step;
+    } else {
+        ux_display_transaction_flow[index++] = &ux_display_no_arbitrary_script_step;
+        ux_display_transaction_flow[index++] = &ux_display_abort_step;
     }
+    ux_display_transaction_flow[index++] = FLOW_END_STEP;
 
+    return gate;
+}
+
+/**
+ * Format the network magic of the global context into g_network.
+ */
+static void format_network() {
     // We'll try to give more user friendly names for known networks
     if (G_context.network_magic == NETWORK_MAINNET) {
         snprintf(g_network, sizeof(g_network), "%s", "MainNet");
@@ -287,13 +445,155 @@ int ui_display_transaction() {
         snprintf(g_network, sizeof(g_network), "%d", G_context.network_magic);
     }
     PRINTF("Target network: %s\n", g_network);
+}
+
+/**
+ * Format the size and SHA-256 of the script for display in large script mode.
+ */
+static void format_script() {
+    snprintf(g_script_size, sizeof(g_script_size), "%u bytes", G_context.tx_info.transaction.script_size);
+
+    memset(g_script_hash, 0, sizeof(g_script_hash));
+    format_hex(G_context.tx_info.transaction.script_hash,
+               sizeof(G_context.tx_info.transaction.script_hash),
+               g_script_hash,
+               sizeof(g_script_hash));
+    PRINTF("Script hash: %s\n", g_script_hash);
+}
+
+/**
+ * Format the token transfer of the transaction for display.
+ *
+ * @return SW_OK if success, a status word indicating the failure otherwise.
+ */
+static uint16_t format_transfer() {
+    if (!G_context.tx_info.transaction.is_system_asset_transfer) {
+        if (G_context.tx_info.large_script) {
+            format_script();
+        }
+        return SW_OK;
+    }
+
+    memset(g_address, 0, sizeof(g_address));
+    snprintf(g_address, sizeof(g_address), "%s", G_context.tx_info.transaction.dst_address);
+    PRINTF("Destination address: %s\n", g_address);
+
+    memset(g_text, 0, sizeof(g_text));
+    char token_amount[30] = {0};
+    if (!format_fpu64(token_amount,
+                      sizeof(token_amount),
+                      (uint64_t) G_context.tx_info.transaction.amount,
+                      G_context.tx_info.transaction.is_neo ? 0 : 8)) {
+        return SW_DISPLAY_TOKEN_TRANSFER_AMOUNT_FAIL;
+    }
+    snprintf(g_text,
+             sizeof(g_text),
+             "%s %.*s",
+             G_context.tx_info.transaction.is_neo ? "NEO" : "GAS",
+             sizeof(token_amount),
+             token_amount);
+
+    return SW_OK;
+}
+
+/**
+ * Format the signers of the transaction that sign with the BIP44 paths of a multi signer SIGN_TX for display,
+ * numbered like the signer screens.
+ */
+static void format_sign_as() {
+    const signer_paths_t *signer_paths = &G_context.tx_info.signer_paths;
+    size_t len = 0;
+
+    memset(g_sign_as, 0, sizeof(g_sign_as));
+    len += snprintf(g_sign_as, sizeof(g_sign_as), "Signer");
+    for (uint8_t i = 0; i < signer_paths->count && len < sizeof(g_sign_as); i++) {
+        len += snprintf(g_sign_as + len,
+                        sizeof(g_sign_as) - len,
+                        "%s%d",
+                        i == 0 ? " " : ", ",
+                        signer_paths->signer_indexes[i] + 1);
+    }
+}
+
+static const char *oracle_code_name(uint8_t code) {
+    switch (code) {
+        case ORACLE_SUCCESS:
+            return "Success";
+        case ORACLE_PROTOCOL_NOT_SUPPORTED:
+            return "Protocol not supported";
+        case ORACLE_CONSENSUS_UNREACHABLE:
+            return "Consensus unreachable";
+        case ORACLE_NOT_FOUND:
+            return "Not found";
+        case ORACLE_TIMEOUT:
+            return "Timeout";
+        case ORACLE_FORBIDDEN:
+            return "Forbidden";
+        case ORACLE_RESPONSE_TOO_LARGE:
+            return "Response too large";
+        case ORACLE_INSUFFICIENT_FUNDS:
+            return "Insufficient funds";
+        case ORACLE_CONTENT_TYPE_NOT_SUPPORTED:
+            return "Content type not supported";
+        default:
+            return "Error";
+    }
+}
+
+/**
+ * Format the data of the transaction attributes for display.
+ */
+static void format_attributes() {
+    const transaction_t *tx = &G_context.tx_info.transaction;
+    size_t conflicts_len = 0;
+
+    memset(g_conflicts, 0, sizeof(g_conflicts));
+    for (uint8_t i = 0; i < tx->attributes_size; i++) {
+        const uint8_t *data = tx->attributes_data + tx->attributes[i].offset;
+        switch (tx->attributes[i].type) {
+            case NOT_VALID_BEFORE:
+                snprintf(g_not_valid_before, sizeof(g_not_valid_before), "%d", read_u32_le(data, 0));
+                break;
+            case NOTARY_ASSISTED:
+                snprintf(g_notary_keys, sizeof(g_notary_keys), "%d keys", data[0]);
+                break;
+            case ORACLE_RESPONSE: {
+                char id[21] = {0};
+                format_u64(id, sizeof(id), read_u64_le(data, 0));
+                snprintf(g_oracle_response,
+                         sizeof(g_oracle_response),
+                         "ID %s, %s, %d bytes",
+                         id,
+                         oracle_code_name(data[8]),
+                         read_u16_le(data, 9));
+                break;
+            }
+            case CONFLICTS:
+                conflicts_len += snprintf(g_conflicts + conflicts_len,
+                                          sizeof(g_conflicts) - conflicts_len,
+                                          "%s%.*H",
+                                          conflicts_len == 0 ? "" : " ",
+                                          UINT256_LEN,
+                                          data);
+                break;
+        }
+    }
+}
+
+/**
+ * Format the fixed header fields of the transaction (network, fees and valid until block) for display.
+ *
+ * @return SW_OK if success, a status word indicating the failure otherwise.
+ */
+static uint16_t format_header() {
+    format_network();
 
     // System fee is a value multiplied by 100_000_000 to create 8 decimals stored in an int.
     // It is not allowed to be negative so we can safely cast it to uint64_t
     memset(g_system_fee, 0, sizeof(g_system_fee));
     char system_fee[30] = {0};
     if (!format_fpu64(system_fee, sizeof(system_fee), (uint64_t) G_context.tx_info.transaction.system_fee, 8)) {
-        return io_send_sw(SW_DISPLAY_SYSTEM_FEE_FAIL);
+        return SW_DISPLAY_SYSTEM_FEE_FAIL;
     }
     snprintf(g_system_fee, sizeof(g_system_fee), "GAS %.*s", sizeof(system_fee), system_fee);
     PRINTF("System fee: %s GAS\n", system_fee);
@@ -302,7 +602,7 @@ int ui_display_transaction() {
     memset(g_network_fee, 0, sizeof(g_network_fee));
     char network_fee[30] = {0};
     if (!format_fpu64(network_fee, sizeof(network_fee), (uint64_t) G_context.tx_info.transaction.network_fee, 8)) {
-        return io_send_sw(SW_DISPLAY_NETWORK_FEE_FAIL);
+        return SW_DISPLAY_NETWORK_FEE_FAIL;
     }
     snprintf(g_network_fee, sizeof(g_network_fee), "GAS %.*s", sizeof(network_fee), network_fee);
     PRINTF("Network fee: %s GAS\n", network_fee);
@@ -315,13 +615,72 @@ int ui_display_transaction() {
                       sizeof(total_fee),
                       (uint64_t) G_context.tx_info.transaction.network_fee + G_context.tx_info.transaction.system_fee,
                       8)) {
-        return io_send_sw(SW_DISPLAY_TOTAL_FEE_FAIL);
+        return SW_DISPLAY_TOTAL_FEE_FAIL;
     }
     snprintf(g_total_fees, sizeof(g_total_fees), "GAS %.*s", sizeof(total_fee), total_fee);
 
     snprintf(g_valid_until_block, sizeof(g_valid_until_block), "%d", G_context.tx_info.transaction.valid_until_block);
     PRINTF("Valid until: %s\n", g_valid_until_block);
 
+    return SW_OK;
+}
+
+int ui_display_transaction_header() {
+    if (G_context.req_type != CONFIRM_TRANSACTION || G_context.state != STATE_MAGIC_OK) {
+        G_context.state = STATE_NONE;
+        return io_send_sw(SW_BAD_STATE);
+    }
+
+    uint16_t sw = format_header();
+    if (sw != SW_OK) {
+        G_context.state = STATE_NONE;
+        return io_send_sw(sw);
+    }
+
+    g_validate_callback = &ui_action_validate_transaction;
+    reset_signer_display_state();
+
+    // start display, the host keeps sending the rest of the transaction meanwhile
+    create_progressive_flow(false);
+    ux_flow_init(0, ux_display_transaction_flow, NULL);
+
+    return io_send_sw(SW_OK);
+}
+
+int ui_display_transaction() {
+    if (G_context.req_type != CONFIRM_TRANSACTION || G_context.state != STATE_PARSED) {
+        G_context.state = STATE_NONE;
+        return io_send_sw(SW_BAD_STATE);
+    }
+
+    uint16_t sw = format_transfer();
+    if (sw != SW_OK) {
+        return io_send_sw(sw);
+    }
+    format_sign_as();
+    format_attributes();
+
+    if (G_context.tx_info.review_started) {
+        // The header screens are already shown, replace the waiting screen with the rest of the review
+        // and keep the user on the screen they are reading.
+        // The signer screens are generated on the fly and can't be re-entered half way, continue after them.
+        unsigned int current = G_ux.flow_stack[G_ux.stack_count - 1].index;
+        uint8_t gate = create_progressive_flow(true);
+        if (current >= gate || ux_display_transaction_flow[current] == &ux_upper_delimiter ||
+            ux_display_transaction_flow[current] == &ux_display_generic ||
+            ux_display_transaction_flow[current] == &ux_lower_delimiter) {
+            current = gate;
+        }
+        ux_flow_init(0, ux_display_transaction_flow, ux_display_transaction_flow[current]);
+
+        return 0;
+    }
+
+    sw = format_header();
+    if (sw != SW_OK) {
+        return io_send_sw(sw);
+    }
+
     g_validate_callback = &ui_action_validate_transaction;
     reset_signer_display_state();
 
@@ -332,29 +691,379 @@ int ui_display_transaction() {
     return 0;
 }
 
-int parse_scope_name(witness_scope_e scope) {
-    size_t len = 0;
-    if (scope == NONE) {
-        return snprintf(g_scope, sizeof(g_scope), "%s", "None");
+UX_STEP_NOCB(ux_display_review_batch_step,
+             pnn,
+             {
+                 &C_icon_eye,
+                 "Review",
+                 "Batch",
+             });
+
+UX_STEP_NOCB(ux_display_batch_count_step,
+             bnnn_paging,
+             {
+                 .title = "Transactions",
+                 .text = g_batch_count,
+             });
+
+UX_STEP_NOCB(ux_display_neo_total_step,
+             bnnn_paging,
+             {
+                 .title = "Total NEO",
+                 .text = g_neo_total,
+             });
+
+UX_STEP_NOCB(ux_display_gas_total_step,
+             bnnn_paging,
+             {
+                 .title = "Total GAS",
+                 .text = g_gas_total,
+             });
+
+UX_STEP_NOCB(ux_display_batch_validuntilblock_step,
+             bnnn_paging,
+             {
+                 .title = "Valid until, max",
+                 .text = g_valid_until_block,
+             });
+
+// FLOW to display the summary of a batch:
+// #1 screen: eye icon + "Review Batch"
+// #2 screen: number of transactions
+// #3 screen: destination address, or "Multiple" if the transfers go to different addresses
+// #4 screen: NEO transferred in total
+// #5 screen: GAS transferred in total
+// #6 screen: target network
+// #7 screen: fees of all transactions
+// #8 screen: highest valid until height of the transactions
+// #9 screen: approve button
+// #10 screen: reject button
+UX_FLOW(ux_display_batch_flow,
+        &ux_display_review_batch_step,
+        &ux_display_batch_count_step,
+        &ux_display_dst_address_step,
+        &ux_display_neo_total_step,
+        &ux_display_gas_total_step,
+        &ux_display_network_step,
+        &ux_display_total_fee,
+        &ux_display_batch_validuntilblock_step,
+        &ux_display_approve_step,
+        &ux_display_reject_step);
+
+int ui_display_batch() {
+    const batch_ctx_t *batch = &G_context.tx_info.batch;
+
+    if (G_context.req_type != CONFIRM_BATCH || G_context.state != STATE_PARSED) {
+        G_context.state = STATE_NONE;
+        return io_send_sw(SW_BAD_STATE);
+    }
+
+    snprintf(g_batch_count, sizeof(g_batch_count), "%d", batch->count);
+
+    memset(g_address, 0, sizeof(g_address));
+    if (batch->mixed_destinations) {
+        snprintf(g_address, sizeof(g_address), "%s", "Multiple");
+    } else {
+        snprintf(g_address, sizeof(g_address), "%.*s", ADDRESS_LEN, batch->dst_address);
+    }
+
+    char amount[30] = {0};
+    if (!format_fpu64(amount, sizeof(amount), batch->neo_total, 0)) {
+        return io_send_sw(SW_DISPLAY_TOKEN_TRANSFER_AMOUNT_FAIL);
+    }
+    snprintf(g_neo_total, sizeof(g_neo_total), "NEO %.*s", sizeof(amount), amount);
+
+    memset(amount, 0, sizeof(amount));
+    if (!format_fpu64(amount, sizeof(amount), batch->gas_total, 8)) {
+        return io_send_sw(SW_DISPLAY_TOKEN_TRANSFER_AMOUNT_FAIL);
+    }
+    snprintf(g_gas_total, sizeof(g_gas_total), "GAS %.*s", sizeof(amount), amount);
+
+    format_network();
+
+    memset(amount, 0, sizeof(amount));
+    if (!format_fpu64(amount, sizeof(amount), batch->fees_total, 8)) {
+        return io_send_sw(SW_DISPLAY_TOTAL_FEE_FAIL);
+    }
+    snprintf(g_total_fees, sizeof(g_total_fees), "GAS %.*s", sizeof(amount), amount);
+
+    snprintf(g_valid_until_block, sizeof(g_valid_until_block), "%u", batch->max_valid_until_block);
+
+    g_validate_callback = &ui_action_validate_batch;
+
+    ux_flow_init(0, ux_display_batch_flow, NULL);
+
+    return 0;
+}
+
+UX_STEP_NOCB(ux_display_export_xpub_step,
+             pnn,
+             {
+                 &C_icon_eye,
+                 "Export",
+                 "Account xpub",
+             });
+
+UX_STEP_NOCB(ux_display_xpub_account_step,
+             bnnn_paging,
+             {
+                 .title = "Account",
+                 .text = g_text,
+             });
+
+UX_STEP_NOCB(ux_display_xpub_warning_step,
+             nn,
+             {
+                 "Reveals all",
+                 "account addresses",
+             });
+
+// FLOW to display an account extended public key export:
+// #1 screen: eye icon + "Export Account xpub"
+// #2 screen: account index
+// #3 screen: privacy notice, the host can link every address of the account
+// #4 screen: approve button
+// #5 screen: reject button
+UX_FLOW(ux_display_xpub_flow,
+        &ux_display_export_xpub_step,
+        &ux_display_xpub_account_step,
+        &ux_display_xpub_warning_step,
+        &ux_display_approve_step,
+        &ux_display_reject_step);
+
+int ui_display_account_xpub() {
+    if (G_context.req_type != CONFIRM_XPUB || G_context.state != STATE_NONE) {
+        G_context.state = STATE_NONE;
+        return io_send_sw(SW_BAD_STATE);
+    }
+
+    // same numbering as the BIP44 path, without the hardened bit
+    snprintf(g_text, sizeof(g_text), "%d", G_context.bip44_path[2] & 0x7FFFFFFF);
+
+    g_validate_callback = &ui_action_validate_xpub;
+
+    ux_flow_init(0, ux_display_xpub_flow, NULL);
+
+    return 0;
+}
+
+UX_STEP_NOCB(ux_display_confirm_multisig_step,
+             pnn,
+             {
+                 &C_icon_eye,
+                 "Confirm",
+                 "Multisig address",
+             });
+
+UX_STEP_NOCB(ux_display_multisig_signers_step,
+             bnnn_paging,
+             {
+                 .title = "Signatures",
+                 .text = g_text,
+             });
+
+// FLOW to display the address of a multi signature account:
+// #1 screen: eye icon + "Confirm Multisig address"
+// #2 screen: m of n signatures
+// #3 screen: display address
+// #4 screen: approve button
+// #5 screen: reject button
+UX_FLOW(ux_display_multisig_flow,
+        &ux_display_confirm_multisig_step,
+        &ux_display_multisig_signers_step,
+        &ux_display_address_step,
+        &ux_display_approve_step,
+        &ux_display_reject_step);
+
+int ui_display_multisig_address() {
+    if (G_context.req_type != CONFIRM_MULTISIG || G_context.state != STATE_PARSED) {
+        G_context.state = STATE_NONE;
+        return io_send_sw(SW_BAD_STATE);
+    }
+
+    snprintf(g_text, sizeof(g_text), "%d of %d", G_context.multisig.m, G_context.multisig.n);
+
+    memset(g_address, 0, sizeof(g_address));
+    script_hash_to_address(g_address, ADDRESS_LEN, G_context.multisig.script_hash);
+
+    g_validate_callback = &ui_action_validate_multisig;
+
+    ux_flow_init(0, ux_display_multisig_flow, NULL);
+
+    return 0;
+}
+
+UX_STEP_NOCB(ux_display_review_policy_step,
+             pnn,
+             {
+                 &C_icon_eye,
+                 "Review",
+                 "Spending policy",
+             });
+
+UX_STEP_NOCB(ux_display_max_amount_step,
+             bnnn_paging,
+             {
+                 .title = "Max per transfer",
+                 .text = g_max_amount,
+             });
+
+UX_STEP_NOCB(ux_display_max_total_step,
+             bnnn_paging,
+             {
+                 .title = "Max in total",
+                 .text = g_max_total,
+             });
+
+UX_STEP_NOCB(ux_display_max_fee_step,
+             bnnn_paging,
+             {
+                 .title = "Max fee per tx",
+                 .text = g_total_fees,
+             });
+
+UX_STEP_NOCB(ux_display_max_count_step,
+             bnnn_paging,
+             {
+                 .title = "Max transactions",
+                 .text = g_batch_count,
+             });
+
+UX_STEP_NOCB(ux_display_max_validuntilblock_step,
+             bnnn_paging,
+             {
+                 .title = "Valid until height",
+                 .text = g_valid_until_block,
+             });
+
+// FLOW to display a spending policy:
+// #1 screen: eye icon + "Review Spending policy"
+// #2 screen: destination address
+// #3 screen: maximum amount of a single transfer
+// #4 screen: maximum amount of all transfers together
+// #5 screen: maximum fee of a single transaction
+// #6 screen: maximum number of transactions
+// #7 screen: highest valid until block height of the transactions
+// #8 screen: target network
+// #9 screen: approve button
+// #10 screen: reject button
+UX_FLOW(ux_display_policy_flow,
+        &ux_display_review_policy_step,
+        &ux_display_dst_address_step,
+        &ux_display_max_amount_step,
+        &ux_display_max_total_step,
+        &ux_display_max_fee_step,
+        &ux_display_max_count_step,
+        &ux_display_max_validuntilblock_step,
+        &ux_display_network_step,
+        &ux_display_approve_step,
+        &ux_display_reject_step);
+
+int ui_display_policy() {
+    if (G_context.req_type != CONFIRM_POLICY || G_context.state != STATE_PARSED) {
+        G_context.state = STATE_NONE;
+        return io_send_sw(SW_BAD_STATE);
+    }
+
+    memset(g_address, 0, sizeof(g_address));
+    snprintf(g_address, sizeof(g_address), "%.*s", ADDRESS_LEN, G_policy.dst_address);
+
+    const char *asset = G_policy.is_neo ? "NEO" : "GAS";
+    uint8_t decimals = G_policy.is_neo ? 0 : 8;
+
+    char amount[30] = {0};
+    if (!format_fpu64(amount, sizeof(amount), G_policy.max_amount, decimals)) {
+        return io_send_sw(SW_DISPLAY_TOKEN_TRANSFER_AMOUNT_FAIL);
+    }
+    snprintf(g_max_amount, sizeof(g_max_amount), "%s %.*s", asset, sizeof(amount), amount);
+
+    memset(amount, 0, sizeof(amount));
+    if (!format_fpu64(amount, sizeof(amount), G_policy.max_total, decimals)) {
+        return io_send_sw(SW_DISPLAY_TOKEN_TRANSFER_AMOUNT_FAIL);
     }
+    snprintf(g_max_total, sizeof(g_max_total), "%s %.*s", asset, sizeof(amount), amount);
 
-    if (scope == GLOBAL) {
-        return snprintf(g_scope, sizeof(g_scope), "%s", "Global");
+    memset(amount, 0, sizeof(amount));
+    if (!format_fpu64(amount, sizeof(amount), G_policy.max_fee, 8)) {
+        return io_send_sw(SW_DISPLAY_TOTAL_FEE_FAIL);
     }
+    snprintf(g_total_fees, sizeof(g_total_fees), "GAS %.*s", sizeof(amount), amount);
+
+    snprintf(g_batch_count, sizeof(g_batch_count), "%d", G_policy.max_count);
+    snprintf(g_valid_until_block, sizeof(g_valid_until_block), "%d", G_policy.max_valid_until_block);
 
-    if (scope & CALLED_BY_ENTRY) {
-        len += snprintf(&g_scope[len], sizeof(g_scope), "%s", "By Entry,");
-    };
+    format_network();
 
-    if (scope & CUSTOM_CONTRACTS) {
-        len += snprintf(&g_scope[len], sizeof(g_scope), "%s", "Contracts,");
-    };
+    g_validate_callback = &ui_action_validate_policy;
 
-    if (scope & CUSTOM_GROUPS) {
-        len += snprintf(&g_scope[len], sizeof(g_scope), "%s", "Groups,");
-    };
+    ux_flow_init(0, ux_display_policy_flow, NULL);
 
-    return len - 1;  // take of the comma
+    return 0;
+}
+
+static const char *condition_name(uint8_t type) {
+    switch (type) {
+        case CONDITION_BOOLEAN:
+            return "Boolean";
+        case CONDITION_NOT:
+            return "Not";
+        case CONDITION_AND:
+            return "And";
+        case CONDITION_OR:
+            return "Or";
+        case CONDITION_SCRIPT_HASH:
+            return "Script hash";
+        case CONDITION_GROUP:
+            return "Group";
+        case CONDITION_CALLED_BY_ENTRY:
+            return "Called by entry";
+        case CONDITION_CALLED_BY_CONTRACT:
+            return "Called by contract";
+        case CONDITION_CALLED_BY_GROUP:
+            return "Called by group";
+        default:
+            return "Unknown";
+    }
+}
+
+/**
+ * Format a witness rule item of a signer. A rule shows its action, the conditions show their nesting level
+ * followed by their name and value, e.g. "And of 2" or "Called by contract <hash>".
+ */
+static void format_rule_item(uint8_t signer, uint16_t item) {
+    const signer_t *s = &G_context.tx_info.transaction.signers[signer];
+    uint8_t rule;
+    const uint8_t *kind = transaction_signer_rule_item(&G_context.tx_info.transaction, signer, item, &rule);
+    uint8_t level = WITNESS_RULE_ITEM_LEVEL(*kind);
+    uint8_t type = WITNESS_RULE_ITEM_TYPE(*kind);
+
+    if (level == 0) {
+        snprintf(g_title, sizeof(g_title), "Rule %d of %d", rule + 1, s->rules_size);
+        snprintf(g_text, sizeof(g_text), "%s", (type == WITNESS_RULE_ALLOW) ? "Allow if" : "Deny if");
+        return;
+    }
+
+    snprintf(g_title, sizeof(g_title), "Rule %d, level %d", rule + 1, level);
+    switch (type) {
+        case CONDITION_BOOLEAN:
+            snprintf(g_text, sizeof(g_text), "%s %s", condition_name(type), kind[1] ? "true" : "false");
+            break;
+        case CONDITION_AND:
+        case CONDITION_OR:
+            snprintf(g_text, sizeof(g_text), "%s of %d", condition_name(type), kind[1]);
+            break;
+        case CONDITION_SCRIPT_HASH:
+        case CONDITION_CALLED_BY_CONTRACT:
+            snprintf(g_text, sizeof(g_text), "%s %.*H", condition_name(type), UINT160_LEN, kind + 1);
+            break;
+        case CONDITION_GROUP:
+        case CONDITION_CALLED_BY_GROUP:
+            snprintf(g_text, sizeof(g_text), "%s %.*H", condition_name(type), ECPOINT_LEN, kind + 1);
+            break;
+        default:
+            snprintf(g_text, sizeof(g_text), "%s", condition_name(type));
+            break;
+    }
 }
 
 // This is a special function you must call for bnnn_paging to work properly in an edgecase.
@@ -366,17 +1075,17 @@ void bnnn_paging_edgecase() {
     ux_flow_relayout();
 }
 
-static enum e_signer_state signer_property[7] = {START, INDEX, ACCOUNT, SCOPE, CONTRACTS, GROUPS, END};
+static enum e_signer_state signer_property[8] = {START, INDEX, ACCOUNT, SCOPE, CONTRACTS, GROUPS, RULES, END};
 
 void next_prop() {
     uint8_t *idx = &display_ctx.p_index;
-    signer_t signer = G_context.tx_info.transaction.signers[display_ctx.s_index];
+    const signer_t *signer = &G_context.tx_info.transaction.signers[display_ctx.s_index];
 
     if (*idx < (uint8_t) CONTRACTS) (*idx)++;
 
     if (signer_property[*idx] == CONTRACTS) {
         // we start at -1
-        if (display_ctx.c_index + 1 < signer.allowed_contracts_size) {
+        if (display_ctx.c_index + 1 < signer->allowed_contracts_size) {
             display_ctx.c_index++;
             return;  // let it display the contract
         }
@@ -385,11 +1094,20 @@ void next_prop() {
     }
     if (signer_property[*idx] == GROUPS) {
         // we start at -1
-        if (display_ctx.g_index + 1 < signer.allowed_groups_size) {
+        if (display_ctx.g_index + 1 < signer->allowed_groups_size) {
             display_ctx.g_index++;
             return;  // let it display the group
         }
         display_ctx.g_index++;
+        (*idx)++;  // advance state to RULES
+    }
+    if (signer_property[*idx] == RULES) {
+        // we start at -1
+        if (display_ctx.r_index + 1 < signer->rule_items_size) {
+            display_ctx.r_index++;
+            return;  // let it display the rule item
+        }
+        display_ctx.r_index++;
         (*idx)++;  // advance state to END
     }
 
@@ -404,6 +1122,7 @@ void next_prop() {
             display_ctx.s_index++;
             display_ctx.c_index = -1;
             display_ctx.g_index = -1;
+            display_ctx.r_index = -1;
             *idx = (uint8_t) START;
             next_prop();
         }
@@ -412,7 +1131,7 @@ void next_prop() {
 
 void prev_prop() {
     uint8_t *idx = &display_ctx.p_index;
-    signer_t signer = G_context.tx_info.transaction.signers[display_ctx.s_index];
+    const signer_t *signer = &G_context.tx_info.transaction.signers[display_ctx.s_index];
 
     // from first dynamic screen, go back to first static
     if (display_ctx.s_index == 0 && signer_property[*idx] == INDEX) {
@@ -422,7 +1141,17 @@ void prev_prop() {
 
     // from static screen below lower_delimiter screen, go to last dynamic
     if (signer_property[*idx] == END) {
-        (*idx)--;  // reverse to GROUPS
+        (*idx)--;  // reverse to RULES
+    }
+
+    if (signer_property[*idx] == RULES) {
+        if (display_ctx.r_index > 0) {
+            display_ctx.r_index--;
+            return;  // let it display the rule item
+        }
+        display_ctx.r_index--;  // make sure we end up at -1 as that is what next_prop() expects
+                                // when going forward
+        (*idx)--;               // advance state to GROUPS
     }
 
     if (signer_property[*idx] == GROUPS) {
@@ -450,10 +1179,11 @@ void prev_prop() {
     if (signer_property[*idx] == START) {
         if (display_ctx.s_index > 0) {
             display_ctx.s_index--;
-            signer = G_context.tx_info.transaction.signers[display_ctx.s_index];
+            signer = &G_context.tx_info.transaction.signers[display_ctx.s_index];
             *idx = (uint8_t) END;  // set property index to end
-            display_ctx.g_index = signer.allowed_groups_size;
-            display_ctx.c_index = signer.allowed_contracts_size;
+            display_ctx.r_index = signer->rule_items_size;
+            display_ctx.g_index = signer->allowed_groups_size;
+            display_ctx.c_index = signer->allowed_contracts_size;
             prev_prop();
         }
     }
@@ -466,7 +1196,7 @@ bool get_next_data(enum e_direction direction) {
         prev_prop();
     }
 
-    signer_t s = G_context.tx_info.transaction.signers[display_ctx.s_index];
+    const signer_t *s = &G_context.tx_info.transaction.signers[display_ctx.s_index];
     enum e_signer_state display = signer_property[display_ctx.p_index];
 
     if (display_ctx.s_index == G_context.tx_info.transaction.signers_size &&
@@ -486,25 +1216,45 @@ bool get_next_data(enum e_direction direction) {
         }
         case ACCOUNT: {
             snprintf(g_title, sizeof(g_title), "Account");
-            snprintf(g_text, sizeof(g_text), "%.*H", 20, s.account);
+            snprintf(g_text,
+                     sizeof(g_text),
+                     "%.*H",
+                     UINT160_LEN,
+                     transaction_signer_account(&G_context.tx_info.transaction, display_ctx.s_index));
             return true;
         }
         case SCOPE: {
             snprintf(g_title, sizeof(g_title), "Scope");
-            int scope_size = parse_scope_name(s.scope);
-            snprintf(g_text, sizeof(g_text), "%.*s", scope_size, g_scope);
+            if (scope_format(s->scope, g_scope, sizeof(g_scope)) < 0) {
+                return false;
+            }
+            snprintf(g_text, sizeof(g_text), "%s", g_scope);
             return true;
         }
         case CONTRACTS: {
-            s = G_context.tx_info.transaction.signers[display_ctx.s_index];
-            snprintf(g_title, sizeof(g_title), "Contract %d of %d", display_ctx.c_index + 1, s.allowed_contracts_size);
-            snprintf(g_text, sizeof(g_text), "%.*H", UINT160_LEN, s.allowed_contracts[display_ctx.c_index]);
+            snprintf(g_title, sizeof(g_title), "Contract %d of %d", display_ctx.c_index + 1, s->allowed_contracts_size);
+            snprintf(g_text,
+                     sizeof(g_text),
+                     "%.*H",
+                     UINT160_LEN,
+                     transaction_signer_contract(&G_context.tx_info.transaction,
+                                                 display_ctx.s_index,
+                                                 display_ctx.c_index));
             return true;
         }
         case GROUPS: {
-            s = G_context.tx_info.transaction.signers[display_ctx.s_index];
-            snprintf(g_title, sizeof(g_title), "Group %d of %d", display_ctx.g_index + 1, s.allowed_groups_size);
-            snprintf(g_text, sizeof(g_text), "%.*H", ECPOINT_LEN, s.allowed_groups[display_ctx.g_index]);
+            snprintf(g_title, sizeof(g_title), "Group %d of %d", display_ctx.g_index + 1, s->allowed_groups_size);
+            snprintf(g_text,
+                     sizeof(g_text),
+                     "%.*H",
+                     ECPOINT_LEN,
+                     transaction_signer_group(&G_context.tx_info.transaction,
+                                              display_ctx.s_index,
+                                              display_ctx.g_index));
+            return true;
+        }
+        case RULES: {
+            format_rule_item(display_ctx.s_index, display_ctx.r_index);
             return true;
         }
         case END: {
@@ -23,6 +23,48 @@ int ui_display_address(void);
  */
 int ui_display_transaction(void);
 
+/**
+ * Start the review with the header of the transaction (network, fees, valid until block and signers) while the
+ * rest of it is still being received. Screens depending on the script and the approve button are added by
+ * ui_display_transaction() once the whole transaction is parsed and hashed.
+ *
+ * @return zero or positive integer if success, negative integer otherwise.
+ *
+ */
+int ui_display_transaction_header(void);
+
+/**
+ * Display the summary of a batch of transactions on the device and ask confirmation to sign all of them.
+ *
+ * @return 0 if success, negative integer otherwise.
+ *
+ */
+int ui_display_batch(void);
+
+/**
+ * Display the account of an extended public key export on the device and ask confirmation to export it.
+ *
+ * @return 0 if success, negative integer otherwise.
+ *
+ */
+int ui_display_account_xpub(void);
+
+/**
+ * Display the address of a multi signature account on the device and ask confirmation to send it.
+ *
+ * @return 0 if success, negative integer otherwise.
+ *
+ */
+int ui_display_multisig_address(void);
+
+/**
+ * Display a spending policy on the device and ask confirmation to sign matching transfers without review.
+ *
+ * @return 0 if success, negative integer otherwise.
+ *
+ */
+int ui_display_policy(void);
+
 /**
  * State of the dynamic display flow.
  * Use to keep track of whether we are displaying screens that are inside the
@@ -39,7 +81,7 @@ enum e_direction { DIRECTION_FORWARD, DIRECTION_BACKWARD };
  * State indicating which Signer property to show
  *
  */
-enum e_signer_state { START = 0, INDEX = 1, ACCOUNT = 2, SCOPE = 3, CONTRACTS = 4, GROUPS = 5, END = 6 };
+enum e_signer_state { START = 0, INDEX = 1, ACCOUNT = 2, SCOPE = 3, CONTRACTS = 4, GROUPS = 5, RULES = 6, END = 7 };
 
 extern struct display_ctx_t display_ctx;
 
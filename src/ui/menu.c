@@ -16,26 +16,34 @@
  *  limitations under the License.
  *****************************************************************************/
 
+#include <string.h>  // strncpy
+
 #include "os.h"
 #include "ux.h"
 #include "glyphs.h"
 
 #include "../globals.h"
+#include "../common/pubkey_store.h"
 #include "menu.h"
 
+static char g_pubkey_store_status[9];  // "Enabled" or "Disabled" + \0
+
 UX_STEP_NOCB(ux_menu_ready_step, pn, {&C_badge_neo, "Wake up NEO.."});
 UX_STEP_NOCB(ux_menu_version_step, bn, {"Version", APPVERSION});
+UX_STEP_CB(ux_menu_settings_step, pb, ui_menu_settings(), {&C_icon_coggle, "Settings"});
 UX_STEP_CB(ux_menu_about_step, pb, ui_menu_about(), {&C_icon_certificate, "About"});
 UX_STEP_VALID(ux_menu_exit_step, pb, os_sched_exit(-1), {&C_icon_dashboard_x, "Quit"});
 
 // FLOW for the main menu:
 // #1 screen: ready
 // #2 screen: version of the app
-// #3 screen: about submenu
-// #4 screen: quit
+// #3 screen: settings submenu
+// #4 screen: about submenu
+// #5 screen: quit
 UX_FLOW(ux_menu_main_flow,
         &ux_menu_ready_step,
         &ux_menu_version_step,
+        &ux_menu_settings_step,
         &ux_menu_about_step,
         &ux_menu_exit_step,
         FLOW_LOOP);
@@ -59,3 +67,42 @@ UX_FLOW(ux_menu_about_flow, &ux_menu_info_step, &ux_menu_back_step, FLOW_LOOP);
 void ui_menu_about() {
     ux_flow_init(0, ux_menu_about_flow, NULL);
 }
+
+static void toggle_pubkey_store(void);
+static void clear_pubkey_store(void);
+
+UX_STEP_CB(ux_menu_pubkey_store_step, bn, toggle_pubkey_store(), {"Key cache", g_pubkey_store_status});
+UX_STEP_CB(ux_menu_clear_pubkey_store_step, pb, clear_pubkey_store(), {&C_icon_crossmark, "Clear key cache"});
+
+// FLOW for the settings submenu:
+// #1 screen: enable or disable the public key cache in flash
+// #2 screen: erase the public key cache in flash
+// #3 screen: back button to main menu
+UX_FLOW(ux_menu_settings_flow,
+        &ux_menu_pubkey_store_step,
+        &ux_menu_clear_pubkey_store_step,
+        &ux_menu_back_step,
+        FLOW_LOOP);
+
+static void toggle_pubkey_store() {
+    uint8_t enabled = N_storage.pubkey_store_enabled ? 0 : 1;
+
+    if (!enabled) {  // keys stay in flash only as long as the user wants the cache
+        pubkey_store_clear(N_pubkey_store);
+    }
+    nvm_write((void *) &N_storage.pubkey_store_enabled, &enabled, sizeof(enabled));
+
+    ui_menu_settings();
+}
+
+static void clear_pubkey_store() {
+    pubkey_store_clear(N_pubkey_store);
+    ui_menu_main();
+}
+
+void ui_menu_settings() {
+    strncpy(g_pubkey_store_status,
+            N_storage.pubkey_store_enabled ? "Enabled" : "Disabled",
+            sizeof(g_pubkey_store_status));
+    ux_flow_init(0, ux_menu_settings_flow, NULL);
+}
@@ -1,10 +1,15 @@
 #pragma once
 
 /**
- * Show main menu (ready screen, version, about, quit).
+ * Show main menu (ready screen, version, settings, about, quit).
  */
 void ui_menu_main(void);
 
+/**
+ * Show settings submenu (public key cache in flash).
+ */
+void ui_menu_settings(void);
+
 /**
  * Show about submenu (copyright, date).
  */
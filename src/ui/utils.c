@@ -28,6 +28,11 @@
  */
 #define VERIFICATION_SCRIPT_LENGTH 40
 
+void compress_public_key(const uint8_t public_key[static 64], uint8_t out[static 33]) {
+    out[0] = ((public_key[63] & 1) ? 0x03 : 0x02);
+    memmove(&out[1], public_key, 32);
+}
+
 bool create_signature_redeem_script(uint8_t* public_key, uint8_t* out, size_t out_len) {
     if (out_len != VERIFICATION_SCRIPT_LENGTH) {
         return false;
@@ -35,8 +40,7 @@ bool create_signature_redeem_script(uint8_t* public_key, uint8_t* out, size_t ou
 
     // we first have to compress the public key
     uint8_t compressed_key[33];
-    compressed_key[0] = ((public_key[63] & 1) ? 0x03 : 0x02);
-    memmove(&compressed_key[1], public_key, 32);
+    compress_public_key(public_key, compressed_key);
 
     out[0] = 0xc;   // OpCode.PUSHDATA1;
     out[1] = 0x21;  // data size, 33 bytes for compressed public key
@@ -84,20 +88,23 @@ void script_hash_to_address(char* out, size_t out_len, const unsigned char* scri
     base58_encode(address, sizeof(address), out, out_len);
 }
 
+void script_hash_from_pubkey(uint8_t public_key[static 64], uint8_t out[static 20]) {
+    unsigned char verification_script[VERIFICATION_SCRIPT_LENGTH];
+
+    // can't fail, the script buffer has the exact length
+    create_signature_redeem_script(public_key, verification_script, sizeof(verification_script));
+    public_key_hash160(verification_script, sizeof(verification_script), out);
+}
+
 bool address_from_pubkey(uint8_t public_key[static 64], uint8_t* out, size_t out_len) {
     // we need to go through 3 steps
     // 1. create a verification script with the public key
     // 2. create a script hash of the verification script (using sha256 + ripemd160)
     // 3. base58check encode the NEO account version + script hash to get the address
-    unsigned char verification_script[VERIFICATION_SCRIPT_LENGTH];
     unsigned char script_hash[UINT160_LEN];
 
-    // step 1
-    if (!create_signature_redeem_script(public_key, verification_script, sizeof(verification_script))) {
-        return false;
-    }
-    // step 2
-    public_key_hash160(verification_script, sizeof(verification_script), script_hash);
+    // step 1 and 2
+    script_hash_from_pubkey(public_key, script_hash);
     // step 3
     script_hash_to_address(out, out_len, script_hash);
     return true;
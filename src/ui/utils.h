@@ -8,4 +8,19 @@
 
 bool address_from_pubkey(uint8_t public_key[static 64], uint8_t* out, size_t out_len);
 
+/**
+ * Script hash of the standard single signature verification script of 'public_key'.
+ */
+void script_hash_from_pubkey(uint8_t public_key[static 64], uint8_t out[static 20]);
+
+/**
+ * Compress 'public_key' (X || Y) to the 33 byte prefix || X form.
+ */
+void compress_public_key(const uint8_t public_key[static 64], uint8_t out[static 33]);
+
+/**
+ * Script hash of a verification script: ripemd160(sha256(in)).
+ */
+void public_key_hash160(unsigned char* in, unsigned short inlen, unsigned char* out);
+
 void script_hash_to_address(char* out, size_t out_len, const unsigned char* script_hash);
\ No newline at end of file
@@ -1,5 +1,5 @@
 import struct
-from typing import Tuple
+from typing import Dict, List, Optional, Tuple
 
 from ledgercomm import Transport
 
@@ -73,25 +73,146 @@ class BoilerplateCommand:
 
         return response.decode("ascii")
 
-    def get_public_key(self, bip44_path: str, display: bool = False) -> bytes:
+    def get_public_key(self, bip44_path: str, display: bool = False, key_format: int = 0) -> bytes:
         sw, response = self.transport.exchange_raw(
-            self.builder.get_public_key(bip44_path=bip44_path)
+            self.builder.get_public_key(bip44_path=bip44_path, key_format=key_format)
         )  # type: int, bytes
 
         if sw != 0x9000:
             raise DeviceException(error_code=sw, ins=InsType.INS_GET_PUBLIC_KEY)
 
-        assert len(response) == 65 # 04 + 64 bytes of uncompressed key
+        # 04 + 64 bytes of uncompressed key, compressed key, script hash or base58 address
+        assert len(response) == [65, 33, 20, 34][key_format]
 
         return response
 
-    def sign_tx(self, bip44_path: str, transaction: Transaction, network_magic: int, button: Button) -> Tuple[int, bytes]:
+    def get_public_keys(self, account_path: str, start: int, count: int, script_hashes: bool = False) -> List[bytes]:
+        """Compressed public keys (or script hashes) of address indexes start..start + count - 1 of 'account_path'."""
+        item_len: int = 20 if script_hashes else 33
+        items: List[bytes] = []
+
+        while len(items) < count:
+            sw, response = self.transport.exchange_raw(
+                self.builder.get_public_keys(bip44_path=f"{account_path}/{start + len(items)}",
+                                             count=count - len(items),
+                                             script_hashes=script_hashes)
+            )  # type: int, bytes
+
+            if sw != 0x9000:
+                raise DeviceException(error_code=sw, ins=InsType.INS_GET_PUBLIC_KEYS)
+
+            n: int = response[0]
+            assert n > 0 and len(response) == 1 + n * item_len
+            items += [response[1 + i * item_len:1 + (i + 1) * item_len] for i in range(n)]
+
+        return items
+
+    def get_cache_stats(self, reset: bool = False) -> Tuple[int, int, int, int]:
+        """Hits, misses, size and used entries of the public key cache."""
+        sw, response = self.transport.exchange_raw(
+            self.builder.get_cache_stats(reset=reset)
+        )  # type: int, bytes
+
+        if sw != 0x9000:
+            raise DeviceException(error_code=sw, ins=InsType.INS_GET_CACHE_STATS)
+
+        assert len(response) == 10
+
+        hits, misses, size, used = struct.unpack(">IIBB", response)
+        return hits, misses, size, used
+
+    def discover_addresses(self, account_path: str, start: int, count: int,
+                           script_hashes: List[bytes]) -> Dict[bytes, int]:
+        """Address indexes within start..start + count - 1 of 'account_path' of the given script hashes."""
+        found: Dict[bytes, int] = {}
+        end: int = start + count
+        index: int = start
+
+        while index < end and len(found) < len(script_hashes):
+            targets: List[bytes] = [h for h in script_hashes if h not in found]
+            sw, response = self.transport.exchange_raw(
+                self.builder.discover_addresses(bip44_path=f"{account_path}/{index}",
+                                                count=end - index,
+                                                script_hashes=targets)
+            )  # type: int, bytes
+
+            if sw != 0x9000:
+                raise DeviceException(error_code=sw, ins=InsType.INS_DISCOVER_ADDRESSES)
+
+            # resume from the index where the device stopped scanning
+            next_index, n = struct.unpack(">IB", response[:5])
+            assert index < next_index <= end and len(response) == 5 + n * 5
+            for i in range(n):
+                target, address_index = struct.unpack(">BI", response[5 + i * 5:10 + i * 5])
+                found[targets[target]] = address_index
+            index = next_index
+
+        return found
+
+    def get_multisig_address(self, m: int, public_keys: List[bytes], own_bip44_path: Optional[str] = None,
+                             button: Optional[Button] = None) -> Tuple[bytes, str]:
+        """Script hash and address of the m-of-n account, displayed for confirmation when 'button' is given."""
+        sw: int
+        response: bytes = b""
+
+        for is_last, chunk in self.builder.get_multisig_address(m=m,
+                                                                public_keys=public_keys,
+                                                                own_bip44_path=own_bip44_path,
+                                                                display=button is not None):
+            self.transport.send_raw(chunk)
+
+            if is_last and button is not None:
+                # Confirm Multisig address
+                button.right_click()
+                # Signatures
+                button.right_click()
+                # Address
+                button.right_click()
+                button.right_click()
+                button.right_click()
+                # Approve
+                button.both_click()
+
+            sw, response = self.transport.recv()  # type: int, bytes
+
+            if sw != 0x9000:
+                raise DeviceException(error_code=sw, ins=InsType.INS_GET_MULTISIG_ADDRESS)
+
+        assert len(response) == 20 + 34
+
+        return response[:20], response[20:].decode()
+
+    def get_account_xpub(self, account: int, button: Button, approve: bool = True) -> Tuple[bytes, bytes]:
+        """Compressed public key and chain code of m/44'/888'/account'."""
+        self.transport.send_raw(self.builder.get_account_xpub(account=account))
+        # Export Account xpub, Account, privacy notice
+        button.right_click()
+        button.right_click()
+        button.right_click()
+        if not approve:
+            button.right_click()
+        # Approve or Reject
+        button.both_click()
+
+        sw, response = self.transport.recv()  # type: int, bytes
+
+        if sw != 0x9000:
+            raise DeviceException(error_code=sw, ins=InsType.INS_GET_ACCOUNT_XPUB)
+
+        assert len(response) == 33 + 32
+
+        return response[:33], response[33:]
+
+    def sign_tx(self, bip44_path: str, transaction: Transaction, network_magic: int, button: Button,
+                single_start: bool = False, raw_signature: bool = False, approve: bool = True) -> Tuple[int, bytes]:
         sw: int
         response: bytes = b""
 
         for is_last, chunk in self.builder.sign_tx(bip44_path=bip44_path,
                                                    transaction=transaction,
-                                                   network_magic=network_magic):
+                                                   network_magic=network_magic,
+                                                   single_start=single_start,
+                                                   raw_signature=raw_signature):
             self.transport.send_raw(chunk)
 
             if is_last:
@@ -113,13 +234,47 @@ class BoilerplateCommand:
                 button.right_click()
                 # Valid until
                 button.right_click()
-                # Signer 1 of 1
+                # for each signer: Signer n of m, Account 1/3, 2/3, 3/3, Scope
+                for _ in range(len(transaction.signers) * 5):
+                    button.right_click()
+                if not approve:
+                    button.right_click()
+                # Approve or Reject
+                button.both_click()
+
+            sw, response = self.transport.recv()  # type: int, bytes
+
+            if sw != 0x9000:
+                raise DeviceException(error_code=sw, ins=InsType.INS_SIGN_TX)
+
+        return response
+
+    def sign_tx_multi_signer(self, bip44_paths: List[str], transaction: Transaction, network_magic: int,
+                             button: Button) -> List[Tuple[int, bytes]]:
+        """Signer index and DER signature for each BIP44 path, for a transaction with one signer per path."""
+        sw: int
+        response: bytes = b""
+
+        for is_last, chunk in self.builder.sign_tx(bip44_path=bip44_paths[0],
+                                                   transaction=transaction,
+                                                   network_magic=network_magic,
+                                                   signer_bip44_paths=bip44_paths):
+            self.transport.send_raw(chunk)
+
+            if is_last:
+                # Review Transaction
                 button.right_click()
-                # Account 1/3, 2/3, 3/3
+                # Destination address
                 button.right_click()
                 button.right_click()
                 button.right_click()
-                # Scope
+                # Token Amount, Target network, System fee, Network fee, Total fees, Valid until
+                for _ in range(6):
+                    button.right_click()
+                # for each signer: Signer n of m, Account 1/3, 2/3, 3/3, Scope
+                for _ in range(len(transaction.signers) * 5):
+                    button.right_click()
+                # Signing as
                 button.right_click()
                 # Approve
                 button.both_click()
@@ -129,4 +284,142 @@ class BoilerplateCommand:
             if sw != 0x9000:
                 raise DeviceException(error_code=sw, ins=InsType.INS_SIGN_TX)
 
+        signatures: List[Tuple[int, bytes]] = []
+        offset: int = 1
+        for _ in range(response[0]):
+            signer_index, sig_len = response[offset], response[offset + 1]
+            signatures.append((signer_index, response[offset + 2:offset + 2 + sig_len]))
+            offset += 2 + sig_len
+        assert offset == len(response)
+
+        return signatures
+
+    def sign_batch(self, bip44_path: str, transactions: List[Transaction], network_magic: int,
+                   button: Button) -> List[bytes]:
+        apdus = list(self.builder.sign_batch(bip44_path=bip44_path,
+                                             transactions=transactions,
+                                             network_magic=network_magic))
+
+        for i, apdu in enumerate(apdus):
+            self.transport.send_raw(apdu)
+
+            if i == len(apdus) - 1:
+                # Review Batch
+                button.right_click()
+                # Transactions
+                button.right_click()
+                # Destination address
+                button.right_click()
+                button.right_click()
+                button.right_click()
+                # Total NEO
+                button.right_click()
+                # Total GAS
+                button.right_click()
+                # Target network
+                button.right_click()
+                # Total fees
+                button.right_click()
+                # Valid until, max
+                button.right_click()
+                # Approve
+                button.both_click()
+
+            sw, response = self.transport.recv()  # type: int, bytes
+
+            if sw != 0x9000:
+                raise DeviceException(error_code=sw, ins=InsType.INS_SIGN_BATCH)
+
+        count: int = response[0]
+        signatures: List[bytes] = []
+        for index in range(count):
+            sw, response = self.transport.exchange_raw(self.builder.get_batch_signature(index))
+
+            if sw != 0x9000:
+                raise DeviceException(error_code=sw, ins=InsType.INS_SIGN_BATCH)
+
+            signatures.append(response)
+
+        return signatures
+
+    def set_policy(self, bip44_path: str, network_magic: int, dst_script_hash: bytes, is_neo: bool,
+                   max_amount: int, max_total: int, max_fee: int, max_valid_until_block: int,
+                   max_count: int, button: Button) -> None:
+        self.transport.send_raw(self.builder.set_policy(bip44_path=bip44_path,
+                                                        network_magic=network_magic,
+                                                        dst_script_hash=dst_script_hash,
+                                                        is_neo=is_neo,
+                                                        max_amount=max_amount,
+                                                        max_total=max_total,
+                                                        max_fee=max_fee,
+                                                        max_valid_until_block=max_valid_until_block,
+                                                        max_count=max_count))
+        # Review Spending policy
+        button.right_click()
+        # Destination address
+        button.right_click()
+        button.right_click()
+        button.right_click()
+        # Max per transfer, Max in total, Max fee per tx, Max transactions, Valid until height
+        button.right_click()
+        button.right_click()
+        button.right_click()
+        button.right_click()
+        button.right_click()
+        # Target network
+        button.right_click()
+        # Approve
+        button.both_click()
+
+        sw, _ = self.transport.recv()  # type: int, bytes
+
+        if sw != 0x9000:
+            raise DeviceException(error_code=sw, ins=InsType.INS_SET_POLICY)
+
+    def clear_policy(self) -> None:
+        sw, _ = self.transport.exchange_raw(self.builder.clear_policy())  # type: int, bytes
+
+        if sw != 0x9000:
+            raise DeviceException(error_code=sw, ins=InsType.INS_SET_POLICY)
+
+    def sign_tx_without_review(self, bip44_path: str, transaction: Transaction, network_magic: int) -> bytes:
+        """Sign a transaction that is covered by the spending policy, no buttons are involved."""
+        sw: int = 0x9000
+        response: bytes = b""
+
+        for _, chunk in self.builder.sign_tx(bip44_path=bip44_path,
+                                             transaction=transaction,
+                                             network_magic=network_magic):
+            sw, response = self.transport.exchange_raw(chunk)
+
+            if sw != 0x9000:
+                raise DeviceException(error_code=sw, ins=InsType.INS_SIGN_TX)
+
+        return response
+
+    def get_last_signature(self, bip44_path: str, network_magic: int, tx_hash: bytes) -> bytes:
+        sw, response = self.transport.exchange_raw(
+            self.builder.get_last_signature(bip44_path=bip44_path, network_magic=network_magic, tx_hash=tx_hash)
+        )  # type: int, bytes
+
+        if sw != 0x9000:
+            raise DeviceException(error_code=sw, ins=InsType.INS_GET_LAST_SIGNATURE)
+
+        return response
+
+    def parse_tx(self, tx_data: bytes) -> bytes:
+        """Run the device parser on a raw transaction, returns the summary as sent by the device."""
+        sw: int = 0x9000
+        response: bytes = b""
+
+        for _, chunk in self.builder.parse_tx(tx_data):
+            sw, response = self.transport.exchange_raw(chunk)
+
+            if sw != 0x9000:
+                raise DeviceException(error_code=sw, ins=InsType.INS_PARSE_TX)
+
+            # the device answers with a summary as soon as the transaction failed to parse
+            if response:
+                break
+
         return response
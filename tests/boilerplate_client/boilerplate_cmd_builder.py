@@ -1,13 +1,32 @@
 import enum
 import logging
 import struct
-from typing import List, Tuple, Union, Iterator, cast
+from typing import List, Optional, Tuple, Union, Iterator, cast
 
 from boilerplate_client.utils import bip44_path_from_string
 from neo3.network import node, payloads
 from neo3.core import serialization
 
 MAX_APDU_LEN: int = 255
+# transaction chunks use P1 2..P1_MAX and wrap around for longer transactions
+P1_FIRST_TX_CHUNK: int = 0x02
+P1_MAX: int = 0x7F
+# BIP44 path, network magic and the start of the transaction in a single APDU
+P1_START_WITH_TX: int = 0x80
+# first SIGN_TX APDU flag accepting scripts of any size
+P2_LARGE_SCRIPT: int = 0x01
+# first SIGN_TX APDU flag to receive r || s and the transaction hash
+P2_RAW_SIGNATURE: int = 0x02
+# first SIGN_TX APDU flag with several BIP44 paths, each of a signer of the transaction
+P2_MULTI_SIGNER: int = 0x04
+# SIGN_BATCH steps
+P1_BATCH_START: int = 0x00
+P1_BATCH_TX: int = 0x01
+P1_BATCH_REVIEW: int = 0x02
+P1_BATCH_GET_SIGNATURE: int = 0x03
+# SET_POLICY
+P1_POLICY_SET: int = 0x00
+P1_POLICY_CLEAR: int = 0x01
 
 
 def chunkify(data: bytes, chunk_len: int) -> Iterator[Tuple[bool, bytes]]:
@@ -34,6 +53,15 @@ class InsType(enum.IntEnum):
     INS_GET_VERSION = 0x01
     INS_SIGN_TX = 0x02
     INS_GET_PUBLIC_KEY = 0x04
+    INS_SIGN_BATCH = 0x05
+    INS_SET_POLICY = 0x06
+    INS_GET_LAST_SIGNATURE = 0x07
+    INS_PARSE_TX = 0x08
+    INS_GET_PUBLIC_KEYS = 0x09
+    INS_GET_CACHE_STATS = 0x0A
+    INS_GET_ACCOUNT_XPUB = 0x0B
+    INS_DISCOVER_ADDRESSES = 0x0C
+    INS_GET_MULTISIG_ADDRESS = 0x0D
 
 
 class BoilerplateCommandBuilder:
@@ -143,13 +171,15 @@ class BoilerplateCommandBuilder:
                               p2=0x00,
                               cdata=b"")
 
-    def get_public_key(self, bip44_path: str) -> bytes:
+    def get_public_key(self, bip44_path: str, key_format: int = 0) -> bytes:
         """Command builder for GET_PUBLIC_KEY.
 
         Parameters
         ----------
         bip44_path: str
             String representation of BIP44 path.
+        key_format: int
+            Response format: 0 uncompressed, 1 compressed, 2 script hash, 3 address.
 
         Returns
         -------
@@ -162,12 +192,151 @@ class BoilerplateCommandBuilder:
 
         return self.serialize(cla=self.CLA,
                               ins=InsType.INS_GET_PUBLIC_KEY,
+                              p1=key_format,
+                              p2=0x00,
+                              cdata=cdata)
+
+    def get_public_keys(self, bip44_path: str, count: int, script_hashes: bool = False) -> bytes:
+        """Command builder for GET_PUBLIC_KEYS.
+
+        Parameters
+        ----------
+        bip44_path: str
+            String representation of the BIP44 path of the first address.
+        count: int
+            Number of consecutive address indexes.
+        script_hashes: bool
+            Return script hashes instead of compressed public keys.
+
+        Returns
+        -------
+        bytes
+            APDU command for GET_PUBLIC_KEYS.
+
+        """
+        bip44_paths: List[bytes] = bip44_path_from_string(bip44_path)
+        cdata: bytes = b"".join([*bip44_paths]) + struct.pack(">H", count)
+
+        return self.serialize(cla=self.CLA,
+                              ins=InsType.INS_GET_PUBLIC_KEYS,
+                              p1=0x01 if script_hashes else 0x00,
+                              p2=0x00,
+                              cdata=cdata)
+
+    def get_cache_stats(self, reset: bool = False) -> bytes:
+        """Command builder for GET_CACHE_STATS.
+
+        Parameters
+        ----------
+        reset: bool
+            Reset the counters after reading them.
+
+        Returns
+        -------
+        bytes
+            APDU command for GET_CACHE_STATS.
+
+        """
+        return self.serialize(cla=self.CLA,
+                              ins=InsType.INS_GET_CACHE_STATS,
+                              p1=0x01 if reset else 0x00,
+                              p2=0x00,
+                              cdata=b"")
+
+    def get_account_xpub(self, account: int) -> bytes:
+        """Command builder for GET_ACCOUNT_XPUB.
+
+        Parameters
+        ----------
+        account: int
+            Account index of m/44'/888'/account', without the hardened bit.
+
+        Returns
+        -------
+        bytes
+            APDU command for GET_ACCOUNT_XPUB.
+
+        """
+        cdata: bytes = struct.pack(">III", 0x8000002C, 0x80000378, 0x80000000 | account)
+
+        return self.serialize(cla=self.CLA,
+                              ins=InsType.INS_GET_ACCOUNT_XPUB,
                               p1=0x00,
                               p2=0x00,
                               cdata=cdata)
 
-    def sign_tx(self, bip44_path: str, transaction: payloads.Transaction, network_magic: int
-                ) -> Iterator[Tuple[bool, bytes]]:
+    def discover_addresses(self, bip44_path: str, count: int, script_hashes: List[bytes]) -> bytes:
+        """Command builder for DISCOVER_ADDRESSES.
+
+        Parameters
+        ----------
+        bip44_path: str
+            String representation of the BIP44 path of the first address to scan.
+        count: int
+            Number of consecutive address indexes to scan.
+        script_hashes: List[bytes]
+            Script hashes to search for.
+
+        Returns
+        -------
+        bytes
+            APDU command for DISCOVER_ADDRESSES.
+
+        """
+        bip44_paths: List[bytes] = bip44_path_from_string(bip44_path)
+        cdata: bytes = b"".join([*bip44_paths]) + struct.pack(">HB", count, len(script_hashes)) + \
+            b"".join(script_hashes)
+
+        return self.serialize(cla=self.CLA,
+                              ins=InsType.INS_DISCOVER_ADDRESSES,
+                              p1=0x00,
+                              p2=0x00,
+                              cdata=cdata)
+
+    def get_multisig_address(self, m: int, public_keys: List[bytes], own_bip44_path: Optional[str] = None,
+                             display: bool = False) -> Iterator[Tuple[bool, bytes]]:
+        """Command builder for GET_MULTISIG_ADDRESS.
+
+        Parameters
+        ----------
+        m: int
+            Number of signatures required.
+        public_keys: List[bytes]
+            Compressed public keys of the other signers, in any order.
+        own_bip44_path: Optional[str]
+            String representation of the BIP44 path of the device key, if it is one of the signers.
+        display: bool
+            Display the address on the device and ask confirmation.
+
+        Yields
+        -------
+        bytes
+            APDU commands for GET_MULTISIG_ADDRESS, with whether it is the last one.
+
+        """
+        n: int = len(public_keys) + (1 if own_bip44_path else 0)
+        header: bytes = struct.pack(">BBB", m, n, 1 if own_bip44_path else 0)
+        if own_bip44_path:
+            header += b"".join(bip44_path_from_string(own_bip44_path))
+
+        first_count: int = (MAX_APDU_LEN - len(header)) // 33
+        per_chunk: int = MAX_APDU_LEN // 33
+        chunks: List[List[bytes]] = [public_keys[:first_count]]
+        chunks += [public_keys[i:i + per_chunk] for i in range(first_count, len(public_keys), per_chunk)]
+
+        for i, chunk in enumerate(chunks):
+            is_last: bool = i == len(chunks) - 1
+            p2: int = (0x00 if is_last else 0x80) | (0x01 if display and i == 0 else 0x00)
+            yield is_last, self.serialize(cla=self.CLA,
+                                          ins=InsType.INS_GET_MULTISIG_ADDRESS,
+                                          p1=0x00 if i == 0 else 0x01,
+                                          p2=p2,
+                                          cdata=(header if i == 0 else b"") + b"".join(chunk))
+
+    def sign_tx(self, bip44_path: str, transaction: payloads.Transaction, network_magic: int,
+                single_start: bool = False, large_script: bool = False,
+                raw_signature: bool = False,
+                signer_bip44_paths: Optional[List[str]] = None) -> Iterator[Tuple[bool, bytes]]:
         """Command builder for INS_SIGN_TX.
 
         Parameters
@@ -176,6 +345,10 @@ class BoilerplateCommandBuilder:
             String representation of BIP44 path.
         transaction : payloads.Transaction
         network_magic: network magic for MainNet, TestNet or a private network.
+        single_start: send the BIP44 path, network magic and the start of the transaction in one APDU.
+        large_script: accept a script of any size, it is reviewed by its size and SHA-256.
+        raw_signature: respond with r || s and the transaction hash instead of a DER signature.
+        signer_bip44_paths: sign with each of these BIP44 paths instead of 'bip44_path', one signature per signer.
 
         Yields
         -------
@@ -186,34 +359,221 @@ class BoilerplateCommandBuilder:
         bip44_paths: List[bytes] = bip44_path_from_string(bip44_path)
         cdata: bytes = b"".join([*bip44_paths])
 
-        yield False, self.serialize(cla=self.CLA,
-                                    ins=InsType.INS_SIGN_TX,
-                                    p1=0x00,
-                                    p2=0x80,
-                                    cdata=cdata)
-
         magic = struct.pack("I", network_magic)
-        yield False, self.serialize(cla=self.CLA,
-                                    ins=InsType.INS_SIGN_TX,
-                                    p1=0x01,
-                                    p2=0x80,
-                                    cdata=magic)
+        options: int = (P2_LARGE_SCRIPT if large_script else 0x00) | (P2_RAW_SIGNATURE if raw_signature else 0x00)
+        if signer_bip44_paths:
+            options |= P2_MULTI_SIGNER
+            cdata = bytes([len(signer_bip44_paths)]) + b"".join(b"".join(bip44_path_from_string(path))
+                                                                for path in signer_bip44_paths)
 
         with serialization.BinaryWriter() as writer:
             transaction.serialize_unsigned(writer)
             tx: bytes = writer.to_array()
 
+        if single_start:
+            header: bytes = cdata + magic
+            first_len: int = MAX_APDU_LEN - len(header)
+            first_tx, tx = tx[:first_len], tx[first_len:]
+            is_last: bool = len(tx) == 0
+            yield is_last, self.serialize(cla=self.CLA,
+                                          ins=InsType.INS_SIGN_TX,
+                                          p1=P1_START_WITH_TX,
+                                          p2=(0x00 if is_last else 0x80) | options,
+                                          cdata=header + first_tx)
+            if is_last:
+                return
+        else:
+            yield False, self.serialize(cla=self.CLA,
+                                        ins=InsType.INS_SIGN_TX,
+                                        p1=0x00,
+                                        p2=0x80 | options,
+                                        cdata=cdata)
+
+            yield False, self.serialize(cla=self.CLA,
+                                        ins=InsType.INS_SIGN_TX,
+                                        p1=0x01,
+                                        p2=0x80,
+                                        cdata=magic)
+
         for i, (is_last, chunk) in enumerate(chunkify(tx, MAX_APDU_LEN)):
+            p1 = P1_FIRST_TX_CHUNK + i % (P1_MAX - P1_FIRST_TX_CHUNK + 1)
             if is_last:
                 yield True, self.serialize(cla=self.CLA,
                                            ins=InsType.INS_SIGN_TX,
-                                           p1=i + 2,
+                                           p1=p1,
                                            p2=0x00,
                                            cdata=chunk)
                 return
             else:
                 yield False, self.serialize(cla=self.CLA,
                                             ins=InsType.INS_SIGN_TX,
-                                            p1=i + 2,
+                                            p1=p1,
                                             p2=0x80,
                                             cdata=chunk)
+
+    def sign_batch(self, bip44_path: str, transactions: List[payloads.Transaction], network_magic: int
+                   ) -> Iterator[bytes]:
+        """Command builder for INS_SIGN_BATCH, up to and including the review of the batch.
+
+        Parameters
+        ----------
+        bip44_path : str
+            String representation of BIP44 path.
+        transactions : List[payloads.Transaction]
+            NEO or GAS transfers to sign.
+        network_magic: network magic for MainNet, TestNet or a private network.
+
+        Yields
+        -------
+        bytes
+            APDU command chunk for INS_SIGN_BATCH.
+
+        """
+        bip44_paths: List[bytes] = bip44_path_from_string(bip44_path)
+        cdata: bytes = b"".join([*bip44_paths]) + struct.pack("I", network_magic)
+
+        yield self.serialize(cla=self.CLA,
+                             ins=InsType.INS_SIGN_BATCH,
+                             p1=P1_BATCH_START,
+                             p2=0x00,
+                             cdata=cdata)
+
+        for transaction in transactions:
+            with serialization.BinaryWriter() as writer:
+                transaction.serialize_unsigned(writer)
+                tx: bytes = writer.to_array()
+
+            for is_last, chunk in chunkify(tx, MAX_APDU_LEN):
+                yield self.serialize(cla=self.CLA,
+                                     ins=InsType.INS_SIGN_BATCH,
+                                     p1=P1_BATCH_TX,
+                                     p2=0x00 if is_last else 0x80,
+                                     cdata=chunk)
+
+        yield self.serialize(cla=self.CLA,
+                             ins=InsType.INS_SIGN_BATCH,
+                             p1=P1_BATCH_REVIEW,
+                             p2=0x00,
+                             cdata=b"")
+
+    def get_batch_signature(self, index: int) -> bytes:
+        """Command builder for INS_SIGN_BATCH to get the signature of an approved transaction.
+
+        Parameters
+        ----------
+        index : int
+            Index of the transaction in the batch.
+
+        Returns
+        -------
+        bytes
+            APDU command for INS_SIGN_BATCH.
+
+        """
+        return self.serialize(cla=self.CLA,
+                              ins=InsType.INS_SIGN_BATCH,
+                              p1=P1_BATCH_GET_SIGNATURE,
+                              p2=0x00,
+                              cdata=index.to_bytes(1, byteorder="big"))
+
+    def set_policy(self, bip44_path: str, network_magic: int, dst_script_hash: bytes, is_neo: bool,
+                   max_amount: int, max_total: int, max_fee: int, max_valid_until_block: int,
+                   max_count: int) -> bytes:
+        """Command builder for INS_SET_POLICY.
+
+        Parameters
+        ----------
+        bip44_path : str
+            String representation of BIP44 path the policy can sign for.
+        network_magic : int
+            Network magic the policy can sign for.
+        dst_script_hash : bytes
+            Script hash of the only allowed destination (20 bytes).
+        is_neo : bool
+            Allowed asset, NEO if True, GAS otherwise.
+        max_amount, max_total, max_fee : int
+            Limits per transfer, for all transfers together and for the fees per transaction.
+        max_valid_until_block : int
+            Highest valid until block a transaction may use.
+        max_count : int
+            Maximum number of transactions signed under the policy.
+
+        Returns
+        -------
+        bytes
+            APDU command for INS_SET_POLICY.
+
+        """
+        bip44_paths: List[bytes] = bip44_path_from_string(bip44_path)
+        cdata: bytes = (b"".join([*bip44_paths]) +
+                        struct.pack("<I", network_magic) +
+                        dst_script_hash +
+                        (b"\x00" if is_neo else b"\x01") +
+                        struct.pack("<QQQIB", max_amount, max_total, max_fee, max_valid_until_block, max_count))
+
+        return self.serialize(cla=self.CLA,
+                              ins=InsType.INS_SET_POLICY,
+                              p1=P1_POLICY_SET,
+                              p2=0x00,
+                              cdata=cdata)
+
+    def clear_policy(self) -> bytes:
+        """Command builder for INS_SET_POLICY to remove the current policy.
+
+        Returns
+        -------
+        bytes
+            APDU command for INS_SET_POLICY.
+
+        """
+        return self.serialize(cla=self.CLA,
+                              ins=InsType.INS_SET_POLICY,
+                              p1=P1_POLICY_CLEAR,
+                              p2=0x00,
+                              cdata=b"")
+
+    def get_last_signature(self, bip44_path: str, network_magic: int, tx_hash: bytes) -> bytes:
+        """Command builder for INS_GET_LAST_SIGNATURE.
+
+        Parameters
+        ----------
+        bip44_path : str
+            String representation of the BIP44 path of the signing key.
+        network_magic : int
+            Network magic the transaction was signed for.
+        tx_hash : bytes
+            SHA-256 of the unsigned transaction (32 bytes, not reversed).
+
+        Returns
+        -------
+        bytes
+            APDU command for INS_GET_LAST_SIGNATURE.
+
+        """
+        return self.serialize(cla=self.CLA,
+                              ins=InsType.INS_GET_LAST_SIGNATURE,
+                              p1=0x00,
+                              p2=0x00,
+                              cdata=struct.pack("<I", network_magic) + tx_hash +
+                              b"".join(bip44_path_from_string(bip44_path)))
+
+    def parse_tx(self, tx_data: bytes) -> Iterator[Tuple[bool, bytes]]:
+        """Command builder for INS_PARSE_TX.
+
+        Parameters
+        ----------
+        tx_data : bytes
+            Raw unsigned transaction.
+
+        Yields
+        -------
+        bytes
+            APDU command chunk for INS_PARSE_TX.
+
+        """
+        for i, (is_last, chunk) in enumerate(chunkify(tx_data, MAX_APDU_LEN)):
+            yield is_last, self.serialize(cla=self.CLA,
+                                          ins=InsType.INS_PARSE_TX,
+                                          p1=0x00 if i == 0 else 0x01,
+                                          p2=0x00 if is_last else 0x80,
+                                          cdata=chunk)
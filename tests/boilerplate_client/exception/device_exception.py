@@ -18,6 +18,12 @@ class DeviceException(Exception):  # pylint: disable=too-few-public-methods
         0xB003: TxRejectSignError,
         0xB004: BadStateError,
         0xB005: SignatureFailError,
+        0xB006: BatchFullError,
+        0xB007: BatchTxNotSupportedError,
+        0xB008: InvalidPolicyError,
+        0xB009: SignatureNotFoundError,
+        0xB00A: InvalidMultisigError,
+        0xB00B: SignerNotFoundError,
         0xB100: BIP44BadPurposeError,
         0xB101: BIP44BadCoinTypeError,
         0xB102: BIP44BadAccountNotHardenedError,
@@ -54,6 +54,30 @@ class SignatureFailError(Exception):
     pass
 
 
+class BatchFullError(Exception):
+    pass
+
+
+class BatchTxNotSupportedError(Exception):
+    pass
+
+
+class InvalidPolicyError(Exception):
+    pass
+
+
+class SignatureNotFoundError(Exception):
+    pass
+
+
+class InvalidMultisigError(Exception):
+    pass
+
+
+class SignerNotFoundError(Exception):
+    pass
+
+
 class TxRejectSignError(Exception):
     pass
 
@@ -28,7 +28,7 @@ def test_bad_ins(cmd):
 def test_wrong_p1p2(cmd):
     sw, _ = cmd.transport.exchange(cla=0x80,
                                    ins=0x04, # fix to InsType.public key
-                                   p1=0x01,  # 0x01 instead of 0x00
+                                   p1=0x04,  # 0x04 is not a public key format
                                    p2=0x00,
                                    cdata=b"")
 
@@ -0,0 +1,62 @@
+import struct
+
+import pytest
+
+from neo3 import contracts, wallet
+from neo3.core import to_script_hash
+from neo3crypto import ECCCurve, ECPoint
+
+from boilerplate_client.boilerplate_cmd_builder import InsType
+from boilerplate_client.exception import DeviceException
+from boilerplate_client.exception.errors import InvalidMultisigError, WrongDataLengthError
+from boilerplate_client.utils import bip44_path_from_string
+
+
+def expected_script_hash(m: int, public_keys) -> bytes:
+    points = [ECPoint(key, ECCCurve.SECP256R1, validate=True) for key in public_keys]
+    return to_script_hash(contracts.Contract.create_multisig_redeem_script(m, points)).to_array()
+
+
+def test_multisig_address(cmd):
+    # more keys than fit in the first APDU, in the wrong order
+    public_keys = list(reversed(cmd.get_public_keys(account_path="m/44'/888'/3'/0", start=0, count=9)))
+
+    script_hash, address = cmd.get_multisig_address(m=6, public_keys=public_keys)
+
+    assert script_hash == expected_script_hash(6, public_keys)
+    assert wallet.Account.address_to_script_hash(address).to_array() == script_hash
+
+
+def test_multisig_address_own_key(cmd, button):
+    own_path = "m/44'/888'/0'/0/0"
+    own_key = cmd.get_public_key(bip44_path=own_path, key_format=1)
+    public_keys = cmd.get_public_keys(account_path="m/44'/888'/4'/0", start=0, count=2)
+
+    script_hash, address = cmd.get_multisig_address(m=2, public_keys=public_keys, own_bip44_path=own_path,
+                                                    button=button)
+
+    assert script_hash == expected_script_hash(2, public_keys + [own_key])
+    assert wallet.Account.address_to_script_hash(address).to_array() == script_hash
+
+
+def test_multisig_address_invalid(cmd):
+    public_keys = cmd.get_public_keys(account_path="m/44'/888'/4'/0", start=0, count=2)
+
+    with pytest.raises(InvalidMultisigError):
+        cmd.get_multisig_address(m=2, public_keys=[public_keys[0], public_keys[0]])
+
+    with pytest.raises(InvalidMultisigError):
+        cmd.get_multisig_address(m=3, public_keys=public_keys)
+
+
+def test_multisig_address_truncated_path(cmd):
+    # m, n and the own key flag make the data as long as a path, but the path itself is cut short
+    own_path = b"".join(bip44_path_from_string("m/44'/888'/0'/0/0"))
+    sw, _ = cmd.transport.exchange(cla=cmd.builder.CLA,
+                                   ins=InsType.INS_GET_MULTISIG_ADDRESS,
+                                   p1=0x00,
+                                   p2=0x00,
+                                   cdata=struct.pack(">BBB", 2, 2, 1) + own_path[:17])
+
+    with pytest.raises(WrongDataLengthError):
+        raise DeviceException(error_code=sw, ins=InsType.INS_GET_MULTISIG_ADDRESS)
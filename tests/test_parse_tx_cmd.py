@@ -0,0 +1,73 @@
+import struct
+from hashlib import sha256
+
+from neo3.network import payloads
+from neo3.core import types, serialization
+from neo3 import contracts, wallet, vm
+
+PARSING_OK = 1
+SYSTEM_FEE_VALUE_ERROR = -6
+INVALID_LENGTH_ERROR = -1
+
+
+def build_neo_transfer() -> bytes:
+    signer = payloads.Signer(account=types.UInt160.from_string("d7678dd97c000be3f33e9362e673101bac4ca654"),
+                             scope=payloads.WitnessScope.CALLED_BY_ENTRY)
+    witness = payloads.Witness(invocation_script=b'', verification_script=b'\x55')
+
+    from_account = wallet.Account.address_to_script_hash("NSiVJYZej4XsxG5CUpdwn7VRQk8iiiDMPM").to_array()
+    to_account = wallet.Account.address_to_script_hash("NU5unwNcWLqPM21cNCRP1LPuhxsTpYvNTf").to_array()
+    sb = vm.ScriptBuilder()
+    sb.emit_dynamic_call_with_args(contracts.NeoToken().hash, "transfer", [from_account, to_account, 11, None])
+
+    tx = payloads.Transaction(version=0,
+                              nonce=123,
+                              system_fee=456,
+                              network_fee=789,
+                              valid_until_block=1,
+                              attributes=[],
+                              signers=[signer],
+                              script=sb.to_array(),
+                              witnesses=[witness])
+
+    with serialization.BinaryWriter() as writer:
+        tx.serialize_unsigned(writer)
+        return writer.to_array()
+
+
+def test_parse_tx_summary(cmd):
+    tx_data = build_neo_transfer()
+
+    summary = cmd.parse_tx(tx_data)
+
+    status, offset, system_fee, network_fee, signers_count = struct.unpack("<bIqqB", summary[:22])
+    assert status == PARSING_OK
+    assert offset == len(tx_data)
+    assert system_fee == 456
+    assert network_fee == 789
+    assert signers_count == 1
+    assert summary[22] == payloads.WitnessScope.CALLED_BY_ENTRY
+
+    asset, amount = struct.unpack("<Bq", summary[23:32])
+    assert asset == 0x01  # NEO
+    assert amount == 11
+    assert summary[32:66] == b"NU5unwNcWLqPM21cNCRP1LPuhxsTpYvNTf"
+    assert summary[66:98] == sha256(tx_data).digest()
+    assert len(summary) == 98
+
+
+def test_parse_tx_reports_failing_offset(cmd):
+    tx_data = bytearray(build_neo_transfer())
+    tx_data[5:13] = struct.pack("<q", -1)  # negative system fee
+
+    summary = cmd.parse_tx(bytes(tx_data))
+
+    assert struct.unpack("<bI", summary) == (SYSTEM_FEE_VALUE_ERROR, 5)
+
+
+def test_parse_tx_trailing_data(cmd):
+    tx_data = build_neo_transfer()
+
+    summary = cmd.parse_tx(tx_data + b"\x00")
+
+    assert struct.unpack("<bI", summary) == (INVALID_LENGTH_ERROR, len(tx_data))
@@ -0,0 +1,108 @@
+import struct
+from hashlib import sha256
+from typing import List, Optional
+
+import pytest
+
+from ecdsa.curves import NIST256p
+from ecdsa.keys import VerifyingKey
+from ecdsa.util import sigdecode_der
+
+from neo3.network import payloads
+from neo3.core import types, serialization, to_script_hash
+from neo3 import contracts, wallet, vm
+from neo3crypto import ECCCurve, ECPoint
+
+from boilerplate_client.exception.errors import DenyError
+
+
+def account_of(cmd, bip44_path: str) -> types.UInt160:
+    public_key = ECPoint(cmd.get_public_key(bip44_path=bip44_path), ECCCurve.SECP256R1, validate=True)
+    return to_script_hash(contracts.Contract.create_signature_redeem_script(public_key))
+
+
+def build_gas_transfer(account: types.UInt160, amount: int, nonce: int, network_fee: int = 789,
+                       scope: payloads.WitnessScope = payloads.WitnessScope.CALLED_BY_ENTRY,
+                       extra_signers: Optional[List[payloads.Signer]] = None) -> payloads.Transaction:
+    signers = [payloads.Signer(account=account, scope=scope)] + (extra_signers or [])
+    witness = payloads.Witness(invocation_script=b'', verification_script=b'\x55')
+
+    from_account = wallet.Account.address_to_script_hash("NSiVJYZej4XsxG5CUpdwn7VRQk8iiiDMPM").to_array()
+    to_account = wallet.Account.address_to_script_hash("NU5unwNcWLqPM21cNCRP1LPuhxsTpYvNTf").to_array()
+    sb = vm.ScriptBuilder()
+    sb.emit_dynamic_call_with_args(contracts.GasToken().hash, "transfer", [from_account, to_account, amount, None])
+
+    return payloads.Transaction(version=0,
+                                nonce=nonce,
+                                system_fee=456,
+                                network_fee=network_fee,
+                                valid_until_block=1,
+                                attributes=[],
+                                signers=signers,
+                                script=sb.to_array(),
+                                witnesses=[witness])
+
+
+def test_policy_signs_matching_transfers(cmd, button):
+    bip44_path: str = "m/44'/888'/0'/0/0"
+    magic = 860833102
+
+    pub_key = cmd.get_public_key(bip44_path=bip44_path, display=False)  # type: bytes
+    pk: VerifyingKey = VerifyingKey.from_string(pub_key, curve=NIST256p, hashfunc=sha256)
+    account = account_of(cmd, bip44_path)
+
+    cmd.set_policy(bip44_path=bip44_path,
+                   network_magic=magic,
+                   dst_script_hash=wallet.Account.address_to_script_hash("NU5unwNcWLqPM21cNCRP1LPuhxsTpYvNTf").to_array(),
+                   is_neo=False,
+                   max_amount=2 * contracts.GasToken().factor,
+                   max_total=3 * contracts.GasToken().factor,
+                   max_fee=10000,
+                   max_valid_until_block=100,
+                   max_count=10,
+                   button=button)
+
+    try:
+        for nonce in range(3):
+            tx = build_gas_transfer(account, contracts.GasToken().factor, nonce)
+            der_sig = cmd.sign_tx_without_review(bip44_path=bip44_path, transaction=tx, network_magic=magic)
+
+            with serialization.BinaryWriter() as writer:
+                tx.serialize_unsigned(writer)
+                tx_data: bytes = writer.to_array()
+
+            assert pk.verify(signature=der_sig,
+                             data=struct.pack("I", magic) + sha256(tx_data).digest(),
+                             hashfunc=sha256,
+                             sigdecode=sigdecode_der) is True
+    finally:
+        cmd.clear_policy()
+
+
+def test_policy_reviews_wider_signers(cmd, button):
+    bip44_path: str = "m/44'/888'/0'/0/0"
+    magic = 860833102
+    account = account_of(cmd, bip44_path)
+
+    cmd.set_policy(bip44_path=bip44_path,
+                   network_magic=magic,
+                   dst_script_hash=wallet.Account.address_to_script_hash("NU5unwNcWLqPM21cNCRP1LPuhxsTpYvNTf").to_array(),
+                   is_neo=False,
+                   max_amount=2 * contracts.GasToken().factor,
+                   max_total=3 * contracts.GasToken().factor,
+                   max_fee=10000,
+                   max_valid_until_block=100,
+                   max_count=10,
+                   button=button)
+
+    other_signer = payloads.Signer(account=types.UInt160.from_string("d7678dd97c000be3f33e9362e673101bac4ca654"),
+                                   scope=payloads.WitnessScope.CALLED_BY_ENTRY)
+    try:
+        # a transfer within the policy limits is still reviewed, and rejected here, when the witness is Global
+        # or the transaction has other signers
+        for tx in (build_gas_transfer(account, contracts.GasToken().factor, 0, scope=payloads.WitnessScope.GLOBAL),
+                   build_gas_transfer(account, contracts.GasToken().factor, 1, extra_signers=[other_signer])):
+            with pytest.raises(DenyError):
+                cmd.sign_tx(bip44_path=bip44_path, transaction=tx, network_magic=magic, button=button, approve=False)
+    finally:
+        cmd.clear_policy()
@@ -1,5 +1,25 @@
+import hashlib
+import hmac
+import struct
+
+import pytest
+
+from ecdsa.curves import NIST256p
+from ecdsa.keys import VerifyingKey
+from neo3 import wallet
 from neo3crypto import ECCCurve, ECPoint
 
+from boilerplate_client.exception.errors import BIP44BadAddressError, DenyError
+
+
+def ckd_pub(public_key: bytes, chain_code: bytes, index: int):
+    """BIP32 non hardened child derivation of a compressed public key on secp256r1."""
+    digest = hmac.new(chain_code, public_key + struct.pack(">I", index), hashlib.sha512).digest()
+    point = NIST256p.generator * int.from_bytes(digest[:32], "big") + \
+        VerifyingKey.from_string(public_key, curve=NIST256p).pubkey.point
+    child = VerifyingKey.from_public_point(point, curve=NIST256p).to_string("compressed")
+    return child, digest[32:]
+
 def test_get_public_key(cmd):
     pub_key = cmd.get_public_key(
         bip44_path="m/44'/888'/0'/0/0",
@@ -16,3 +36,80 @@ def test_get_public_key(cmd):
 
     assert len(pub_key2) == 65
     assert ECPoint(pub_key2, ECCCurve.SECP256R1, validate=True)
+
+
+def test_get_public_key_formats(cmd):
+    path = "m/44'/888'/0'/0/1"
+    pub_key = cmd.get_public_key(bip44_path=path)
+
+    compressed = cmd.get_public_key(bip44_path=path, key_format=1)
+    assert compressed == bytes([0x03 if pub_key[64] & 1 else 0x02]) + pub_key[1:33]
+
+    script_hash = cmd.get_public_key(bip44_path=path, key_format=2)
+    assert script_hash == cmd.get_public_keys(account_path="m/44'/888'/0'/0", start=1, count=1,
+                                              script_hashes=True)[0]
+
+    address = cmd.get_public_key(bip44_path=path, key_format=3).decode()
+    assert wallet.Account.address_to_script_hash(address).to_array() == script_hash
+
+
+def test_get_public_keys(cmd):
+    # more than fit in a single response, so paging is exercised
+    keys = cmd.get_public_keys(account_path="m/44'/888'/0'/0", start=3, count=10)
+
+    assert len(keys) == 10
+    for i, key in enumerate(keys):
+        pub_key = cmd.get_public_key(bip44_path=f"m/44'/888'/0'/0/{3 + i}")
+        assert key == bytes([0x03 if pub_key[64] & 1 else 0x02]) + pub_key[1:33]
+
+    script_hashes = cmd.get_public_keys(account_path="m/44'/888'/0'/0", start=3, count=14, script_hashes=True)
+    assert len(script_hashes) == 14
+    assert len(set(script_hashes)) == 14
+
+
+def test_get_public_keys_out_of_range(cmd):
+    with pytest.raises(BIP44BadAddressError):
+        cmd.get_public_keys(account_path="m/44'/888'/0'/0", start=4990, count=11)
+
+
+def test_get_public_key_cache(cmd):
+    cmd.get_cache_stats(reset=True)
+
+    first = cmd.get_public_key(bip44_path="m/44'/888'/2'/0/7")
+    second = cmd.get_public_key(bip44_path="m/44'/888'/2'/0/7")
+    assert first == second
+
+    hits, misses, size, used = cmd.get_cache_stats()
+    assert (hits, misses) == (1, 1)
+    assert 0 < used <= size
+
+
+def test_get_account_xpub(cmd, button):
+    public_key, chain_code = cmd.get_account_xpub(account=1, button=button)
+
+    # the host derives change and address keys without the device
+    change_key, change_chain_code = ckd_pub(public_key, chain_code, 0)
+    for index in (0, 7):
+        address_key, _ = ckd_pub(change_key, change_chain_code, index)
+        assert address_key == cmd.get_public_key(bip44_path=f"m/44'/888'/1'/0/{index}", key_format=1)
+
+
+def test_get_account_xpub_reject(cmd, button):
+    with pytest.raises(DenyError):
+        cmd.get_account_xpub(account=0, button=button, approve=False)
+
+
+def test_discover_addresses(cmd):
+    script_hashes = cmd.get_public_keys(account_path="m/44'/888'/0'/1", start=0, count=80, script_hashes=True)
+    unknown = bytes(20)
+
+    # the window is larger than a single scan, so resuming is exercised
+    found = cmd.discover_addresses(account_path="m/44'/888'/0'/1", start=5, count=100,
+                                   script_hashes=[script_hashes[70], unknown, script_hashes[9], script_hashes[2]])
+
+    assert found == {script_hashes[70]: 70, script_hashes[9]: 9}
+
+
+def test_discover_addresses_out_of_range(cmd):
+    with pytest.raises(BIP44BadAddressError):
+        cmd.discover_addresses(account_path="m/44'/888'/0'/0", start=4990, count=11, script_hashes=[bytes(20)])
@@ -0,0 +1,102 @@
+import struct
+from hashlib import sha256
+from typing import List, Optional
+
+import pytest
+from ecdsa.curves import NIST256p
+from ecdsa.keys import VerifyingKey
+from ecdsa.util import sigdecode_der
+
+from neo3.network import payloads
+from neo3.core import types, serialization, to_script_hash
+from neo3 import contracts, wallet, vm
+from neo3crypto import ECCCurve, ECPoint
+
+from boilerplate_client.exception.errors import BatchTxNotSupportedError
+
+
+BIP44_PATH: str = "m/44'/888'/0'/0/0"
+OTHER_ACCOUNT = types.UInt160.from_string("d7678dd97c000be3f33e9362e673101bac4ca654")
+
+
+def account_of(cmd, bip44_path: str) -> types.UInt160:
+    public_key = ECPoint(cmd.get_public_key(bip44_path=bip44_path), ECCCurve.SECP256R1, validate=True)
+    return to_script_hash(contracts.Contract.create_signature_redeem_script(public_key))
+
+
+def build_transfer(account: types.UInt160, token, amount: int, nonce: int,
+                   scope: payloads.WitnessScope = payloads.WitnessScope.CALLED_BY_ENTRY,
+                   extra_signers: Optional[List[payloads.Signer]] = None) -> payloads.Transaction:
+    signers = [payloads.Signer(account=account, scope=scope)] + (extra_signers or [])
+    witness = payloads.Witness(invocation_script=b'', verification_script=b'\x55')
+
+    from_account = wallet.Account.address_to_script_hash("NSiVJYZej4XsxG5CUpdwn7VRQk8iiiDMPM").to_array()
+    to_account = wallet.Account.address_to_script_hash("NU5unwNcWLqPM21cNCRP1LPuhxsTpYvNTf").to_array()
+    sb = vm.ScriptBuilder()
+    sb.emit_dynamic_call_with_args(token.hash, "transfer", [from_account, to_account, amount, None])
+
+    return payloads.Transaction(version=0,
+                                nonce=nonce,
+                                system_fee=456,
+                                network_fee=789,
+                                valid_until_block=1,
+                                attributes=[],
+                                signers=signers,
+                                script=sb.to_array(),
+                                witnesses=[witness])
+
+
+def test_sign_batch(cmd, button):
+    bip44_path: str = BIP44_PATH
+    magic = 860833102
+
+    pub_key = cmd.get_public_key(bip44_path=bip44_path, display=False)  # type: bytes
+    pk: VerifyingKey = VerifyingKey.from_string(pub_key, curve=NIST256p, hashfunc=sha256)
+    account = account_of(cmd, bip44_path)
+
+    transactions = [build_transfer(account, contracts.NeoToken(), 11, 1),
+                    build_transfer(account, contracts.GasToken(), 5 * contracts.GasToken().factor, 2),
+                    build_transfer(account, contracts.NeoToken(), 3, 3)]
+
+    signatures = cmd.sign_batch(bip44_path=bip44_path,
+                                transactions=transactions,
+                                network_magic=magic,
+                                button=button)
+
+    assert len(signatures) == len(transactions)
+
+    for tx, der_sig in zip(transactions, signatures):
+        with serialization.BinaryWriter() as writer:
+            tx.serialize_unsigned(writer)
+            tx_data: bytes = writer.to_array()
+
+        assert pk.verify(signature=der_sig,
+                         data=struct.pack("I", magic) + sha256(tx_data).digest(),
+                         hashfunc=sha256,
+                         sigdecode=sigdecode_der) is True
+
+
+def test_sign_batch_rejects_arbitrary_script(cmd, button):
+    tx = build_transfer(account_of(cmd, BIP44_PATH), contracts.NeoToken(), 11, 1)
+    tx.script = b'\x11\x40'  # PUSH1, RET
+
+    with pytest.raises(BatchTxNotSupportedError):
+        cmd.sign_batch(bip44_path=BIP44_PATH,
+                       transactions=[tx],
+                       network_magic=860833102,
+                       button=button)
+
+
+def test_sign_batch_rejects_unreviewed_fields(cmd, button):
+    account = account_of(cmd, BIP44_PATH)
+    other_signer = payloads.Signer(account=OTHER_ACCOUNT, scope=payloads.WitnessScope.CALLED_BY_ENTRY)
+
+    # the batch summary shows none of these, so such transactions can't be part of a batch
+    for tx in (build_transfer(OTHER_ACCOUNT, contracts.NeoToken(), 11, 1),
+               build_transfer(account, contracts.NeoToken(), 11, 1, scope=payloads.WitnessScope.GLOBAL),
+               build_transfer(account, contracts.NeoToken(), 11, 1, extra_signers=[other_signer])):
+        with pytest.raises(BatchTxNotSupportedError):
+            cmd.sign_batch(bip44_path=BIP44_PATH,
+                           transactions=[tx],
+                           network_magic=860833102,
+                           button=button)
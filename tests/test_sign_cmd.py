@@ -1,13 +1,21 @@
 import struct
 from hashlib import sha256
 
+import pytest
+
 from ecdsa.curves import NIST256p
 from ecdsa.keys import VerifyingKey
-from ecdsa.util import sigdecode_der
+from ecdsa.util import sigdecode_der, sigdecode_string
 
 from neo3.network import node, payloads
-from neo3.core import types, serialization
+from neo3.core import types, serialization, to_script_hash
 from neo3 import contracts, wallet, vm
+from neo3crypto import ECCCurve, ECPoint
+
+from boilerplate_client.boilerplate_cmd_builder import InsType, P2_MULTI_SIGNER
+from boilerplate_client.exception import DeviceException
+from boilerplate_client.exception.errors import SignatureNotFoundError, SignerNotFoundError, WrongDataLengthError
+from boilerplate_client.utils import bip44_path_from_string
 
 
 def test_sign_tx(cmd, button):
@@ -69,3 +77,196 @@ def test_sign_tx(cmd, button):
                      data=struct.pack("I", magic) + sha256(tx_data).digest(),
                      hashfunc=sha256,
                      sigdecode=sigdecode_der) is True
+
+    # a lost response can be fetched again without another review
+    tx_hash = sha256(tx_data).digest()
+    assert cmd.get_last_signature(bip44_path=bip44_path, network_magic=magic, tx_hash=tx_hash) == der_sig
+
+
+def test_sign_tx_single_start(cmd, button):
+    """
+    Same as test_sign_tx, but the BIP44 path, network magic and transaction are sent in a single APDU.
+    """
+    bip44_path: str = "m/44'/888'/0'/0/0"
+
+    pub_key = cmd.get_public_key(
+        bip44_path=bip44_path,
+        display=False
+    )  # type: bytes
+
+    pk: VerifyingKey = VerifyingKey.from_string(
+        pub_key,
+        curve=NIST256p,
+        hashfunc=sha256
+    )
+
+    signer = payloads.Signer(account=types.UInt160.from_string("d7678dd97c000be3f33e9362e673101bac4ca654"),
+                             scope=payloads.WitnessScope.CALLED_BY_ENTRY)
+    witness = payloads.Witness(invocation_script=b'', verification_script=b'\x55')
+    magic = 860833102
+
+    from_account = wallet.Account.address_to_script_hash("NSiVJYZej4XsxG5CUpdwn7VRQk8iiiDMPM").to_array()
+    to_account = wallet.Account.address_to_script_hash("NU5unwNcWLqPM21cNCRP1LPuhxsTpYvNTf").to_array()
+    amount = 11 * contracts.NeoToken().factor
+    sb = vm.ScriptBuilder()
+    sb.emit_dynamic_call_with_args(contracts.NeoToken().hash, "transfer", [from_account, to_account, amount, None])
+
+    tx = payloads.Transaction(version=0,
+                              nonce=123,
+                              system_fee=456,
+                              network_fee=789,
+                              valid_until_block=1,
+                              attributes=[],
+                              signers=[signer],
+                              script=sb.to_array(),
+                              witnesses=[witness])
+
+    with serialization.BinaryWriter() as writer:
+        tx.serialize_unsigned(writer)
+        tx_data: bytes = writer.to_array()
+
+    # a NEO transfer fits in the opening APDU, so the transaction is signed in a single exchange
+    chunks = list(cmd.builder.sign_tx(bip44_path=bip44_path, transaction=tx, network_magic=magic, single_start=True))
+    assert len(chunks) == 1
+
+    der_sig = cmd.sign_tx(bip44_path=bip44_path,
+                          transaction=tx,
+                          network_magic=magic,
+                          button=button,
+                          single_start=True)
+
+    assert pk.verify(signature=der_sig,
+                     data=struct.pack("I", magic) + sha256(tx_data).digest(),
+                     hashfunc=sha256,
+                     sigdecode=sigdecode_der) is True
+
+
+def test_sign_tx_raw_signature(cmd, button):
+    """
+    Same as test_sign_tx, but the signature is returned as r || s followed by the transaction hash.
+    """
+    bip44_path: str = "m/44'/888'/0'/0/0"
+
+    pub_key = cmd.get_public_key(
+        bip44_path=bip44_path,
+        display=False
+    )  # type: bytes
+
+    pk: VerifyingKey = VerifyingKey.from_string(
+        pub_key,
+        curve=NIST256p,
+        hashfunc=sha256
+    )
+
+    signer = payloads.Signer(account=types.UInt160.from_string("d7678dd97c000be3f33e9362e673101bac4ca654"),
+                             scope=payloads.WitnessScope.CALLED_BY_ENTRY)
+    witness = payloads.Witness(invocation_script=b'', verification_script=b'\x55')
+    magic = 860833102
+
+    from_account = wallet.Account.address_to_script_hash("NSiVJYZej4XsxG5CUpdwn7VRQk8iiiDMPM").to_array()
+    to_account = wallet.Account.address_to_script_hash("NU5unwNcWLqPM21cNCRP1LPuhxsTpYvNTf").to_array()
+    amount = 11 * contracts.NeoToken().factor
+    sb = vm.ScriptBuilder()
+    sb.emit_dynamic_call_with_args(contracts.NeoToken().hash, "transfer", [from_account, to_account, amount, None])
+
+    tx = payloads.Transaction(version=0,
+                              nonce=123,
+                              system_fee=456,
+                              network_fee=789,
+                              valid_until_block=1,
+                              attributes=[],
+                              signers=[signer],
+                              script=sb.to_array(),
+                              witnesses=[witness])
+
+    with serialization.BinaryWriter() as writer:
+        tx.serialize_unsigned(writer)
+        tx_data: bytes = writer.to_array()
+
+    response = cmd.sign_tx(bip44_path=bip44_path,
+                           transaction=tx,
+                           network_magic=magic,
+                           button=button,
+                           raw_signature=True)
+
+    assert len(response) == 64 + 32
+    rs_sig, tx_hash = response[:64], response[64:]
+    assert tx_hash == sha256(tx_data).digest()
+    assert pk.verify(signature=rs_sig,
+                     data=struct.pack("I", magic) + tx_hash,
+                     hashfunc=sha256,
+                     sigdecode=sigdecode_string) is True
+
+
+def test_get_last_signature_unknown(cmd):
+    with pytest.raises(SignatureNotFoundError):
+        cmd.get_last_signature(bip44_path="m/44'/888'/0'/0/0", network_magic=860833102, tx_hash=bytes(32))
+
+
+def build_multi_signer_tx(cmd, bip44_paths):
+    signers = []
+    for path in bip44_paths:
+        public_key = ECPoint(cmd.get_public_key(bip44_path=path), ECCCurve.SECP256R1, validate=True)
+        account = to_script_hash(contracts.Contract.create_signature_redeem_script(public_key))
+        signers.append(payloads.Signer(account=account, scope=payloads.WitnessScope.CALLED_BY_ENTRY))
+
+    from_account = wallet.Account.address_to_script_hash("NSiVJYZej4XsxG5CUpdwn7VRQk8iiiDMPM").to_array()
+    to_account = wallet.Account.address_to_script_hash("NU5unwNcWLqPM21cNCRP1LPuhxsTpYvNTf").to_array()
+    sb = vm.ScriptBuilder()
+    sb.emit_dynamic_call_with_args(contracts.NeoToken().hash, "transfer", [from_account, to_account, 1, None])
+
+    return payloads.Transaction(version=0,
+                                nonce=321,
+                                system_fee=456,
+                                network_fee=789,
+                                valid_until_block=1,
+                                attributes=[],
+                                signers=signers,
+                                script=sb.to_array(),
+                                witnesses=[])
+
+
+def test_sign_tx_multi_signer(cmd, button):
+    magic = 860833102
+    tx = build_multi_signer_tx(cmd, ["m/44'/888'/0'/0/0", "m/44'/888'/1'/0/3"])
+
+    # the paths are matched to the signers, not taken in order
+    bip44_paths = ["m/44'/888'/1'/0/3", "m/44'/888'/0'/0/0"]
+    signatures = cmd.sign_tx_multi_signer(bip44_paths=bip44_paths, transaction=tx, network_magic=magic, button=button)
+
+    with serialization.BinaryWriter() as writer:
+        tx.serialize_unsigned(writer)
+        tx_data: bytes = writer.to_array()
+
+    assert [signer_index for signer_index, _ in signatures] == [1, 0]
+    for path, (_, der_sig) in zip(bip44_paths, signatures):
+        pk = VerifyingKey.from_string(cmd.get_public_key(bip44_path=path), curve=NIST256p, hashfunc=sha256)
+        assert pk.verify(signature=der_sig,
+                         data=struct.pack("I", magic) + sha256(tx_data).digest(),
+                         hashfunc=sha256,
+                         sigdecode=sigdecode_der) is True
+        # each signature can be fetched again, not only the last one
+        assert cmd.get_last_signature(bip44_path=path, network_magic=magic, tx_hash=sha256(tx_data).digest()) == der_sig
+
+
+def test_sign_tx_multi_signer_not_found(cmd, button):
+    tx = build_multi_signer_tx(cmd, ["m/44'/888'/0'/0/0", "m/44'/888'/1'/0/3"])
+
+    with pytest.raises(SignerNotFoundError):
+        cmd.sign_tx_multi_signer(bip44_paths=["m/44'/888'/0'/0/0", "m/44'/888'/2'/0/0"],
+                                 transaction=tx,
+                                 network_magic=860833102,
+                                 button=button)
+
+
+def test_sign_tx_multi_signer_truncated_path(cmd):
+    # the second path is cut short, only its account part is sent
+    paths = [b"".join(bip44_path_from_string(path)) for path in ["m/44'/888'/0'/0/0", "m/44'/888'/1'/0/3"]]
+    sw, _ = cmd.transport.exchange(cla=cmd.builder.CLA,
+                                   ins=InsType.INS_SIGN_TX,
+                                   p1=0x00,
+                                   p2=0x80 | P2_MULTI_SIGNER,
+                                   cdata=bytes([2]) + paths[0] + paths[1][:12])
+
+    with pytest.raises(WrongDataLengthError):
+        raise DeviceException(error_code=sw, ins=InsType.INS_SIGN_TX)
@@ -4,7 +4,7 @@ import enum
 import struct
 import logging
 
-from neo3.network.payloads import WitnessScope, Transaction, Signer, HighPriorityAttribute, OracleResponse
+from neo3.network.payloads import WitnessScope, Transaction, Signer, HighPriorityAttribute
 from neo3.core import types, serialization
 
 from pathlib import Path
@@ -16,40 +16,7 @@ bip44_path: str = "m/44'/888'/0'/0/0"
 network_magic = 123  # actual value doesn't matter
 
 
-class ParserStatus(enum.IntEnum):
-    PARSING_OK = 1
-    INVALID_LENGTH_ERROR = -1
-    VERSION_PARSING_ERROR = -2
-    VERSION_VALUE_ERROR = -3
-    NONCE_PARSING_ERROR = -4
-    SYSTEM_FEE_PARSING_ERROR = -5
-    SYSTEM_FEE_VALUE_ERROR = -6
-    NETWORK_FEE_PARSING_ERROR = -7
-    NETWORK_FEE_VALUE_ERROR = -8
-    VALID_UNTIL_BLOCK_PARSING_ERROR = -9
-    SIGNER_LENGTH_PARSING_ERROR = -10
-    SIGNER_LENGTH_VALUE_ERROR = -11
-    SIGNER_ACCOUNT_PARSING_ERROR = -12
-    SIGNER_ACCOUNT_DUPLICATE_ERROR = -13
-    SIGNER_SCOPE_PARSING_ERROR = -14
-    SIGNER_SCOPE_VALUE_ERROR_GLOBAL_FLAG = -15
-    SIGNER_ALLOWED_CONTRACTS_LENGTH_PARSING_ERROR = -16
-    SIGNER_ALLOWED_CONTRACTS_LENGTH_VALUE_ERROR = -17
-    SIGNER_ALLOWED_CONTRACT_PARSING_ERROR = -18
-    SIGNER_ALLOWED_GROUPS_LENGTH_PARSING_ERROR = -19
-    SIGNER_ALLOWED_GROUPS_LENGTH_VALUE_ERROR = -20
-    SIGNER_ALLOWED_GROUPS_PARSING_ERROR = -21
-    ATTRIBUTES_LENGTH_PARSING_ERROR = -22
-    ATTRIBUTES_LENGTH_VALUE_ERROR = -23
-    ATTRIBUTES_UNSUPPORTED_TYPE = -24
-    ATTRIBUTES_DUPLICATE_TYPE = -25
-    SCRIPT_LENGTH_PARSING_ERROR = -26
-    SCRIPT_LENGTH_VALUE_ERROR = -27
-    SIGNER_SCOPE_GROUPS_NOT_ALLOWED_ERROR = -28
-    SIGNER_SCOPE_CONTRACTS_NOT_ALLOWED_ERROR = -29
-
-
-PARSER_RE = re.compile("\s+(?P<name>.*) = (?P<value>-?\d{1,2})")
+PARSER_RE = re.compile(r"\s+X\((?P<name>\w+), (?P<value>-?\d{1,2})\)")
 
 
 def parse_parser_codes(path: Path) -> List[Tuple[str, int]]:
@@ -63,9 +30,9 @@ def parse_parser_codes(path: Path) -> List[Tuple[str, int]]:
 
     results = []
     for line in lines:
-        if "PARSING_OK" in line:
+        if "#define PARSER_STATUS_CODES" in line:
             include = True
-        if "parser_status_e" in line:
+        elif not line.strip():
             include = False
 
         if include:
@@ -76,11 +43,17 @@ def parse_parser_codes(path: Path) -> List[Tuple[str, int]]:
     return results
 
 
+# built from the X-macro list in types.h, so the codes can't get out of sync with the app
+TYPES_H_PATH = Path(__file__).parent.parent / "src" / "transaction" / "types.h"
+ParserStatus = enum.IntEnum("ParserStatus", parse_parser_codes(TYPES_H_PATH))
+
+
 def test_parser_codes(types_h_path):
-    expected_parser_codes: List[Tuple[str, int]] = parse_parser_codes(types_h_path)
-    for name, value in expected_parser_codes:
-        assert name in ParserStatus.__members__
-        assert value == ParserStatus.__members__[name].value, f"value mismatch for {name}"
+    parser_codes: List[Tuple[str, int]] = parse_parser_codes(types_h_path)
+    # PARSING_OK followed by the errors numbered from -1 down, without gaps or duplicates
+    assert parser_codes[0] == ("PARSING_OK", 1)
+    assert [value for _, value in parser_codes[1:]] == list(range(-1, -len(parser_codes), -1))
+    assert len(ParserStatus.__members__) == len(parser_codes)
 
 
 def serialize(cla: int, ins: Union[int, enum.IntEnum], p1: int = 0, p2: int = 0, cdata: bytes = b"") -> bytes:
@@ -198,14 +171,14 @@ def test_signers_length(cmd):
 
 
 def test_signers_length2(cmd):
-    # test signer length too large (3 vs max 2 allowed)
+    # test signer length too large (17 vs max 16 allowed)
     send_bip44_and_magic(cmd)
     version = b'\x00'
     nonce = b'\x00' * 4
     system_fee = struct.pack(">q", 0)
     network_fee = struct.pack(">q", 0)
     valid_until_block = b'\x00' * 4
-    signer_length = b'\x03'  # max allowed is 2
+    signer_length = b'\x11'  # max allowed is 16
     sw, error = send_raw_tx_data(cmd, version + nonce + system_fee + network_fee + valid_until_block + signer_length)
     assert error == ParserStatus.SIGNER_LENGTH_VALUE_ERROR
 
@@ -269,7 +242,7 @@ def test_signers_scope_contracts(cmd):
     scope = WitnessScope.CUSTOM_CONTRACTS
     scope = scope.to_bytes(1, 'little')
 
-    contracts_count = b'\x03'
+    contracts_count = b'\x11'  # max allowed is 16
 
     data = version + nonce + system_fee + network_fee + valid_until_block + signer_length + account + scope + contracts_count
     sw, error = send_raw_tx_data(cmd, data)
@@ -308,7 +281,7 @@ def test_signers_scope_groups(cmd):
     # in the 'simplified' app custom groups are not allowed
     scope = WitnessScope.CUSTOM_GROUPS
     scope = scope.to_bytes(1, 'little')
-    groups_count = b'\x03'
+    groups_count = b'\x11'  # max allowed is 16
 
     data = version + nonce + system_fee + network_fee + valid_until_block + signer_length + account + scope + groups_count
     sw, error = send_raw_tx_data(cmd, data)
@@ -335,6 +308,41 @@ def test_signers_scope_groups_no_data(cmd):
     assert error == ParserStatus.SIGNER_ALLOWED_CONTRACT_PARSING_ERROR
 
 
+def test_signers_scope_rules_no_data(cmd):
+    send_bip44_and_magic(cmd)
+    version = b'\x00'
+    nonce = b'\x00' * 4
+    system_fee = struct.pack(">q", 0)
+    network_fee = struct.pack(">q", 0)
+    valid_until_block = b'\x00' * 4
+    signer_length = b'\x01'
+    account = b'\x00' * 20  # UInt160
+    scope = b'\x40'  # WitnessRules
+    rules_count = b'\x01'
+    # by not providing any actual rule data we should fail
+    data = version + nonce + system_fee + network_fee + valid_until_block + signer_length + account + scope + rules_count
+    sw, error = send_raw_tx_data(cmd, data)
+    assert error == ParserStatus.SIGNER_RULE_PARSING_ERROR
+
+
+def test_signers_scope_rules_nesting(cmd):
+    send_bip44_and_magic(cmd)
+    version = b'\x00'
+    nonce = b'\x00' * 4
+    system_fee = struct.pack(">q", 0)
+    network_fee = struct.pack(">q", 0)
+    valid_until_block = b'\x00' * 4
+    signer_length = b'\x01'
+    account = b'\x00' * 20  # UInt160
+    scope = b'\x40'  # WitnessRules
+    rules_count = b'\x01'
+    # Allow, And(1) of Or(1) of Not of Boolean(true) nests 3 deep, the network allows 2
+    rule = b'\x01' + b'\x02\x01' + b'\x03\x01' + b'\x01' + b'\x00\x01'
+    data = version + nonce + system_fee + network_fee + valid_until_block + signer_length + account + scope
+    sw, error = send_raw_tx_data(cmd, data + rules_count + rule)
+    assert error == ParserStatus.SIGNER_RULE_VALUE_ERROR
+
+
 def test_attributes(cmd):
     send_bip44_and_magic(cmd)
     version = b'\x00'
@@ -357,8 +365,8 @@ def test_attributes_value(cmd):
     send_bip44_and_magic(cmd)
     signer = Signer(account=types.UInt160.from_string("d7678dd97c000be3f33e9362e673101bac4ca654"),
                     scope=WitnessScope.CALLED_BY_ENTRY)
-    # exceed max attributes count (2)
-    attributes = [HighPriorityAttribute(), HighPriorityAttribute(), HighPriorityAttribute()]
+    # exceed max attributes count (16 - signers count)
+    attributes = [HighPriorityAttribute() for _ in range(16)]
     tx = Transaction(version=0, nonce=0, system_fee=0, network_fee=0, valid_until_block=1, signers=[signer],
                      attributes=attributes)
 
@@ -372,21 +380,43 @@ def test_attributes_value(cmd):
 
 def test_attributes_unsupported(cmd):
     send_bip44_and_magic(cmd)
-    signer = Signer(account=types.UInt160.from_string("d7678dd97c000be3f33e9362e673101bac4ca654"),
-                    scope=WitnessScope.CALLED_BY_ENTRY)
-    # unsupported attribute
-    attributes = [OracleResponse._serializable_init()]
-    tx = Transaction(version=0, nonce=0, system_fee=0, network_fee=0, valid_until_block=1, signers=[signer],
-                     attributes=attributes)
-
-    with serialization.BinaryWriter() as br:
-        tx.serialize_unsigned(br)
-        data = br.to_array()
+    version = b'\x00'
+    nonce = b'\x00' * 4
+    system_fee = struct.pack(">q", 0)
+    network_fee = struct.pack(">q", 0)
+    valid_until_block = b'\x00' * 4
+    signer_length = b'\x01'
+    account = b'\x00' * 20  # UInt160
+    scope = WitnessScope.CALLED_BY_ENTRY
+    scope = scope.to_bytes(1, 'little')
+    attributes_count = b'\x01'
+    attribute_type = b'\x02'  # not an attribute type of the network
 
-    sw, error = send_raw_tx_data(cmd, data)
+    data = version + nonce + system_fee + network_fee + valid_until_block + signer_length + account + scope
+    sw, error = send_raw_tx_data(cmd, data + attributes_count + attribute_type)
     assert error == ParserStatus.ATTRIBUTES_UNSUPPORTED_TYPE
 
 
+def test_attributes_oracle_response_code(cmd):
+    send_bip44_and_magic(cmd)
+    version = b'\x00'
+    nonce = b'\x00' * 4
+    system_fee = struct.pack(">q", 0)
+    network_fee = struct.pack(">q", 0)
+    valid_until_block = b'\x00' * 4
+    signer_length = b'\x01'
+    account = b'\x00' * 20  # UInt160
+    scope = WitnessScope.CALLED_BY_ENTRY
+    scope = scope.to_bytes(1, 'little')
+    attributes_count = b'\x01'
+    # OracleResponse with id 1 and code Timeout, only a successful response may carry a result
+    oracle_response = b'\x11' + struct.pack("<Q", 1) + b'\x16' + b'\x01\x01'
+
+    data = version + nonce + system_fee + network_fee + valid_until_block + signer_length + account + scope
+    sw, error = send_raw_tx_data(cmd, data + attributes_count + oracle_response)
+    assert error == ParserStatus.ATTRIBUTE_DATA_VALUE_ERROR
+
+
 def test_attributes_duplicates(cmd):
     send_bip44_and_magic(cmd)
     signer = Signer(account=types.UInt160.from_string("d7678dd97c000be3f33e9362e673101bac4ca654"),
@@ -0,0 +1,27 @@
+#pragma once
+
+/**
+ * Minimal host implementation of the BOLOS cx hashing API used by the unit tests.
+ * Only SHA-256 is provided.
+ */
+
+#include <stdint.h>  // uint*_t
+#include <stddef.h>  // size_t
+
+#define CX_LAST (1 << 0)
+
+typedef struct {
+    uint8_t algo;
+} cx_hash_t;
+
+typedef struct {
+    cx_hash_t header;
+    uint32_t state[8];
+    uint64_t length;
+    uint8_t block[64];
+    size_t block_len;
+} cx_sha256_t;
+
+int cx_sha256_init(cx_sha256_t *hash);
+
+int cx_hash(cx_hash_t *hash, int mode, const uint8_t *in, size_t len, uint8_t *out, size_t out_len);
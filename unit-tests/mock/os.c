@@ -0,0 +1,8 @@
+#include <stddef.h>  // size_t
+#include <string.h>  // memcpy
+
+#include "os.h"
+
+void nvm_write(void *dst, void *src, size_t len) {
+    memcpy(dst, src, len);
+}
@@ -0,0 +1,10 @@
+#pragma once
+
+/**
+ * Minimal host implementation of the BOLOS os API used by the unit tests.
+ * Only the flash write is provided, flash is plain memory on the host.
+ */
+
+#include <stddef.h>  // size_t
+
+void nvm_write(void *dst, void *src, size_t len);
@@ -0,0 +1,58 @@
+#include <stdarg.h>
+#include <stddef.h>
+#include <setjmp.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+#include <cmocka.h>
+
+#include "common/bip44.h"
+#include "common/buffer.h"
+#include "constants.h"
+#include "sw.h"
+
+// m/44'/888'/0'/0/1 followed by m/44'/888'/1'/0/3
+static const uint8_t TWO_PATHS[2 * BIP44_BYTE_LENGTH] = {
+    0x80, 0x00, 0x00, 0x2C, 0x80, 0x00, 0x03, 0x78, 0x80, 0x00, 0x00, 0x00,  //
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x01,                          //
+    0x80, 0x00, 0x00, 0x2C, 0x80, 0x00, 0x03, 0x78, 0x80, 0x00, 0x00, 0x01,  //
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x03};
+
+static void test_bip44_read_paths(void **state) {
+    (void) state;
+
+    buffer_t buf = {.ptr = TWO_PATHS, .size = sizeof(TWO_PATHS), .offset = 0};
+    uint32_t path[BIP44_PATH_LEN];
+    uint16_t status = 0;
+
+    assert_true(buffer_read_and_validate_bip44(&buf, path, &status));
+    assert_int_equal(path[2], 0x80000000);
+    assert_int_equal(path[4], 1);
+    assert_true(buffer_read_and_validate_bip44(&buf, path, &status));
+    assert_int_equal(path[2], 0x80000001);
+    assert_int_equal(path[4], 3);
+    assert_int_equal(buf.offset, sizeof(TWO_PATHS));
+}
+
+static void test_bip44_truncated_path(void **state) {
+    (void) state;
+
+    uint32_t path[BIP44_PATH_LEN];
+    uint16_t status = 0;
+
+    // the whole buffer is longer than a path, but the second path is cut short
+    for (size_t len = BIP44_BYTE_LENGTH; len < sizeof(TWO_PATHS); len++) {
+        buffer_t buf = {.ptr = TWO_PATHS, .size = len, .offset = 0};
+
+        assert_true(buffer_read_and_validate_bip44(&buf, path, &status));
+        assert_false(buffer_read_and_validate_bip44(&buf, path, &status));
+        assert_int_equal(status, SW_WRONG_DATA_LENGTH);
+    }
+}
+
+int main() {
+    const struct CMUnitTest tests[] = {cmocka_unit_test(test_bip44_read_paths),
+                                       cmocka_unit_test(test_bip44_truncated_path)};
+
+    return cmocka_run_group_tests(tests, NULL, NULL);
+}
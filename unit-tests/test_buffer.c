@@ -144,12 +144,81 @@ static void test_buffer_move(void **state) {
     assert_false(buffer_move(&buf, output2, sizeof(output2)));  // can't read 5 bytes
 }
 
+static void test_buffer_view(void **state) {
+    (void) state;
+
+    uint8_t temp[5] = {0x01, 0x02, 0x03, 0x04, 0x05};
+    buffer_t buf = {.ptr = temp, .size = sizeof(temp), .offset = 0};
+
+    assert_true(buffer_view(&buf, 2) == temp);
+    assert_int_equal(buf.offset, 2);
+    assert_null(buffer_view(&buf, 4));  // can't read 4 bytes
+    assert_int_equal(buf.offset, 2);
+
+    size_t len = 0;
+    assert_true(buffer_view_at_most(&buf, 2, &len) == temp + 2);
+    assert_int_equal(len, 2);
+    assert_true(buffer_view_at_most(&buf, 2, &len) == temp + 4);
+    assert_int_equal(len, 1);
+    buffer_view_at_most(&buf, 2, &len);
+    assert_int_equal(len, 0);
+    assert_int_equal(buf.offset, sizeof(temp));
+}
+
+static void test_reader(void **state) {
+    (void) state;
+
+    // clang-format off
+    uint8_t temp[] = {
+        0x01,                                            // u8
+        0x01, 0x02,                                      // u16 BE
+        0x01, 0x02, 0x03, 0x04,                          // u32 LE
+        0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08,  // u64 BE
+        0xFD, 0x00, 0x01,                                // varint
+        0xAA, 0xBB, 0xCC,                                // view
+        0xDD                                             // skipped
+    };
+    // clang-format on
+    buffer_t buf = {.ptr = temp, .size = sizeof(temp), .offset = 0};
+    reader_t reader;
+
+    reader_init(&reader, &buf);
+    assert_int_equal(reader_u8(&reader), 0x01);
+    assert_int_equal(reader_u16(&reader, BE), 0x0102);
+    assert_int_equal(reader_u32(&reader, LE), 0x04030201);
+    assert_int_equal(reader_u64(&reader, BE), 0x0102030405060708);
+    assert_int_equal(reader_varint(&reader), 0x0100);
+    assert_true(reader_view(&reader, 3) == temp + 18);
+    assert_int_equal(reader_remaining(&reader), 1);
+    reader_skip(&reader, 1);
+    assert_true(reader_ok(&reader));
+    assert_int_equal(reader_remaining(&reader), 0);
+    assert_int_equal(buf.offset, 0);  // the buffer itself is not moved
+
+    // the first read out of bounds fails every following read
+    reader_init(&reader, &buf);
+    reader_skip(&reader, 20);
+    assert_int_equal(reader_u32(&reader, LE), 0);
+    assert_false(reader_ok(&reader));
+    assert_int_equal(reader_u8(&reader), 0);
+    assert_null(reader_view(&reader, 1));
+    assert_int_equal(reader_remaining(&reader), 0);
+
+    // fixed-width reads at an odd offset
+    buffer_t odd = {.ptr = temp, .size = sizeof(temp), .offset = 7};
+    reader_init(&reader, &odd);
+    assert_int_equal(reader_u64(&reader, LE), 0x0807060504030201);
+    assert_true(reader_ok(&reader));
+}
+
 int main() {
     const struct CMUnitTest tests[] = {cmocka_unit_test(test_buffer_can_read),
                                        cmocka_unit_test(test_buffer_seek),
                                        cmocka_unit_test(test_buffer_read),
                                        cmocka_unit_test(test_buffer_copy),
-                                       cmocka_unit_test(test_buffer_move)};
+                                       cmocka_unit_test(test_buffer_move),
+                                       cmocka_unit_test(test_buffer_view),
+                                       cmocka_unit_test(test_reader)};
 
     return cmocka_run_group_tests(tests, NULL, NULL);
 }
@@ -0,0 +1,73 @@
+#include <stdarg.h>
+#include <stddef.h>
+#include <setjmp.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+
+#include <cmocka.h>
+
+#include "common/der.h"
+
+static void test_der_signature_to_rs(void **state) {
+    (void) state;
+
+    // r has the high bit set (sign byte added), s is 31 bytes long
+    // clang-format off
+    uint8_t der[] = {
+        0x30, 0x44,
+        0x02, 0x21, 0x00,
+        0x80, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08, 0x09, 0x0a, 0x0b, 0x0c, 0x0d, 0x0e, 0x0f,
+        0x10, 0x11, 0x12, 0x13, 0x14, 0x15, 0x16, 0x17, 0x18, 0x19, 0x1a, 0x1b, 0x1c, 0x1d, 0x1e, 0x1f,
+        0x02, 0x1f,
+        0x21, 0x22, 0x23, 0x24, 0x25, 0x26, 0x27, 0x28, 0x29, 0x2a, 0x2b, 0x2c, 0x2d, 0x2e, 0x2f, 0x30,
+        0x31, 0x32, 0x33, 0x34, 0x35, 0x36, 0x37, 0x38, 0x39, 0x3a, 0x3b, 0x3c, 0x3d, 0x3e, 0x3f,
+    };
+    // clang-format on
+    uint8_t expected[RS_SIGNATURE_LEN] = {0};
+    memcpy(expected, der + 5, 32);
+    memcpy(expected + 33, der + 39, 31);
+
+    uint8_t out[RS_SIGNATURE_LEN];
+    assert_true(der_signature_to_rs(der, sizeof(der), out));
+    assert_memory_equal(out, expected, sizeof(expected));
+}
+
+static void test_der_signature_to_rs_malformed(void **state) {
+    (void) state;
+
+    uint8_t out[RS_SIGNATURE_LEN];
+    uint8_t der[] = {0x30, 0x06, 0x02, 0x01, 0x01, 0x02, 0x01, 0x02};
+
+    assert_true(der_signature_to_rs(der, sizeof(der), out));
+    assert_int_equal(out[31], 0x01);
+    assert_int_equal(out[63], 0x02);
+
+    // wrong sequence length
+    assert_false(der_signature_to_rs(der, sizeof(der) - 1, out));
+    // wrong sequence tag
+    der[0] = 0x31;
+    assert_false(der_signature_to_rs(der, sizeof(der), out));
+    der[0] = 0x30;
+    // s is not an integer
+    der[5] = 0x03;
+    assert_false(der_signature_to_rs(der, sizeof(der), out));
+    der[5] = 0x02;
+    // r overruns the signature
+    der[3] = 0x06;
+    assert_false(der_signature_to_rs(der, sizeof(der), out));
+
+    // integer longer than 32 bytes without a sign byte
+    uint8_t too_long[2 + 2 + 33 + 3] = {0x30, 2 + 33 + 3, 0x02, 33, 0x01};
+    too_long[2 + 2 + 33] = 0x02;
+    too_long[2 + 2 + 33 + 1] = 0x01;
+    too_long[2 + 2 + 33 + 2] = 0x01;
+    assert_false(der_signature_to_rs(too_long, sizeof(too_long), out));
+}
+
+int main() {
+    const struct CMUnitTest tests[] = {cmocka_unit_test(test_der_signature_to_rs),
+                                       cmocka_unit_test(test_der_signature_to_rs_malformed)};
+
+    return cmocka_run_group_tests(tests, NULL, NULL);
+}
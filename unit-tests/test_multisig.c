@@ -0,0 +1,107 @@
+#include <stdarg.h>
+#include <stddef.h>
+#include <setjmp.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+
+#include <cmocka.h>
+
+#include "common/multisig.h"
+
+static void fill_key(uint8_t key[static 33], uint8_t prefix, uint8_t x) {
+    key[0] = prefix;
+    memset(key + 1, x, 32);
+}
+
+static void test_multisig_sort_keys(void **state) {
+    (void) state;
+
+    uint8_t keys[3][33];
+    fill_key(keys[0], 0x02, 0x33);
+    fill_key(keys[1], 0x03, 0x11);
+    fill_key(keys[2], 0x02, 0x22);
+
+    // ascending by X, the prefix is not part of the order
+    assert_true(multisig_sort_keys(keys, 3));
+    assert_int_equal(keys[0][0], 0x03);
+    assert_int_equal(keys[0][1], 0x11);
+    assert_int_equal(keys[1][1], 0x22);
+    assert_int_equal(keys[2][1], 0x33);
+
+    // already sorted
+    assert_true(multisig_sort_keys(keys, 3));
+    assert_int_equal(keys[0][1], 0x11);
+    assert_int_equal(keys[2][1], 0x33);
+
+    assert_true(multisig_sort_keys(keys, 1));
+}
+
+static void test_multisig_sort_keys_invalid(void **state) {
+    (void) state;
+
+    uint8_t keys[3][33];
+    fill_key(keys[0], 0x02, 0x33);
+    fill_key(keys[1], 0x03, 0x11);
+    fill_key(keys[2], 0x03, 0x33);
+
+    // same X with the other parity is the negated key
+    assert_false(multisig_sort_keys(keys, 3));
+
+    fill_key(keys[2], 0x02, 0x22);
+    keys[1][0] = 0x04;
+    assert_false(multisig_sort_keys(keys, 3));
+}
+
+static void test_multisig_create_script(void **state) {
+    (void) state;
+
+    uint8_t keys[3][33];
+    fill_key(keys[0], 0x03, 0x11);
+    fill_key(keys[1], 0x02, 0x22);
+    fill_key(keys[2], 0x02, 0x33);
+
+    uint8_t script[MULTISIG_SCRIPT_MAX_LEN];
+    size_t len = multisig_create_script(2, (const uint8_t(*)[33]) keys, 3, script, sizeof(script));
+
+    assert_int_equal(len, 1 + 3 * 35 + 1 + 5);
+    assert_int_equal(script[0], 0x12);  // PUSH2
+    for (int i = 0; i < 3; i++) {
+        assert_int_equal(script[1 + i * 35], 0x0C);  // PUSHDATA1
+        assert_int_equal(script[2 + i * 35], 0x21);
+        assert_memory_equal(script + 3 + i * 35, keys[i], 33);
+    }
+    uint8_t tail[] = {0x13, 0x41, 0x9E, 0xD0, 0xDC, 0x3A};  // PUSH3, SYSCALL System.Crypto.CheckMultisig
+    assert_memory_equal(script + len - sizeof(tail), tail, sizeof(tail));
+
+    // 16 keys is the largest script
+    uint8_t many[MULTISIG_MAX_KEYS][33] = {0};
+    len = multisig_create_script(16, (const uint8_t(*)[33]) many, MULTISIG_MAX_KEYS, script, sizeof(script));
+    assert_int_equal(len, MULTISIG_SCRIPT_MAX_LEN);
+    assert_int_equal(script[0], 0x20);  // PUSH16
+    assert_int_equal(script[len - 6], 0x20);
+}
+
+static void test_multisig_create_script_invalid(void **state) {
+    (void) state;
+
+    uint8_t keys[MULTISIG_MAX_KEYS + 1][33] = {0};
+    uint8_t script[MULTISIG_SCRIPT_MAX_LEN + 35];
+
+    assert_int_equal(multisig_create_script(0, (const uint8_t(*)[33]) keys, 3, script, sizeof(script)), 0);
+    assert_int_equal(multisig_create_script(4, (const uint8_t(*)[33]) keys, 3, script, sizeof(script)), 0);
+    assert_int_equal(
+        multisig_create_script(1, (const uint8_t(*)[33]) keys, MULTISIG_MAX_KEYS + 1, script, sizeof(script)),
+        0);
+    // output buffer too small
+    assert_int_equal(multisig_create_script(1, (const uint8_t(*)[33]) keys, 2, script, 1 + 2 * 35 + 1 + 4), 0);
+}
+
+int main() {
+    const struct CMUnitTest tests[] = {cmocka_unit_test(test_multisig_sort_keys),
+                                       cmocka_unit_test(test_multisig_sort_keys_invalid),
+                                       cmocka_unit_test(test_multisig_create_script),
+                                       cmocka_unit_test(test_multisig_create_script_invalid)};
+
+    return cmocka_run_group_tests(tests, NULL, NULL);
+}
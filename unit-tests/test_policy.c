@@ -0,0 +1,177 @@
+#include <stdarg.h>
+#include <stddef.h>
+#include <setjmp.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+
+#include <cmocka.h>
+
+#include "transaction/types.h"
+#include "transaction/policy.h"
+
+static const uint32_t path[BIP44_PATH_LEN] = {0x8000002C, 0x80000378, 0x80000000, 0, 0};
+static const uint32_t other_path[BIP44_PATH_LEN] = {0x8000002C, 0x80000378, 0x80000000, 0, 1};
+static const char dst[ADDRESS_LEN] = "NU5unwNcWLqPM21cNCRP1LPuhxsTpYvNTf";
+static const uint8_t account[UINT160_LEN] = {0xd7, 0x67, 0x8d, 0xd9, 0x7c, 0x00, 0x0b, 0xe3, 0xf3, 0x3e,
+                                             0x93, 0x62, 0xe6, 0x73, 0x10, 0x1b, 0xac, 0x4c, 0xa6, 0x54};
+
+static void make_policy(policy_t *policy) {
+    memset(policy, 0, sizeof(*policy));
+    policy->active = true;
+    memcpy(policy->bip44_path, path, sizeof(path));
+    memcpy(policy->account, account, UINT160_LEN);
+    policy->network_magic = NETWORK_MAINNET;
+    memcpy(policy->dst_address, dst, ADDRESS_LEN);
+    policy->is_neo = false;
+    policy->max_amount = 100;
+    policy->max_total = 250;
+    policy->max_fee = 10;
+    policy->max_valid_until_block = 1000;
+    policy->max_count = 5;
+}
+
+static void make_transfer(transaction_t *tx, int64_t amount) {
+    memset(tx, 0, sizeof(*tx));
+    tx->system_fee = 4;
+    tx->network_fee = 6;
+    tx->valid_until_block = 1000;
+    tx->is_system_asset_transfer = true;
+    tx->is_neo = false;
+    tx->amount = amount;
+    memcpy(tx->dst_address, dst, ADDRESS_LEN);
+    tx->signers_size = 1;
+    tx->signers[0] = (signer_t){.offset = 0, .scope = CALLED_BY_ENTRY};
+    memcpy(tx->signers_data, account, UINT160_LEN);
+    tx->signers_data_len = UINT160_LEN;
+}
+
+static void test_policy_allows_matching(void **state) {
+    (void) state;
+
+    policy_t policy;
+    transaction_t tx;
+    make_policy(&policy);
+    make_transfer(&tx, 100);
+
+    assert_true(policy_allows(&policy, path, NETWORK_MAINNET, &tx));
+
+    policy.active = false;
+    assert_false(policy_allows(&policy, path, NETWORK_MAINNET, &tx));
+}
+
+static void test_policy_rejects_mismatch(void **state) {
+    (void) state;
+
+    policy_t policy;
+    transaction_t tx;
+    make_policy(&policy);
+
+    make_transfer(&tx, 1);
+    assert_false(policy_allows(&policy, other_path, NETWORK_MAINNET, &tx));
+    assert_false(policy_allows(&policy, path, NETWORK_TESTNET, &tx));
+
+    tx.is_neo = true;
+    assert_false(policy_allows(&policy, path, NETWORK_MAINNET, &tx));
+
+    make_transfer(&tx, 1);
+    tx.dst_address[5] ^= 1;
+    assert_false(policy_allows(&policy, path, NETWORK_MAINNET, &tx));
+
+    make_transfer(&tx, 1);
+    tx.is_system_asset_transfer = false;
+    assert_false(policy_allows(&policy, path, NETWORK_MAINNET, &tx));
+
+    make_transfer(&tx, 101);
+    assert_false(policy_allows(&policy, path, NETWORK_MAINNET, &tx));
+
+    make_transfer(&tx, -1);
+    assert_false(policy_allows(&policy, path, NETWORK_MAINNET, &tx));
+
+    make_transfer(&tx, 1);
+    tx.network_fee = 7;
+    assert_false(policy_allows(&policy, path, NETWORK_MAINNET, &tx));
+
+    make_transfer(&tx, 1);
+    tx.valid_until_block = 1001;
+    assert_false(policy_allows(&policy, path, NETWORK_MAINNET, &tx));
+
+    make_transfer(&tx, 1);
+    tx.attributes_size = 1;
+    tx.attributes[0].type = HIGH_PRIORITY;
+    assert_true(policy_allows(&policy, path, NETWORK_MAINNET, &tx));
+    tx.attributes[0].type = CONFLICTS;
+    assert_false(policy_allows(&policy, path, NETWORK_MAINNET, &tx));
+}
+
+static void test_policy_rejects_signers(void **state) {
+    (void) state;
+
+    policy_t policy;
+    transaction_t tx;
+    make_policy(&policy);
+
+    make_transfer(&tx, 1);
+    assert_true(policy_allows(&policy, path, NETWORK_MAINNET, &tx));
+
+    // any scope wider than CalledByEntry lets other contracts use the witness
+    tx.signers[0].scope = GLOBAL;
+    assert_false(policy_allows(&policy, path, NETWORK_MAINNET, &tx));
+    tx.signers[0].scope = CALLED_BY_ENTRY | CUSTOM_CONTRACTS;
+    assert_false(policy_allows(&policy, path, NETWORK_MAINNET, &tx));
+    tx.signers[0].scope = WITNESS_RULES;
+    assert_false(policy_allows(&policy, path, NETWORK_MAINNET, &tx));
+    tx.signers[0].scope = NONE;
+    assert_false(policy_allows(&policy, path, NETWORK_MAINNET, &tx));
+
+    // the only signer must be the policy account
+    make_transfer(&tx, 1);
+    tx.signers_data[0] ^= 1;
+    assert_false(policy_allows(&policy, path, NETWORK_MAINNET, &tx));
+
+    // a second signer, even with the policy account first
+    make_transfer(&tx, 1);
+    tx.signers_size = 2;
+    tx.signers[1] = (signer_t){.offset = UINT160_LEN, .scope = CALLED_BY_ENTRY};
+    memset(tx.signers_data + UINT160_LEN, 0x11, UINT160_LEN);
+    tx.signers_data_len = 2 * UINT160_LEN;
+    assert_false(policy_allows(&policy, path, NETWORK_MAINNET, &tx));
+}
+
+static void test_policy_cumulative_limits(void **state) {
+    (void) state;
+
+    policy_t policy;
+    transaction_t tx;
+    make_policy(&policy);
+    make_transfer(&tx, 100);
+
+    // 100 + 100 fits the total of 250, a third transfer of 100 does not
+    assert_true(policy_allows(&policy, path, NETWORK_MAINNET, &tx));
+    policy_record(&policy, &tx);
+    assert_true(policy_allows(&policy, path, NETWORK_MAINNET, &tx));
+    policy_record(&policy, &tx);
+    assert_false(policy_allows(&policy, path, NETWORK_MAINNET, &tx));
+
+    make_transfer(&tx, 50);
+    assert_true(policy_allows(&policy, path, NETWORK_MAINNET, &tx));
+    policy_record(&policy, &tx);
+    assert_int_equal(policy.total, 250);
+    assert_int_equal(policy.count, 3);
+
+    // only the number of transactions is left to exhaust
+    make_transfer(&tx, 0);
+    policy_record(&policy, &tx);
+    assert_true(policy_allows(&policy, path, NETWORK_MAINNET, &tx));
+    policy_record(&policy, &tx);
+    assert_false(policy_allows(&policy, path, NETWORK_MAINNET, &tx));
+}
+
+int main() {
+    const struct CMUnitTest tests[] = {cmocka_unit_test(test_policy_allows_matching),
+                                       cmocka_unit_test(test_policy_rejects_mismatch),
+                                       cmocka_unit_test(test_policy_rejects_signers),
+                                       cmocka_unit_test(test_policy_cumulative_limits)};
+
+    return cmocka_run_group_tests(tests, NULL, NULL);
+}
@@ -0,0 +1,144 @@
+#include <stdarg.h>
+#include <stddef.h>
+#include <setjmp.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+
+#include <cmocka.h>
+
+#include "common/pubkey_cache.h"
+
+static void make_path(uint32_t path[static BIP44_PATH_LEN], uint32_t index) {
+    path[0] = BIP44_PURPOSE;
+    path[1] = BIP44_COIN_TYPE_NEO;
+    path[2] = 0x80000000;
+    path[3] = 0;
+    path[4] = index;
+}
+
+static void add_key(pubkey_cache_t *cache, uint32_t index) {
+    uint32_t path[BIP44_PATH_LEN];
+    uint8_t public_key[64];
+    uint8_t script_hash[20];
+
+    make_path(path, index);
+    memset(public_key, (uint8_t) index, sizeof(public_key));
+    memset(script_hash, (uint8_t) index, sizeof(script_hash));
+    pubkey_cache_add(cache, path, public_key, script_hash);
+}
+
+static void test_pubkey_cache_find(void **state) {
+    (void) state;
+
+    pubkey_cache_t cache = {0};
+    uint32_t path[BIP44_PATH_LEN];
+
+    make_path(path, 1);
+    assert_null(pubkey_cache_find(&cache, path));
+
+    add_key(&cache, 1);
+    const pubkey_cache_entry_t *entry = pubkey_cache_find(&cache, path);
+    assert_non_null(entry);
+    assert_int_equal(entry->public_key[0], 1);
+    assert_int_equal(entry->script_hash[19], 1);
+
+    // a different account is a different key
+    path[2]++;
+    assert_null(pubkey_cache_find(&cache, path));
+
+    assert_int_equal(cache.hits, 1);
+    assert_int_equal(cache.misses, 2);
+}
+
+static void test_pubkey_cache_evicts_least_recently_used(void **state) {
+    (void) state;
+
+    pubkey_cache_t cache = {0};
+    uint32_t path[BIP44_PATH_LEN];
+
+    for (uint32_t i = 0; i < PUBKEY_CACHE_SIZE; i++) {
+        add_key(&cache, i);
+    }
+
+    // key 0 is the oldest insertion, but the most recently used
+    make_path(path, 0);
+    assert_non_null(pubkey_cache_find(&cache, path));
+
+    add_key(&cache, PUBKEY_CACHE_SIZE);
+
+    assert_non_null(pubkey_cache_find(&cache, path));
+    make_path(path, 1);
+    assert_null(pubkey_cache_find(&cache, path));
+    for (uint32_t i = 2; i <= PUBKEY_CACHE_SIZE; i++) {
+        make_path(path, i);
+        assert_non_null(pubkey_cache_find(&cache, path));
+    }
+}
+
+static void test_pubkey_cache_peek(void **state) {
+    (void) state;
+
+    pubkey_cache_t cache = {0};
+    uint32_t path[BIP44_PATH_LEN];
+
+    for (uint32_t i = 0; i < PUBKEY_CACHE_SIZE; i++) {
+        add_key(&cache, i);
+    }
+
+    // a scan over the range neither counts nor refreshes key 0, the oldest insertion
+    for (uint32_t i = 0; i <= PUBKEY_CACHE_SIZE; i++) {
+        make_path(path, i);
+        const pubkey_cache_entry_t *entry = pubkey_cache_peek(&cache, path);
+        if (i < PUBKEY_CACHE_SIZE) {
+            assert_non_null(entry);
+            assert_int_equal(entry->public_key[0], i);
+        } else {
+            assert_null(entry);
+        }
+    }
+    assert_int_equal(cache.hits, 0);
+    assert_int_equal(cache.misses, 0);
+
+    add_key(&cache, PUBKEY_CACHE_SIZE);
+    make_path(path, 0);
+    assert_null(pubkey_cache_peek(&cache, path));
+}
+
+static void test_pubkey_cache_clear(void **state) {
+    (void) state;
+
+    pubkey_cache_t cache = {0};
+    uint32_t path[BIP44_PATH_LEN];
+
+    for (uint32_t i = 0; i < PUBKEY_CACHE_SIZE; i++) {
+        add_key(&cache, i);
+    }
+    make_path(path, 0);
+    assert_non_null(pubkey_cache_find(&cache, path));
+
+    // a lock or another seed empties the cache, the keys of the previous seed must not be returned
+    pubkey_cache_clear(&cache);
+    for (uint32_t i = 0; i < PUBKEY_CACHE_SIZE; i++) {
+        make_path(path, i);
+        assert_null(pubkey_cache_peek(&cache, path));
+        assert_int_equal(cache.entries[i].last_used, 0);
+    }
+    assert_null(pubkey_cache_find(&cache, path));
+    assert_int_equal(cache.hits, 1);
+    assert_int_equal(cache.misses, 1);
+
+    // the cache fills again afterwards
+    add_key(&cache, 1);
+    make_path(path, 1);
+    assert_non_null(pubkey_cache_find(&cache, path));
+}
+
+int main() {
+    const struct CMUnitTest tests[] = {cmocka_unit_test(test_pubkey_cache_find),
+                                       cmocka_unit_test(test_pubkey_cache_evicts_least_recently_used),
+                                       cmocka_unit_test(test_pubkey_cache_peek),
+                                       cmocka_unit_test(test_pubkey_cache_clear)};
+
+    return cmocka_run_group_tests(tests, NULL, NULL);
+}
@@ -0,0 +1,123 @@
+#include <stdarg.h>
+#include <stddef.h>
+#include <setjmp.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+
+#include <cmocka.h>
+
+#include "common/pubkey_store.h"
+
+static const uint8_t SEED[PUBKEY_STORE_FINGERPRINT_LEN] = {0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08};
+static const uint8_t OTHER_SEED[PUBKEY_STORE_FINGERPRINT_LEN] = {0x08, 0x07, 0x06, 0x05, 0x04, 0x03, 0x02, 0x01};
+
+static void make_path(uint32_t path[static BIP44_PATH_LEN], uint32_t index) {
+    path[0] = BIP44_PURPOSE;
+    path[1] = BIP44_COIN_TYPE_NEO;
+    path[2] = 0x80000000;
+    path[3] = 0;
+    path[4] = index;
+}
+
+static void add_key(const pubkey_store_t *store, uint32_t index) {
+    uint32_t path[BIP44_PATH_LEN];
+    uint8_t public_key[64];
+    uint8_t script_hash[20];
+
+    make_path(path, index);
+    memset(public_key, (uint8_t) index, sizeof(public_key));
+    memset(script_hash, (uint8_t) index, sizeof(script_hash));
+    pubkey_store_add(store, path, public_key, script_hash, SEED);
+}
+
+static void test_pubkey_store_find(void **state) {
+    (void) state;
+
+    static pubkey_store_t store;
+    memset(&store, 0, sizeof(store));
+    uint32_t path[BIP44_PATH_LEN];
+
+    make_path(path, 1);
+    assert_null(pubkey_store_find(&store, path, SEED));
+
+    add_key(&store, 1);
+    const pubkey_store_entry_t *entry = pubkey_store_find(&store, path, SEED);
+    assert_non_null(entry);
+    assert_int_equal(entry->public_key[63], 1);
+    assert_int_equal(entry->script_hash[0], 1);
+
+    // a corrupted entry is ignored
+    store.entries[0].public_key[10] ^= 0x01;
+    assert_null(pubkey_store_find(&store, path, SEED));
+}
+
+static void test_pubkey_store_round_robin(void **state) {
+    (void) state;
+
+    static pubkey_store_t store;
+    memset(&store, 0, sizeof(store));
+    uint32_t path[BIP44_PATH_LEN];
+
+    for (uint32_t i = 0; i < PUBKEY_STORE_SIZE; i++) {
+        add_key(&store, i);
+    }
+
+    // a corrupted slot is reused before the oldest valid entry
+    store.entries[5].checksum[0] ^= 0xFF;
+    add_key(&store, 100);
+    make_path(path, 100);
+    assert_true(pubkey_store_find(&store, path, SEED) == &store.entries[5]);
+
+    // otherwise the oldest write goes first
+    add_key(&store, 101);
+    make_path(path, 0);
+    assert_null(pubkey_store_find(&store, path, SEED));
+    make_path(path, 101);
+    assert_true(pubkey_store_find(&store, path, SEED) == &store.entries[0]);
+    make_path(path, 1);
+    assert_non_null(pubkey_store_find(&store, path, SEED));
+}
+
+static void test_pubkey_store_other_seed(void **state) {
+    (void) state;
+
+    static pubkey_store_t store;
+    memset(&store, 0, sizeof(store));
+    uint32_t path[BIP44_PATH_LEN];
+
+    // a passphrase PIN unlocks another seed, its keys differ for the same path
+    add_key(&store, 1);
+    make_path(path, 1);
+    assert_null(pubkey_store_find(&store, path, OTHER_SEED));
+    assert_non_null(pubkey_store_find(&store, path, SEED));
+}
+
+static void test_pubkey_store_clear(void **state) {
+    (void) state;
+
+    static pubkey_store_t store;
+    memset(&store, 0, sizeof(store));
+    uint32_t path[BIP44_PATH_LEN];
+
+    add_key(&store, 1);
+    add_key(&store, 2);
+    pubkey_store_clear(&store);
+
+    make_path(path, 1);
+    assert_null(pubkey_store_find(&store, path, SEED));
+    make_path(path, 2);
+    assert_null(pubkey_store_find(&store, path, SEED));
+    for (uint8_t i = 0; i < PUBKEY_STORE_SIZE; i++) {
+        assert_int_equal(store.entries[i].sequence, 0);
+    }
+}
+
+int main() {
+    const struct CMUnitTest tests[] = {cmocka_unit_test(test_pubkey_store_find),
+                                       cmocka_unit_test(test_pubkey_store_round_robin),
+                                       cmocka_unit_test(test_pubkey_store_other_seed),
+                                       cmocka_unit_test(test_pubkey_store_clear)};
+
+    return cmocka_run_group_tests(tests, NULL, NULL);
+}
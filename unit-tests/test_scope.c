@@ -0,0 +1,49 @@
+#include <stdarg.h>
+#include <stddef.h>
+#include <setjmp.h>
+#include <stdint.h>
+#include <string.h>
+
+#include <cmocka.h>
+
+#include "transaction/types.h"
+#include "transaction/scope.h"
+
+static void test_scope_format(void **state) {
+    (void) state;
+
+    char out[MAX_SCOPE_NAME_LEN];
+
+    assert_int_equal(scope_format(NONE, out, sizeof(out)), 4);
+    assert_string_equal(out, "None");
+    assert_int_equal(scope_format(GLOBAL, out, sizeof(out)), 6);
+    assert_string_equal(out, "Global");
+    assert_int_equal(scope_format(CALLED_BY_ENTRY, out, sizeof(out)), 8);
+    assert_string_equal(out, "By Entry");
+    assert_int_equal(scope_format(CUSTOM_CONTRACTS | WITNESS_RULES, out, sizeof(out)), 15);
+    assert_string_equal(out, "Contracts,Rules");
+}
+
+static void test_scope_format_all_flags(void **state) {
+    (void) state;
+
+    // the longest name fills the buffer, the guard byte must not be touched
+    char out[MAX_SCOPE_NAME_LEN + 1];
+    memset(out, 0xAA, sizeof(out));
+
+    uint8_t scope = CALLED_BY_ENTRY | CUSTOM_CONTRACTS | CUSTOM_GROUPS | WITNESS_RULES;
+    assert_int_equal(scope_format(scope, out, MAX_SCOPE_NAME_LEN), 31);
+    assert_string_equal(out, "By Entry,Contracts,Groups,Rules");
+    assert_int_equal((uint8_t) out[MAX_SCOPE_NAME_LEN], 0xAA);
+
+    // a buffer too small is reported instead of overflowed
+    char small[MAX_SCOPE_NAME_LEN - 1];
+    assert_int_equal(scope_format(scope, small, sizeof(small)), -1);
+}
+
+int main() {
+    const struct CMUnitTest tests[] = {cmocka_unit_test(test_scope_format),
+                                       cmocka_unit_test(test_scope_format_all_flags)};
+
+    return cmocka_run_group_tests(tests, NULL, NULL);
+}
@@ -0,0 +1,128 @@
+#include <stdarg.h>
+#include <stddef.h>
+#include <setjmp.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+
+#include <cmocka.h>
+
+#include "transaction/sig_cache.h"
+
+static const uint32_t PATH[BIP44_PATH_LEN] = {BIP44_PURPOSE, BIP44_COIN_TYPE_NEO, 0x80000000, 0, 0};
+static const uint32_t OTHER_PATH[BIP44_PATH_LEN] = {BIP44_PURPOSE, BIP44_COIN_TYPE_NEO, 0x80000001, 0, 3};
+
+static void fill(uint8_t *out, size_t len, uint8_t value) {
+    memset(out, value, len);
+}
+
+static void test_sig_cache_find(void **state) {
+    (void) state;
+
+    sig_cache_t cache = {0};
+    uint8_t hash[TX_HASH_LEN];
+    uint8_t sig[MAX_DER_SIG_LEN];
+
+    fill(hash, sizeof(hash), 0x11);
+    assert_null(sig_cache_find(&cache, PATH, NETWORK_MAINNET, hash));
+
+    fill(sig, sizeof(sig), 0xAA);
+    sig_cache_add(&cache, PATH, NETWORK_MAINNET, hash, sig, 70);
+
+    const sig_cache_entry_t *entry = sig_cache_find(&cache, PATH, NETWORK_MAINNET, hash);
+    assert_non_null(entry);
+    assert_int_equal(entry->signature_len, 70);
+    assert_memory_equal(entry->signature, sig, 70);
+
+    // the signature also covers the network magic
+    assert_null(sig_cache_find(&cache, PATH, NETWORK_TESTNET, hash));
+
+    hash[31] ^= 1;
+    assert_null(sig_cache_find(&cache, PATH, NETWORK_MAINNET, hash));
+}
+
+static void test_sig_cache_replaces_oldest(void **state) {
+    (void) state;
+
+    sig_cache_t cache = {0};
+    uint8_t hash[TX_HASH_LEN];
+    uint8_t sig[MAX_DER_SIG_LEN];
+
+    for (uint8_t i = 0; i <= SIG_CACHE_SIZE; i++) {
+        fill(hash, sizeof(hash), i);
+        fill(sig, sizeof(sig), i);
+        sig_cache_add(&cache, PATH, NETWORK_MAINNET, hash, sig, 70);
+    }
+
+    fill(hash, sizeof(hash), 0);
+    assert_null(sig_cache_find(&cache, PATH, NETWORK_MAINNET, hash));
+
+    for (uint8_t i = 1; i <= SIG_CACHE_SIZE; i++) {
+        fill(hash, sizeof(hash), i);
+        const sig_cache_entry_t *entry = sig_cache_find(&cache, PATH, NETWORK_MAINNET, hash);
+        assert_non_null(entry);
+        assert_int_equal(entry->signature[0], i);
+    }
+}
+
+static void test_sig_cache_most_recent(void **state) {
+    (void) state;
+
+    sig_cache_t cache = {0};
+    uint8_t hash[TX_HASH_LEN];
+    uint8_t other_hash[TX_HASH_LEN];
+    uint8_t sig[MAX_DER_SIG_LEN];
+
+    fill(other_hash, sizeof(other_hash), 0x44);
+    sig_cache_add(&cache, PATH, NETWORK_MAINNET, other_hash, sig, 70);
+
+    // signing the same transaction again replaces its entry instead of evicting another one
+    fill(hash, sizeof(hash), 0x22);
+    for (uint8_t i = 1; i <= SIG_CACHE_SIZE; i++) {
+        fill(sig, sizeof(sig), i);
+        sig_cache_add(&cache, PATH, NETWORK_MAINNET, hash, sig, 69 + i);
+    }
+
+    const sig_cache_entry_t *entry = sig_cache_find(&cache, PATH, NETWORK_MAINNET, hash);
+    assert_non_null(entry);
+    assert_int_equal(entry->signature_len, 69 + SIG_CACHE_SIZE);
+    assert_int_equal(entry->signature[0], SIG_CACHE_SIZE);
+    assert_non_null(sig_cache_find(&cache, PATH, NETWORK_MAINNET, other_hash));
+
+    // invalid lengths are ignored
+    fill(hash, sizeof(hash), 0x33);
+    sig_cache_add(&cache, PATH, NETWORK_MAINNET, hash, sig, 0);
+    sig_cache_add(&cache, PATH, NETWORK_MAINNET, hash, sig, MAX_DER_SIG_LEN + 1);
+    assert_null(sig_cache_find(&cache, PATH, NETWORK_MAINNET, hash));
+}
+
+static void test_sig_cache_paths(void **state) {
+    (void) state;
+
+    sig_cache_t cache = {0};
+    uint8_t hash[TX_HASH_LEN];
+    uint8_t sig[MAX_DER_SIG_LEN];
+
+    // a transaction with several signers on this device has a signature per path
+    fill(hash, sizeof(hash), 0x55);
+    fill(sig, sizeof(sig), 0x01);
+    sig_cache_add(&cache, PATH, NETWORK_MAINNET, hash, sig, 70);
+    fill(sig, sizeof(sig), 0x02);
+    sig_cache_add(&cache, OTHER_PATH, NETWORK_MAINNET, hash, sig, 71);
+
+    const sig_cache_entry_t *entry = sig_cache_find(&cache, PATH, NETWORK_MAINNET, hash);
+    assert_non_null(entry);
+    assert_int_equal(entry->signature[0], 0x01);
+    entry = sig_cache_find(&cache, OTHER_PATH, NETWORK_MAINNET, hash);
+    assert_non_null(entry);
+    assert_int_equal(entry->signature[0], 0x02);
+}
+
+int main() {
+    const struct CMUnitTest tests[] = {cmocka_unit_test(test_sig_cache_find),
+                                       cmocka_unit_test(test_sig_cache_replaces_oldest),
+                                       cmocka_unit_test(test_sig_cache_most_recent),
+                                       cmocka_unit_test(test_sig_cache_paths)};
+
+    return cmocka_run_group_tests(tests, NULL, NULL);
+}
@@ -0,0 +1,668 @@
+#include <stdarg.h>
+#include <stddef.h>
+#include <setjmp.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+
+#include <cmocka.h>
+
+#include "common/buffer.h"
+#include "transaction/types.h"
+#include "transaction/deserialize.h"
+#include "transaction/tx_hash.h"
+
+// try_parse_transfer_script() depends on the SDK, only record that it was called
+static int transfer_script_calls = 0;
+
+void try_parse_transfer_script(buffer_t *script, transaction_t *tx) {
+    (void) script;
+    (void) tx;
+    transfer_script_calls++;
+}
+
+// clang-format off
+static const uint8_t tx_header[] = {
+    0x00,                                            // version
+    0x7b, 0x00, 0x00, 0x00,                          // nonce
+    0xc8, 0x01, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,  // system fee (456)
+    0x15, 0x03, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,  // network fee (789)
+    0x01, 0x00, 0x00, 0x00,                          // valid until block
+    0x02,                                            // signers count
+    0x54, 0xa6, 0x4c, 0xac, 0x1b, 0x10, 0x73, 0xe6, 0x62, 0x93,
+    0x3e, 0xf3, 0xe3, 0x0b, 0x00, 0x7c, 0xd9, 0x8d, 0x67, 0xd7,  // account 1
+    0x01,                                            // scope CALLED_BY_ENTRY
+    0xd7, 0x67, 0x8d, 0xd9, 0x7c, 0x00, 0x0b, 0xe3, 0xf3, 0x3e,
+    0x93, 0x62, 0xe6, 0x73, 0x10, 0x1b, 0xac, 0x4c, 0xa6, 0x54,  // account 2
+    0x30,                                            // scope CUSTOM_CONTRACTS | CUSTOM_GROUPS
+    0x01,                                            // allowed contracts count
+    0xcf, 0x76, 0xe2, 0x8b, 0xd0, 0x06, 0x2c, 0x4a, 0x47, 0x8e,
+    0xe3, 0x55, 0x61, 0x01, 0x13, 0x19, 0xf3, 0xcf, 0xa4, 0xd2,  // allowed contract
+    0x01,                                            // allowed groups count
+    0x02, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08, 0x09, 0x0a,
+    0x0b, 0x0c, 0x0d, 0x0e, 0x0f, 0x10, 0x11, 0x12, 0x13, 0x14, 0x15,
+    0x16, 0x17, 0x18, 0x19, 0x1a, 0x1b, 0x1c, 0x1d, 0x1e, 0x1f, 0x20,  // allowed group
+    0x01,                                            // attributes count
+    0x01,                                            // HIGH_PRIORITY
+};
+// clang-format on
+
+/**
+ * Build a transaction with a script of 'script_len' bytes, returns the serialized length.
+ */
+static size_t build_tx(uint8_t *out, size_t script_len) {
+    size_t len = sizeof(tx_header);
+    memcpy(out, tx_header, len);
+
+    if (script_len < 0xFD) {
+        out[len++] = (uint8_t) script_len;
+    } else {
+        out[len++] = 0xFD;
+        out[len++] = (uint8_t) (script_len & 0xFF);
+        out[len++] = (uint8_t) (script_len >> 8);
+    }
+
+    for (size_t i = 0; i < script_len; i++) {
+        out[len++] = (uint8_t) i;
+    }
+
+    return len;
+}
+
+static void assert_tx_fields(const transaction_t *tx, size_t script_len) {
+    assert_int_equal(tx->version, 0);
+    assert_int_equal(tx->nonce, 123);
+    assert_int_equal(tx->system_fee, 456);
+    assert_int_equal(tx->network_fee, 789);
+    assert_int_equal(tx->valid_until_block, 1);
+    assert_int_equal(tx->signers_size, 2);
+    assert_memory_equal(transaction_signer_account(tx, 0), tx_header + 26, UINT160_LEN);
+    assert_int_equal(tx->signers[0].scope, CALLED_BY_ENTRY);
+    assert_memory_equal(transaction_signer_account(tx, 1), tx_header + 47, UINT160_LEN);
+    assert_int_equal(tx->signers[1].scope, CUSTOM_CONTRACTS | CUSTOM_GROUPS);
+    assert_int_equal(tx->signers[1].allowed_contracts_size, 1);
+    assert_memory_equal(transaction_signer_contract(tx, 1, 0), tx_header + 69, UINT160_LEN);
+    assert_int_equal(tx->signers[1].allowed_groups_size, 1);
+    assert_memory_equal(transaction_signer_group(tx, 1, 0), tx_header + 90, ECPOINT_LEN);
+    assert_int_equal(tx->attributes_size, 1);
+    assert_int_equal(tx->attributes[0].type, HIGH_PRIORITY);
+    assert_int_equal(tx->script_size, script_len);
+}
+
+static void test_tx_deserialize_one_shot(void **state) {
+    (void) state;
+
+    uint8_t raw[256];
+    size_t len = build_tx(raw, 40);
+    buffer_t buf = {.ptr = raw, .size = len, .offset = 0};
+    transaction_t tx;
+
+    transfer_script_calls = 0;
+    assert_int_equal(transaction_deserialize(&buf, &tx), PARSING_OK);
+    assert_tx_fields(&tx, 40);
+    assert_int_equal(transfer_script_calls, 1);
+}
+
+static void test_tx_deserialize_every_split(void **state) {
+    (void) state;
+
+    // script length > 0xFC so the script length varint can be split as well
+    uint8_t raw[512];
+    size_t len = build_tx(raw, 300);
+
+    for (size_t split = 0; split <= len; split++) {
+        tx_parser_t parser;
+        transaction_t tx;
+        transaction_parser_init(&parser, &tx);
+
+        buffer_t first = {.ptr = raw, .size = split, .offset = 0};
+        buffer_t second = {.ptr = raw + split, .size = len - split, .offset = 0};
+        assert_int_equal(transaction_parser_feed(&parser, &tx, &first), PARSING_OK);
+        assert_int_equal(transaction_parser_feed(&parser, &tx, &second), PARSING_OK);
+        assert_int_equal(transaction_parser_finish(&parser), PARSING_OK);
+        assert_int_equal(parser.offset, len);
+        assert_tx_fields(&tx, 300);
+    }
+}
+
+static void test_tx_deserialize_byte_by_byte(void **state) {
+    (void) state;
+
+    uint8_t raw[256];
+    size_t len = build_tx(raw, 60);
+    tx_parser_t parser;
+    transaction_t tx;
+    transaction_parser_init(&parser, &tx);
+
+    transfer_script_calls = 0;
+    for (size_t i = 0; i < len; i++) {
+        buffer_t chunk = {.ptr = raw + i, .size = 1, .offset = 0};
+        assert_int_equal(transaction_parser_feed(&parser, &tx, &chunk), PARSING_OK);
+    }
+    assert_int_equal(transaction_parser_finish(&parser), PARSING_OK);
+    assert_tx_fields(&tx, 60);
+    assert_int_equal(transfer_script_calls, 1);
+}
+
+static void test_tx_deserialize_large_script(void **state) {
+    (void) state;
+
+    // far larger than the 1024 bytes the previous staging buffer allowed
+    static uint8_t raw[sizeof(tx_header) + 3 + 4000];
+    size_t len = build_tx(raw, 4000);
+    tx_parser_t parser;
+    transaction_t tx;
+    transaction_parser_init(&parser, &tx);
+
+    transfer_script_calls = 0;
+    for (size_t offset = 0; offset < len; offset += 250) {
+        size_t n = (len - offset < 250) ? len - offset : 250;
+        buffer_t chunk = {.ptr = raw + offset, .size = n, .offset = 0};
+        assert_int_equal(transaction_parser_feed(&parser, &tx, &chunk), PARSING_OK);
+    }
+    assert_int_equal(transaction_parser_finish(&parser), PARSING_OK);
+    assert_tx_fields(&tx, 4000);
+    // too long to be a NEO or GAS transfer
+    assert_int_equal(transfer_script_calls, 0);
+}
+
+static void test_tx_deserialize_reject_first_bad_chunk(void **state) {
+    (void) state;
+
+    uint8_t raw[256];
+    build_tx(raw, 40);
+    raw[5] = 0xFF;  // make the system fee negative
+    raw[12] = 0xFF;
+
+    tx_parser_t parser;
+    transaction_t tx;
+    transaction_parser_init(&parser, &tx);
+
+    buffer_t chunk = {.ptr = raw, .size = 20, .offset = 0};
+    assert_int_equal(transaction_parser_feed(&parser, &tx, &chunk), SYSTEM_FEE_VALUE_ERROR);
+    // the system fee starts right after version (1) and nonce (4)
+    assert_int_equal(parser.field_offset, 5);
+}
+
+static void test_tx_deserialize_truncated(void **state) {
+    (void) state;
+
+    uint8_t raw[256];
+    size_t len = build_tx(raw, 40);
+    transaction_t tx;
+
+    buffer_t buf = {.ptr = raw, .size = 3, .offset = 0};
+    assert_int_equal(transaction_deserialize(&buf, &tx), NONCE_PARSING_ERROR);
+
+    buf = (buffer_t){.ptr = raw, .size = 30, .offset = 0};
+    assert_int_equal(transaction_deserialize(&buf, &tx), SIGNER_ACCOUNT_PARSING_ERROR);
+
+    buf = (buffer_t){.ptr = raw, .size = 100, .offset = 0};
+    assert_int_equal(transaction_deserialize(&buf, &tx), SIGNER_ALLOWED_CONTRACT_PARSING_ERROR);
+
+    buf = (buffer_t){.ptr = raw, .size = len - 1, .offset = 0};
+    assert_int_equal(transaction_deserialize(&buf, &tx), SCRIPT_LENGTH_VALUE_ERROR);
+}
+
+static void test_tx_deserialize_trailing_data(void **state) {
+    (void) state;
+
+    uint8_t raw[256];
+    size_t len = build_tx(raw, 40);
+    transaction_t tx;
+
+    buffer_t buf = {.ptr = raw, .size = len + 1, .offset = 0};
+    assert_int_equal(transaction_deserialize(&buf, &tx), INVALID_LENGTH_ERROR);
+}
+
+static void test_tx_deserialize_duplicate_signer(void **state) {
+    (void) state;
+
+    uint8_t raw[256];
+    size_t len = build_tx(raw, 40);
+    memcpy(raw + 47, tx_header + 26, UINT160_LEN);
+    transaction_t tx;
+
+    buffer_t buf = {.ptr = raw, .size = len, .offset = 0};
+    assert_int_equal(transaction_deserialize(&buf, &tx), SIGNER_ACCOUNT_DUPLICATE_ERROR);
+}
+
+/**
+ * Build a transaction with 'signers_count' CALLED_BY_ENTRY signers, the first one also allows 'contracts_count'
+ * contracts. All accounts start with the same byte. Returns the serialized length.
+ */
+static size_t build_signers_tx(uint8_t *out, uint8_t signers_count, uint8_t contracts_count) {
+    size_t len = 25;  // version, nonce, fees and valid until block of tx_header
+    memcpy(out, tx_header, len);
+
+    out[len++] = signers_count;
+    for (uint8_t i = 0; i < signers_count; i++) {
+        memset(out + len, 0x54, UINT160_LEN);
+        out[len + UINT160_LEN - 1] = i;
+        len += UINT160_LEN;
+        if (i == 0 && contracts_count > 0) {
+            out[len++] = CALLED_BY_ENTRY | CUSTOM_CONTRACTS;
+            out[len++] = contracts_count;
+            for (uint8_t c = 0; c < contracts_count; c++) {
+                memset(out + len, c, UINT160_LEN);
+                len += UINT160_LEN;
+            }
+        } else {
+            out[len++] = CALLED_BY_ENTRY;
+        }
+    }
+
+    out[len++] = 0x00;  // attributes count
+    out[len++] = 0x01;  // script length
+    out[len++] = 0x40;  // RET
+
+    return len;
+}
+
+static void test_tx_deserialize_max_signers(void **state) {
+    (void) state;
+
+    uint8_t raw[512];
+    size_t len = build_signers_tx(raw, MAX_TX_SIGNERS, 0);
+    transaction_t tx;
+
+    buffer_t buf = {.ptr = raw, .size = len, .offset = 0};
+    assert_int_equal(transaction_deserialize(&buf, &tx), PARSING_OK);
+    assert_int_equal(tx.signers_size, MAX_TX_SIGNERS);
+    for (uint8_t i = 0; i < MAX_TX_SIGNERS; i++) {
+        assert_memory_equal(transaction_signer_account(&tx, i), raw + 26 + i * (UINT160_LEN + 1), UINT160_LEN);
+    }
+
+    // same first byte and last byte as the first account
+    len = build_signers_tx(raw, MAX_TX_SIGNERS, 0);
+    raw[26 + 15 * (UINT160_LEN + 1) + UINT160_LEN - 1] = 0x00;
+    buf = (buffer_t){.ptr = raw, .size = len, .offset = 0};
+    assert_int_equal(transaction_deserialize(&buf, &tx), SIGNER_ACCOUNT_DUPLICATE_ERROR);
+
+    len = build_signers_tx(raw, MAX_TX_SIGNERS + 1, 0);
+    buf = (buffer_t){.ptr = raw, .size = len, .offset = 0};
+    assert_int_equal(transaction_deserialize(&buf, &tx), SIGNER_LENGTH_VALUE_ERROR);
+}
+
+static void test_tx_deserialize_signers_data_full(void **state) {
+    (void) state;
+
+    // the contracts of the first signer may use the room left by the accounts
+    uint8_t raw[512];
+    size_t len = build_signers_tx(raw, 2, 14);
+    transaction_t tx;
+
+    buffer_t buf = {.ptr = raw, .size = len, .offset = 0};
+    assert_int_equal(transaction_deserialize(&buf, &tx), PARSING_OK);
+    assert_int_equal(tx.signers_data_len, MAX_SIGNERS_DATA_LEN);
+    assert_memory_equal(transaction_signer_contract(&tx, 0, 13), raw + 48 + 13 * UINT160_LEN, UINT160_LEN);
+    assert_memory_equal(transaction_signer_account(&tx, 1), raw + 48 + 14 * UINT160_LEN, UINT160_LEN);
+
+    // but not the room needed for the account of the second signer
+    len = build_signers_tx(raw, 2, 15);
+    buf = (buffer_t){.ptr = raw, .size = len, .offset = 0};
+    assert_int_equal(transaction_deserialize(&buf, &tx), SIGNER_ALLOWED_CONTRACTS_LENGTH_VALUE_ERROR);
+}
+
+// clang-format off
+static const uint8_t tx_rules[] = {
+    0x00,                                            // version
+    0x7b, 0x00, 0x00, 0x00,                          // nonce
+    0xc8, 0x01, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,  // system fee (456)
+    0x15, 0x03, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,  // network fee (789)
+    0x01, 0x00, 0x00, 0x00,                          // valid until block
+    0x01,                                            // signers count
+    0x54, 0xa6, 0x4c, 0xac, 0x1b, 0x10, 0x73, 0xe6, 0x62, 0x93,
+    0x3e, 0xf3, 0xe3, 0x0b, 0x00, 0x7c, 0xd9, 0x8d, 0x67, 0xd7,  // account
+    0x41,                                            // scope CALLED_BY_ENTRY | WITNESS_RULES
+    0x02,                                            // rules count
+    0x01,                                            // Allow
+    0x02, 0x02,                                      // And of 2
+    0x20,                                            //   CalledByEntry
+    0x03, 0x02,                                      //   Or of 2
+    0x28,                                            //     CalledByContract
+    0xcf, 0x76, 0xe2, 0x8b, 0xd0, 0x06, 0x2c, 0x4a, 0x47, 0x8e,
+    0xe3, 0x55, 0x61, 0x01, 0x13, 0x19, 0xf3, 0xcf, 0xa4, 0xd2,
+    0x19,                                            //     Group
+    0x02, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08, 0x09, 0x0a,
+    0x0b, 0x0c, 0x0d, 0x0e, 0x0f, 0x10, 0x11, 0x12, 0x13, 0x14, 0x15,
+    0x16, 0x17, 0x18, 0x19, 0x1a, 0x1b, 0x1c, 0x1d, 0x1e, 0x1f, 0x20,
+    0x00,                                            // Deny
+    0x01,                                            // Not
+    0x00, 0x00,                                      //   Boolean false
+    0x00,                                            // attributes count
+    0x01, 0x40,                                      // script
+};
+// clang-format on
+
+static void assert_tx_rules(const transaction_t *tx) {
+    uint8_t rule;
+    const uint8_t *item;
+
+    assert_int_equal(tx->signers[0].scope, CALLED_BY_ENTRY | WITNESS_RULES);
+    assert_int_equal(tx->signers[0].rules_size, 2);
+    assert_int_equal(tx->signers[0].rule_items_size, 9);
+
+    item = transaction_signer_rule_item(tx, 0, 0, &rule);
+    assert_int_equal(rule, 0);
+    assert_int_equal(item[0], WITNESS_RULE_ALLOW);
+
+    item = transaction_signer_rule_item(tx, 0, 1, &rule);
+    assert_int_equal(WITNESS_RULE_ITEM_LEVEL(item[0]), 1);
+    assert_int_equal(WITNESS_RULE_ITEM_TYPE(item[0]), CONDITION_AND);
+    assert_int_equal(item[1], 2);
+
+    item = transaction_signer_rule_item(tx, 0, 2, &rule);
+    assert_int_equal(WITNESS_RULE_ITEM_LEVEL(item[0]), 2);
+    assert_int_equal(WITNESS_RULE_ITEM_TYPE(item[0]), CONDITION_CALLED_BY_ENTRY);
+
+    item = transaction_signer_rule_item(tx, 0, 4, &rule);
+    assert_int_equal(WITNESS_RULE_ITEM_LEVEL(item[0]), 3);
+    assert_int_equal(WITNESS_RULE_ITEM_TYPE(item[0]), CONDITION_CALLED_BY_CONTRACT);
+    assert_memory_equal(item + 1, tx_rules + 55, UINT160_LEN);
+
+    item = transaction_signer_rule_item(tx, 0, 5, &rule);
+    assert_int_equal(rule, 0);
+    assert_int_equal(WITNESS_RULE_ITEM_TYPE(item[0]), CONDITION_GROUP);
+    assert_memory_equal(item + 1, tx_rules + 76, ECPOINT_LEN);
+
+    item = transaction_signer_rule_item(tx, 0, 6, &rule);
+    assert_int_equal(rule, 1);
+    assert_int_equal(item[0], WITNESS_RULE_DENY);
+
+    item = transaction_signer_rule_item(tx, 0, 8, &rule);
+    assert_int_equal(rule, 1);
+    assert_int_equal(WITNESS_RULE_ITEM_LEVEL(item[0]), 2);
+    assert_int_equal(WITNESS_RULE_ITEM_TYPE(item[0]), CONDITION_BOOLEAN);
+    assert_int_equal(item[1], 0);
+}
+
+static void test_tx_deserialize_witness_rules(void **state) {
+    (void) state;
+
+    for (size_t split = 0; split <= sizeof(tx_rules); split++) {
+        tx_parser_t parser;
+        transaction_t tx;
+        transaction_parser_init(&parser, &tx);
+
+        buffer_t first = {.ptr = tx_rules, .size = split, .offset = 0};
+        buffer_t second = {.ptr = tx_rules + split, .size = sizeof(tx_rules) - split, .offset = 0};
+        assert_int_equal(transaction_parser_feed(&parser, &tx, &first), PARSING_OK);
+        assert_int_equal(transaction_parser_feed(&parser, &tx, &second), PARSING_OK);
+        assert_int_equal(transaction_parser_finish(&parser), PARSING_OK);
+        assert_tx_rules(&tx);
+    }
+}
+
+static void test_tx_deserialize_witness_rules_invalid(void **state) {
+    (void) state;
+
+    uint8_t raw[sizeof(tx_rules)];
+    transaction_t tx;
+    buffer_t buf;
+
+    // Or of 2 at level 2 is replaced by Not, whose sub-condition would nest 3 deep
+    memcpy(raw, tx_rules, sizeof(raw));
+    raw[52] = CONDITION_NOT;
+    raw[53] = CONDITION_AND;
+    buf = (buffer_t){.ptr = raw, .size = sizeof(raw), .offset = 0};
+    assert_int_equal(transaction_deserialize(&buf, &tx), SIGNER_RULE_VALUE_ERROR);
+
+    // unknown action
+    memcpy(raw, tx_rules, sizeof(raw));
+    raw[48] = 0x02;
+    buf = (buffer_t){.ptr = raw, .size = sizeof(raw), .offset = 0};
+    assert_int_equal(transaction_deserialize(&buf, &tx), SIGNER_RULE_VALUE_ERROR);
+
+    // boolean other than 0 or 1
+    memcpy(raw, tx_rules, sizeof(raw));
+    raw[sizeof(raw) - 4] = 0x02;
+    buf = (buffer_t){.ptr = raw, .size = sizeof(raw), .offset = 0};
+    assert_int_equal(transaction_deserialize(&buf, &tx), SIGNER_RULE_VALUE_ERROR);
+
+    // empty And
+    memcpy(raw, tx_rules, sizeof(raw));
+    raw[50] = 0x00;
+    buf = (buffer_t){.ptr = raw, .size = sizeof(raw), .offset = 0};
+    assert_int_equal(transaction_deserialize(&buf, &tx), SIGNER_RULE_VALUE_ERROR);
+
+    // ends in the middle of the second rule
+    buf = (buffer_t){.ptr = tx_rules, .size = sizeof(tx_rules) - 6, .offset = 0};
+    assert_int_equal(transaction_deserialize(&buf, &tx), SIGNER_RULE_PARSING_ERROR);
+}
+
+/**
+ * Build a transaction with a single signer and the attributes in 'attributes', returns the serialized length.
+ */
+static size_t build_attributes_tx(uint8_t *out, const uint8_t *attributes, size_t attributes_len, uint8_t count) {
+    size_t len = 25;  // version, nonce, fees and valid until block of tx_header
+    memcpy(out, tx_header, len);
+
+    out[len++] = 0x01;  // signers count
+    memcpy(out + len, tx_header + 26, UINT160_LEN + 1);
+    len += UINT160_LEN + 1;
+
+    out[len++] = count;
+    memcpy(out + len, attributes, attributes_len);
+    len += attributes_len;
+
+    out[len++] = 0x01;  // script length
+    out[len++] = 0x40;  // RET
+
+    return len;
+}
+
+// clang-format off
+static const uint8_t all_attributes[] = {
+    0x01,                                            // HighPriority
+    0x20, 0xd2, 0x04, 0x00, 0x00,                    // NotValidBefore 1234
+    0x21, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11,
+    0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11,  // Conflicts
+    0x22, 0x03,                                      // NotaryAssisted 3 keys
+    0x21, 0x22, 0x22, 0x22, 0x22, 0x22, 0x22, 0x22, 0x22, 0x22, 0x22, 0x22, 0x22, 0x22, 0x22, 0x22, 0x22,
+    0x22, 0x22, 0x22, 0x22, 0x22, 0x22, 0x22, 0x22, 0x22, 0x22, 0x22, 0x22, 0x22, 0x22, 0x22, 0x22,  // Conflicts
+    0x11, 0x07, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,  // OracleResponse id 7
+    0x00,                                                  //   code Success
+    0x03, 0x61, 0x62, 0x63,                                //   result
+};
+// clang-format on
+
+static void test_tx_deserialize_attributes(void **state) {
+    (void) state;
+
+    uint8_t raw[256];
+    size_t len = build_attributes_tx(raw, all_attributes, sizeof(all_attributes), 6);
+
+    for (size_t split = 0; split <= len; split++) {
+        tx_parser_t parser;
+        transaction_t tx;
+        transaction_parser_init(&parser, &tx);
+
+        buffer_t first = {.ptr = raw, .size = split, .offset = 0};
+        buffer_t second = {.ptr = raw + split, .size = len - split, .offset = 0};
+        assert_int_equal(transaction_parser_feed(&parser, &tx, &first), PARSING_OK);
+        assert_int_equal(transaction_parser_feed(&parser, &tx, &second), PARSING_OK);
+        assert_int_equal(transaction_parser_finish(&parser), PARSING_OK);
+
+        assert_int_equal(tx.attributes_size, 6);
+        assert_int_equal(tx.attributes[0].type, HIGH_PRIORITY);
+        assert_int_equal(tx.attributes[1].type, NOT_VALID_BEFORE);
+        assert_memory_equal(tx.attributes_data + tx.attributes[1].offset, all_attributes + 2, 4);
+        assert_int_equal(tx.attributes[2].type, CONFLICTS);
+        assert_memory_equal(tx.attributes_data + tx.attributes[2].offset, all_attributes + 7, UINT256_LEN);
+        assert_int_equal(tx.attributes[3].type, NOTARY_ASSISTED);
+        assert_int_equal(tx.attributes_data[tx.attributes[3].offset], 3);
+        assert_int_equal(tx.attributes[4].type, CONFLICTS);
+        assert_memory_equal(tx.attributes_data + tx.attributes[4].offset, all_attributes + 42, UINT256_LEN);
+
+        // id || code || result length || offset of the result in the transaction
+        const uint8_t *oracle = tx.attributes_data + tx.attributes[5].offset;
+        assert_int_equal(tx.attributes[5].type, ORACLE_RESPONSE);
+        assert_memory_equal(oracle, all_attributes + 75, 9);
+        assert_int_equal(oracle[9] | oracle[10] << 8, 3);
+        assert_int_equal(oracle[11] | oracle[12] << 8 | oracle[13] << 16 | oracle[14] << 24, len - 5);
+    }
+}
+
+static void test_tx_deserialize_attributes_invalid(void **state) {
+    (void) state;
+
+    uint8_t raw[512];
+    uint8_t attributes[6 * (1 + UINT256_LEN)];
+    transaction_t tx;
+    buffer_t buf;
+    size_t len;
+
+    // only Conflicts may be attached more than once
+    const uint8_t not_valid_before_twice[] = {0x20, 0x01, 0x00, 0x00, 0x00, 0x20, 0x02, 0x00, 0x00, 0x00};
+    len = build_attributes_tx(raw, not_valid_before_twice, sizeof(not_valid_before_twice), 2);
+    buf = (buffer_t){.ptr = raw, .size = len, .offset = 0};
+    assert_int_equal(transaction_deserialize(&buf, &tx), ATTRIBUTES_DUPLICATE_TYPE);
+
+    // up to MAX_CONFLICTS Conflicts
+    for (uint8_t i = 0; i <= MAX_CONFLICTS; i++) {
+        attributes[i * (1 + UINT256_LEN)] = CONFLICTS;
+        memset(attributes + i * (1 + UINT256_LEN) + 1, i, UINT256_LEN);
+    }
+    len = build_attributes_tx(raw, attributes, MAX_CONFLICTS * (1 + UINT256_LEN), MAX_CONFLICTS);
+    buf = (buffer_t){.ptr = raw, .size = len, .offset = 0};
+    assert_int_equal(transaction_deserialize(&buf, &tx), PARSING_OK);
+    len = build_attributes_tx(raw, attributes, (MAX_CONFLICTS + 1) * (1 + UINT256_LEN), MAX_CONFLICTS + 1);
+    buf = (buffer_t){.ptr = raw, .size = len, .offset = 0};
+    assert_int_equal(transaction_deserialize(&buf, &tx), ATTRIBUTES_LENGTH_VALUE_ERROR);
+
+    // signers and attributes together are limited to MAX_ATTRIBUTES
+    memset(attributes, HIGH_PRIORITY, MAX_ATTRIBUTES);
+    len = build_attributes_tx(raw, attributes, MAX_ATTRIBUTES, MAX_ATTRIBUTES);
+    buf = (buffer_t){.ptr = raw, .size = len, .offset = 0};
+    assert_int_equal(transaction_deserialize(&buf, &tx), ATTRIBUTES_LENGTH_VALUE_ERROR);
+
+    // unknown oracle response code
+    const uint8_t oracle_bad_code[] = {0x11, 0x07, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x01, 0x00};
+    len = build_attributes_tx(raw, oracle_bad_code, sizeof(oracle_bad_code), 1);
+    buf = (buffer_t){.ptr = raw, .size = len, .offset = 0};
+    assert_int_equal(transaction_deserialize(&buf, &tx), ATTRIBUTE_DATA_VALUE_ERROR);
+
+    // only a successful oracle response has a result
+    const uint8_t oracle_failure[] = {0x11, 0x07, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x16, 0x01, 0x61};
+    len = build_attributes_tx(raw, oracle_failure, sizeof(oracle_failure), 1);
+    buf = (buffer_t){.ptr = raw, .size = len, .offset = 0};
+    assert_int_equal(transaction_deserialize(&buf, &tx), ATTRIBUTE_DATA_VALUE_ERROR);
+
+    // ends in the middle of a Conflicts hash
+    len = build_attributes_tx(raw, all_attributes + 6, 1 + 10, 1);
+    buf = (buffer_t){.ptr = raw, .size = len - 2, .offset = 0};
+    assert_int_equal(transaction_deserialize(&buf, &tx), ATTRIBUTE_DATA_PARSING_ERROR);
+}
+
+static void test_tx_deserialize_truncated_every_field(void **state) {
+    (void) state;
+
+    uint8_t raw[256];
+    size_t len = build_attributes_tx(raw, all_attributes, sizeof(all_attributes), 6);
+    transaction_t tx;
+
+    // every step of the layout table reports a status of its own when the transaction ends there
+    for (size_t size = 0; size < sizeof(tx_rules); size++) {
+        buffer_t buf = {.ptr = tx_rules, .size = size, .offset = 0};
+        parser_status_e status = transaction_deserialize(&buf, &tx);
+        assert_true(status < 0 && status != INVALID_LENGTH_ERROR);
+    }
+    for (size_t size = 0; size < len; size++) {
+        buffer_t buf = {.ptr = raw, .size = size, .offset = 0};
+        parser_status_e status = transaction_deserialize(&buf, &tx);
+        assert_true(status < 0 && status != INVALID_LENGTH_ERROR);
+    }
+
+    buffer_t buf = {.ptr = raw, .size = 0, .offset = 0};
+    assert_int_equal(transaction_deserialize(&buf, &tx), VERSION_PARSING_ERROR);
+    buf = (buffer_t){.ptr = raw, .size = len - 1, .offset = 0};
+    assert_int_equal(transaction_deserialize(&buf, &tx), SCRIPT_LENGTH_VALUE_ERROR);
+}
+
+static void test_tx_deserialize_field_offset_split(void **state) {
+    (void) state;
+
+    uint8_t raw[256];
+    size_t len = build_tx(raw, 40);
+    memcpy(raw + 47, tx_header + 26, UINT160_LEN);
+
+    // the duplicate account straddles the two chunks, the offset still points at its first byte
+    tx_parser_t parser;
+    transaction_t tx;
+    transaction_parser_init(&parser, &tx);
+
+    buffer_t first = {.ptr = raw, .size = 50, .offset = 0};
+    buffer_t second = {.ptr = raw + 50, .size = len - 50, .offset = 0};
+    assert_int_equal(transaction_parser_feed(&parser, &tx, &first), PARSING_OK);
+    assert_int_equal(transaction_parser_feed(&parser, &tx, &second), SIGNER_ACCOUNT_DUPLICATE_ERROR);
+    assert_int_equal(parser.field_offset, 47);
+}
+
+static void test_tx_deserialize_large_script_mode(void **state) {
+    (void) state;
+
+    // larger than both the 0xFFFF script length and MAX_TRANSACTION_LEN limits
+    const uint32_t script_len = 200000;
+    uint8_t prefix[sizeof(tx_header) + 5];
+    memcpy(prefix, tx_header, sizeof(tx_header));
+    prefix[sizeof(tx_header)] = 0xFE;
+    prefix[sizeof(tx_header) + 1] = (uint8_t) (script_len & 0xFF);
+    prefix[sizeof(tx_header) + 2] = (uint8_t) ((script_len >> 8) & 0xFF);
+    prefix[sizeof(tx_header) + 3] = (uint8_t) ((script_len >> 16) & 0xFF);
+    prefix[sizeof(tx_header) + 4] = (uint8_t) (script_len >> 24);
+
+    tx_parser_t parser;
+    transaction_t tx;
+
+    // rejected unless large scripts are explicitly allowed
+    transaction_parser_init(&parser, &tx);
+    buffer_t chunk = {.ptr = prefix, .size = sizeof(prefix), .offset = 0};
+    assert_int_equal(transaction_parser_feed(&parser, &tx, &chunk), SCRIPT_LENGTH_VALUE_ERROR);
+
+    transaction_parser_init(&parser, &tx);
+    transaction_parser_allow_large_script(&parser);
+    chunk = (buffer_t){.ptr = prefix, .size = sizeof(prefix), .offset = 0};
+    assert_int_equal(transaction_parser_feed(&parser, &tx, &chunk), PARSING_OK);
+
+    cx_sha256_t expected_ctx;
+    transaction_hash_init(&expected_ctx);
+
+    uint8_t part[250];
+    for (uint32_t offset = 0; offset < script_len; offset += sizeof(part)) {
+        for (size_t i = 0; i < sizeof(part); i++) {
+            part[i] = (uint8_t) (offset + i);
+        }
+        chunk = (buffer_t){.ptr = part, .size = sizeof(part), .offset = 0};
+        transaction_hash_update(&expected_ctx, &chunk);
+        assert_int_equal(transaction_parser_feed(&parser, &tx, &chunk), PARSING_OK);
+    }
+    assert_int_equal(transaction_parser_finish(&parser), PARSING_OK);
+
+    uint8_t expected[SCRIPT_DIGEST_LEN];
+    transaction_hash_final(&expected_ctx, expected);
+    assert_int_equal(tx.script_size, script_len);
+    assert_memory_equal(tx.script_hash, expected, SCRIPT_DIGEST_LEN);
+}
+
+int main() {
+    const struct CMUnitTest tests[] = {cmocka_unit_test(test_tx_deserialize_one_shot),
+                                       cmocka_unit_test(test_tx_deserialize_every_split),
+                                       cmocka_unit_test(test_tx_deserialize_byte_by_byte),
+                                       cmocka_unit_test(test_tx_deserialize_large_script),
+                                       cmocka_unit_test(test_tx_deserialize_reject_first_bad_chunk),
+                                       cmocka_unit_test(test_tx_deserialize_truncated),
+                                       cmocka_unit_test(test_tx_deserialize_trailing_data),
+                                       cmocka_unit_test(test_tx_deserialize_duplicate_signer),
+                                       cmocka_unit_test(test_tx_deserialize_max_signers),
+                                       cmocka_unit_test(test_tx_deserialize_signers_data_full),
+                                       cmocka_unit_test(test_tx_deserialize_witness_rules),
+                                       cmocka_unit_test(test_tx_deserialize_witness_rules_invalid),
+                                       cmocka_unit_test(test_tx_deserialize_attributes),
+                                       cmocka_unit_test(test_tx_deserialize_attributes_invalid),
+                                       cmocka_unit_test(test_tx_deserialize_truncated_every_field),
+                                       cmocka_unit_test(test_tx_deserialize_field_offset_split),
+                                       cmocka_unit_test(test_tx_deserialize_large_script_mode)};
+
+    return cmocka_run_group_tests(tests, NULL, NULL);
+}
@@ -0,0 +1,121 @@
+#include <stdarg.h>
+#include <stddef.h>
+#include <setjmp.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+
+#include <cmocka.h>
+
+#include "cx.h"
+#include "common/buffer.h"
+#include "transaction/tx_hash.h"
+
+/**
+ * One-shot hash of the whole transaction, as computed before transactions were hashed chunk by chunk.
+ */
+static void one_shot_hash(const uint8_t *data, size_t len, uint8_t out[static TX_HASH_LEN]) {
+    cx_sha256_t hash;
+    cx_sha256_init(&hash);
+    cx_hash((cx_hash_t *) &hash, CX_LAST, data, len, out, TX_HASH_LEN);
+}
+
+static void test_tx_hash_known_digest(void **state) {
+    (void) state;
+
+    uint8_t data[300];
+    for (size_t i = 0; i < sizeof(data); i++) {
+        data[i] = (uint8_t) i;
+    }
+
+    // clang-format off
+    const uint8_t expected[TX_HASH_LEN] = {
+        0x77, 0x28, 0xae, 0x2f, 0x2c, 0x36, 0xe2, 0xaa, 0xaf, 0xbe, 0x79, 0xca, 0x14, 0xc8, 0x7a, 0xe2,
+        0xf8, 0x9e, 0x7c, 0x88, 0xc4, 0x39, 0x0e, 0xcb, 0xbf, 0x82, 0xdc, 0xe8, 0x87, 0x06, 0x95, 0x8d
+    };
+    // clang-format on
+
+    uint8_t digest[TX_HASH_LEN] = {0};
+    one_shot_hash(data, sizeof(data), digest);
+    assert_memory_equal(digest, expected, TX_HASH_LEN);
+
+    cx_sha256_t hash;
+    transaction_hash_init(&hash);
+    buffer_t buf = {.ptr = data, .size = sizeof(data), .offset = 0};
+    transaction_hash_update(&hash, &buf);
+    transaction_hash_final(&hash, digest);
+    assert_memory_equal(digest, expected, TX_HASH_LEN);
+}
+
+static void test_tx_hash_every_split(void **state) {
+    (void) state;
+
+    uint8_t data[300];
+    for (size_t i = 0; i < sizeof(data); i++) {
+        data[i] = (uint8_t) (i * 7 + 3);
+    }
+
+    uint8_t expected[TX_HASH_LEN] = {0};
+    one_shot_hash(data, sizeof(data), expected);
+
+    // two chunks, split at every possible position
+    for (size_t split = 0; split <= sizeof(data); split++) {
+        cx_sha256_t hash;
+        uint8_t digest[TX_HASH_LEN] = {0};
+
+        transaction_hash_init(&hash);
+        buffer_t first = {.ptr = data, .size = split, .offset = 0};
+        buffer_t second = {.ptr = data + split, .size = sizeof(data) - split, .offset = 0};
+        transaction_hash_update(&hash, &first);
+        transaction_hash_update(&hash, &second);
+        transaction_hash_final(&hash, digest);
+
+        assert_memory_equal(digest, expected, TX_HASH_LEN);
+    }
+
+    // every chunk size an APDU can carry
+    for (size_t chunk_len = 1; chunk_len <= 255; chunk_len++) {
+        cx_sha256_t hash;
+        uint8_t digest[TX_HASH_LEN] = {0};
+
+        transaction_hash_init(&hash);
+        for (size_t offset = 0; offset < sizeof(data); offset += chunk_len) {
+            size_t n = (sizeof(data) - offset < chunk_len) ? sizeof(data) - offset : chunk_len;
+            buffer_t chunk = {.ptr = data + offset, .size = n, .offset = 0};
+            transaction_hash_update(&hash, &chunk);
+        }
+        transaction_hash_final(&hash, digest);
+
+        assert_memory_equal(digest, expected, TX_HASH_LEN);
+    }
+}
+
+static void test_tx_hash_skips_consumed_bytes(void **state) {
+    (void) state;
+
+    uint8_t data[64];
+    for (size_t i = 0; i < sizeof(data); i++) {
+        data[i] = (uint8_t) i;
+    }
+
+    uint8_t expected[TX_HASH_LEN] = {0};
+    one_shot_hash(data + 10, sizeof(data) - 10, expected);
+
+    cx_sha256_t hash;
+    uint8_t digest[TX_HASH_LEN] = {0};
+    transaction_hash_init(&hash);
+    buffer_t buf = {.ptr = data, .size = sizeof(data), .offset = 10};
+    transaction_hash_update(&hash, &buf);
+    transaction_hash_final(&hash, digest);
+
+    assert_memory_equal(digest, expected, TX_HASH_LEN);
+    assert_int_equal(buf.offset, 10);
+}
+
+int main() {
+    const struct CMUnitTest tests[] = {cmocka_unit_test(test_tx_hash_known_digest),
+                                       cmocka_unit_test(test_tx_hash_every_split),
+                                       cmocka_unit_test(test_tx_hash_skips_consumed_bytes)};
+
+    return cmocka_run_group_tests(tests, NULL, NULL);
+}